@@ -0,0 +1,40 @@
+#pragma once
+
+// 微基准公共小工具：计时与分位数统计（不依赖第三方基准框架）。
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <vector>
+
+namespace wxz::bench {
+
+inline std::uint64_t now_ns() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+// 对样本排序后取分位数（q ∈ [0, 1]）；样本为空时返回 0。
+inline std::uint64_t percentile(std::vector<std::uint64_t>& samples, double q) {
+    if (samples.empty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    const auto idx = static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1));
+    return samples[idx];
+}
+
+inline void print_latency(const char* label, std::vector<std::uint64_t>& ns) {
+    std::printf("%-32s n=%zu p50=%.2fus p99=%.2fus max=%.2fus\n", label, ns.size(), percentile(ns, 0.50) / 1e3,
+                percentile(ns, 0.99) / 1e3, percentile(ns, 1.0) / 1e3);
+}
+
+// 进程累计 CPU 时间（所有线程的用户态 + 内核态，ns），用于统计空闲 CPU 占用。
+inline std::uint64_t process_cpu_ns() {
+    struct timespec ts {};
+    ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+} // namespace wxz::bench
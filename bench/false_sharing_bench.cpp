@@ -0,0 +1,77 @@
+// 多写端吞吐：对比缓存行隔离（IndexQueue 游标/cell、通道计数器分片）前后的差异。
+// - index_queue：P 个生产者与 P 个消费者并发 enqueue/dequeue 同一个 IndexQueue；
+// - inproc_publish：P 个线程并发向同一个 InprocChannel publish（keep_last，带一个订阅），统计发布吞吐。
+// 只使用两版都有的公共 API，同一份源码可以编译到改动前的版本上做对比。
+//
+// 用法：false_sharing_bench [threads=4] [ops_per_thread=1000000]
+
+#include "bench_util.h"
+#include "inproc_channel.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using wxz::core::IndexQueue;
+using wxz::core::InprocChannel;
+
+namespace {
+
+double run_index_queue(std::size_t threads, std::size_t ops) {
+    IndexQueue q(1024);
+    std::atomic<bool> go{false};
+    std::vector<std::thread> ts;
+    for (std::size_t t = 0; t < threads; ++t) {
+        ts.emplace_back([&, t]() {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (std::size_t i = 0; i < ops; ++i) {
+                while (!q.enqueue(t)) std::this_thread::yield();
+            }
+        });
+        ts.emplace_back([&]() {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            std::size_t v = 0;
+            for (std::size_t i = 0; i < ops; ++i) {
+                while (!q.dequeue(v)) std::this_thread::yield();
+            }
+        });
+    }
+    const std::uint64_t start = wxz::bench::now_ns();
+    go.store(true, std::memory_order_release);
+    for (auto& th : ts) th.join();
+    const double secs = static_cast<double>(wxz::bench::now_ns() - start) / 1e9;
+    return static_cast<double>(threads * ops) / secs;
+}
+
+double run_inproc_publish(std::size_t threads, std::size_t ops) {
+    wxz::core::ChannelQoS qos;
+    qos.history = 64;
+    InprocChannel ch(256, 64, qos);
+    ch.subscribe([](const std::uint8_t*, std::size_t) {});
+    std::atomic<bool> go{false};
+    std::vector<std::thread> ts;
+    for (std::size_t t = 0; t < threads; ++t) {
+        ts.emplace_back([&]() {
+            std::uint8_t payload[32] = {};
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (std::size_t i = 0; i < ops; ++i) (void)ch.publish(payload, sizeof(payload));
+        });
+    }
+    const std::uint64_t start = wxz::bench::now_ns();
+    go.store(true, std::memory_order_release);
+    for (auto& th : ts) th.join();
+    const double secs = static_cast<double>(wxz::bench::now_ns() - start) / 1e9;
+    ch.stop();
+    return static_cast<double>(threads * ops) / secs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4;
+    const std::size_t ops = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    std::printf("index_queue    %zu+%zu threads: %.2f Mops/s\n", threads, threads, run_index_queue(threads, ops) / 1e6);
+    std::printf("inproc_publish %zu threads:   %.2f Mmsg/s\n", threads, run_inproc_publish(threads, ops) / 1e6);
+    return 0;
+}
@@ -0,0 +1,88 @@
+// InprocChannel 默认分发线程的等待方式：
+// - 空闲开销：N 个带订阅的空闲 channel 静置一段时间，统计进程 CPU 占用与分发线程的主动上下文切换（≈ 唤醒次数）；
+// - 唤醒延迟：写端每隔 interval 发一条带发送时间戳的消息（分发线程大多处于 park），handler 计算单向延迟。
+//
+// 用法：inproc_wait_bench [channels=60] [idle_ms=2000] [latency_msgs=20000]
+
+#include "bench_util.h"
+#include "inproc_channel.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+using wxz::core::InprocChannel;
+
+namespace {
+
+// 本进程所有线程的主动上下文切换次数之和（/proc/self/task/*/status 的 voluntary_ctxt_switches）。
+std::uint64_t voluntary_switches() {
+    std::uint64_t total = 0;
+    DIR* dir = ::opendir("/proc/self/task");
+    if (!dir) return 0;
+    while (auto* e = ::readdir(dir)) {
+        if (e->d_name[0] == '.') continue;
+        std::ifstream in(std::string("/proc/self/task/") + e->d_name + "/status");
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.rfind("voluntary_ctxt_switches:", 0) == 0) {
+                total += std::strtoull(line.c_str() + std::strlen("voluntary_ctxt_switches:"), nullptr, 10);
+            }
+        }
+    }
+    ::closedir(dir);
+    return total;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t channels = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 60;
+    const std::uint64_t idle_ms = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+    const std::size_t latency_msgs = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20000;
+
+    {
+        std::vector<std::unique_ptr<InprocChannel>> idle;
+        for (std::size_t i = 0; i < channels; ++i) {
+            idle.push_back(std::make_unique<InprocChannel>(64, 64));
+            idle.back()->subscribe([](const std::uint8_t*, std::size_t) {});
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const std::uint64_t cpu0 = wxz::bench::process_cpu_ns();
+        const std::uint64_t sw0 = voluntary_switches();
+        std::this_thread::sleep_for(std::chrono::milliseconds(idle_ms));
+        const std::uint64_t cpu = wxz::bench::process_cpu_ns() - cpu0;
+        const std::uint64_t sw = voluntary_switches() - sw0;
+        const double secs = static_cast<double>(idle_ms) / 1e3;
+        std::printf("idle %zu channels: cpu=%.2f%% wakeups=%.0f/s\n", channels,
+                    100.0 * static_cast<double>(cpu) / (secs * 1e9), static_cast<double>(sw) / secs);
+    }
+
+    wxz::core::ChannelQoS keep_all;
+    keep_all.history = 0; // 不丢样本：每条消息都计入延迟统计
+    InprocChannel ch(1024, 64, keep_all);
+    std::vector<std::uint64_t> latency;
+    latency.reserve(latency_msgs);
+    std::atomic<std::size_t> received{0};
+    ch.subscribe([&](const std::uint8_t* data, std::size_t size) {
+        if (size < sizeof(std::uint64_t)) return;
+        std::uint64_t sent = 0;
+        std::memcpy(&sent, data, sizeof(sent));
+        latency.push_back(wxz::bench::now_ns() - sent);
+        received.fetch_add(1, std::memory_order_release);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (std::size_t i = 0; i < latency_msgs; ++i) {
+        const std::uint64_t ts = wxz::bench::now_ns();
+        while (!ch.publish(reinterpret_cast<const std::uint8_t*>(&ts), sizeof(ts))) std::this_thread::yield();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    while (received.load(std::memory_order_acquire) < latency_msgs) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    wxz::bench::print_latency("wake latency @10kHz", latency);
+    return 0;
+}
@@ -0,0 +1,91 @@
+// 大帧（64 KB ~ 8 MB）payload 的内存路径开销：每帧分配一个 buffer、写满整帧、释放。
+// 对比逐帧 new[]/delete[]（FastDDS 动态内存策略下每个样本的行为）与 FastddsChannel 的
+// 写端 buffer 缓存（FastddsWriterBufferCache，large_data 配置：64 KB 基础尺寸 + 8 MB 整帧）
+// 以及接收侧共享 payload 池（FastddsRecvPayloadPool）。不包含 DDS 序列化与网络传输。
+// 最后一轮固定 glibc 的 mmap 阈值（关闭其动态调整），让大块 new[] 每次都是新映射，
+// 对应堆分配器不缓存大块时每帧都要缺页的情形。
+//
+// 用法：large_payload_bench [bytes_per_size=1073741824]
+
+#include "bench_util.h"
+#include "internal/fastdds_recv_payload_pool.h"
+#include "internal/fastdds_writer_buffer_cache.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <memory>
+
+using wxz::core::internal::FastddsRecvPayloadPool;
+using wxz::core::internal::FastddsWriterBufferCache;
+
+namespace {
+
+constexpr std::uint32_t kKiB = 1024;
+constexpr std::uint32_t kMiB = 1024 * kKiB;
+
+template <typename Fn>
+double ns_per_frame(std::size_t frames, Fn&& fn);
+
+double heap_ns_per_frame(std::uint32_t size, std::size_t frames) {
+    return ns_per_frame(frames, [size](std::size_t i) {
+        auto* buf = new std::uint8_t[size];
+        std::memset(buf, static_cast<int>(i), size);
+        // 防止写入被优化掉。
+        asm volatile("" : : "r"(buf) : "memory");
+        delete[] buf;
+    });
+}
+
+template <typename Fn>
+double ns_per_frame(std::size_t frames, Fn&& fn) {
+    for (std::size_t i = 0; i < 4; ++i) fn(i); // 预热
+    const std::uint64_t start = wxz::bench::now_ns();
+    for (std::size_t i = 0; i < frames; ++i) fn(i);
+    return static_cast<double>(wxz::bench::now_ns() - start) / static_cast<double>(frames);
+}
+
+void run_size(std::uint32_t size, std::uint64_t bytes_per_size) {
+    const std::size_t frames = std::max<std::uint64_t>(64, bytes_per_size / size);
+
+    const double heap = heap_ns_per_frame(size, frames);
+
+    FastddsWriterBufferCache cache(64 * kKiB, 8 * kMiB);
+    const double writer = ns_per_frame(frames, [&cache, size](std::size_t i) {
+        std::uint32_t cap = 0;
+        auto* buf = cache.acquire(size, cap);
+        std::memset(buf, static_cast<int>(i), size);
+        asm volatile("" : : "r"(buf) : "memory");
+        cache.release(buf, cap);
+    });
+
+    auto pool = std::make_shared<FastddsRecvPayloadPool>("bench");
+    const double recv = ns_per_frame(frames, [&pool, size](std::size_t i) {
+        auto ref = pool->acquire();
+        auto* buf = pool->prepare(ref, size);
+        std::memset(buf, static_cast<int>(i), size);
+        asm volatile("" : : "r"(buf) : "memory");
+    });
+
+    const auto gbps = [size](double ns) { return static_cast<double>(size) / ns; }; // bytes/ns == GB/s
+    std::printf("%5u KB  frames=%-6zu new/delete %9.1f us (%5.2f GB/s)  writer_cache %9.1f us (%5.2f GB/s)"
+                "  recv_pool %9.1f us (%5.2f GB/s)\n",
+                size / kKiB, frames, heap / 1e3, gbps(heap), writer / 1e3, gbps(writer), recv / 1e3, gbps(recv));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::uint64_t bytes_per_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (1ull << 30);
+    constexpr std::uint32_t kSizes[] = {64 * kKiB, 256 * kKiB, 1 * kMiB, 2 * kMiB, 4 * kMiB, 8 * kMiB};
+    for (const std::uint32_t size : kSizes) run_size(size, bytes_per_size);
+
+    (void)mallopt(M_MMAP_THRESHOLD, 128 * kKiB);
+    for (const std::uint32_t size : kSizes) {
+        const std::size_t frames = std::max<std::uint64_t>(64, bytes_per_size / size);
+        const double ns = heap_ns_per_frame(size, frames);
+        std::printf("%5u KB  new/delete, mmap threshold 128 KB %9.1f us (%5.2f GB/s)\n", size / kKiB, ns / 1e3,
+                    static_cast<double>(size) / ns);
+    }
+    return 0;
+}
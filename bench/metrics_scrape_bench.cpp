@@ -0,0 +1,113 @@
+// 抓取负载下的热路径 metrics 延迟：业务线程持续 counter_add + histogram_observe，
+// 对比无抓取与 10 Hz HTTP 抓取（每次都重新 render，cache_ttl=0）时单次上报的 p50/p99/max。
+// 注册表预先填充若干带标签序列，让 render 的汇总成本接近真实部署。
+//
+// 用法：metrics_scrape_bench [seconds=5] [series=2000] [port=19109]
+
+#include "bench_util.h"
+#include "metrics_http_server.h"
+#include "metrics_prometheus.h"
+#include "observability.h"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+// 发一次 GET 并读完响应（Connection: close）；返回读到的字节数。
+std::size_t scrape_once(int port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return 0;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<std::uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    std::size_t total = 0;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+        static constexpr char kReq[] = "GET /metrics HTTP/1.1\r\nHost: bench\r\nConnection: close\r\n\r\n";
+        if (::send(fd, kReq, sizeof(kReq) - 1, MSG_NOSIGNAL) > 0) {
+            char buf[65536];
+            ssize_t n;
+            while ((n = ::recv(fd, buf, sizeof(buf), 0)) > 0) total += static_cast<std::size_t>(n);
+        }
+    }
+    ::close(fd);
+    return total;
+}
+
+void run_phase(const char* label, double seconds, bool scrape, int port) {
+    std::atomic<bool> stop{false};
+    std::size_t scrapes = 0;
+    std::size_t bytes = 0;
+    std::thread scraper;
+    if (scrape) {
+        scraper = std::thread([&] {
+            auto next = std::chrono::steady_clock::now();
+            while (!stop.load(std::memory_order_relaxed)) {
+                bytes += scrape_once(port);
+                ++scrapes;
+                next += std::chrono::milliseconds(100);
+                std::this_thread::sleep_until(next);
+            }
+        });
+    }
+
+    auto& m = wxz::core::metrics();
+    std::vector<std::uint64_t> lat;
+    lat.reserve(static_cast<std::size_t>(seconds * 4e6));
+    const std::uint64_t end = wxz::bench::now_ns() + static_cast<std::uint64_t>(seconds * 1e9);
+    std::uint64_t t = wxz::bench::now_ns();
+    while (t < end) {
+        m.counter_add("bench.hot.count", 1.0, {{"channel", "hot"}});
+        m.histogram_observe("bench.hot.latency_ns", static_cast<double>(lat.size() & 1023), {{"channel", "hot"}});
+        const std::uint64_t t2 = wxz::bench::now_ns();
+        lat.push_back(t2 - t);
+        t = t2;
+    }
+    stop.store(true);
+    if (scraper.joinable()) scraper.join();
+
+    wxz::bench::print_latency(label, lat);
+    if (scrape) std::printf("  scrapes=%zu avg_body=%zu bytes\n", scrapes, scrapes ? bytes / scrapes : 0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+    const std::size_t series = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+    const int port = argc > 3 ? std::atoi(argv[3]) : 19109;
+
+    wxz::core::PrometheusMetricsSink prom;
+    wxz::core::set_metrics_sink(&prom);
+    for (std::size_t i = 0; i < series; ++i) {
+        const std::string id = std::to_string(i);
+        prom.counter_add("bench.bg.count", 1.0, {{"id", id}});
+        prom.histogram_observe("bench.bg.latency_ns", static_cast<double>(i), {{"id", id}});
+    }
+
+    wxz::core::MetricsHttpServer::Options opts;
+    opts.bind_addr = "127.0.0.1";
+    opts.port = port;
+    opts.cache_ttl = std::chrono::milliseconds(0); // 每次抓取都 render：最坏情况
+    opts.gzip = false;
+    wxz::core::MetricsHttpServer server(opts, [&prom] { return prom.render(); });
+    if (!server.start()) {
+        std::printf("failed to start metrics server on port %d\n", port);
+        return 1;
+    }
+
+    run_phase("warmup", seconds / 4, false, port);
+    run_phase("no scrape", seconds, false, port);
+    run_phase("10 Hz scrape", seconds, true, port);
+
+    server.stop();
+    wxz::core::set_metrics_sink(nullptr);
+    return 0;
+}
@@ -0,0 +1,94 @@
+// ShmChannel 通知方式对比：futex（自旋后 park）与 semaphore（每条 sem_post）。
+// - 唤醒延迟：写端每隔 interval 发一条带发送时间戳的消息，读端在 handler 里计算单向延迟（读端大多处于 park 状态）；
+// - 吞吐：写端连续 publish，统计全部送达的耗时。
+//
+// 用法：shm_notify_bench [latency_msgs=20000] [throughput_msgs=1000000]
+
+#include "bench_util.h"
+#include "shm_channel.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using wxz::core::ShmChannel;
+
+namespace {
+
+struct Result {
+    std::vector<std::uint64_t> latency_ns;
+    double throughput_mps{0};
+};
+
+ShmChannel::Options make_options(ShmChannel::Notify notify) {
+    ShmChannel::Options opts;
+    opts.notify = notify;
+    opts.ring_bytes = 1 << 20;
+    return opts;
+}
+
+void run_latency(ShmChannel::Notify notify, std::size_t n, std::uint32_t interval_us, Result& out) {
+    const std::string name = "/wxz_bench_notify_lat";
+    ShmChannel writer(name, 0, 0, /*create=*/true, make_options(notify));
+    ShmChannel reader(name, 0, 0, /*create=*/false, make_options(notify));
+    out.latency_ns.clear();
+    out.latency_ns.reserve(n);
+    std::atomic<std::size_t> received{0};
+    reader.subscribe([&](const std::uint8_t* data, std::size_t size) {
+        if (size < sizeof(std::uint64_t)) return;
+        std::uint64_t sent = 0;
+        std::memcpy(&sent, data, sizeof(sent));
+        out.latency_ns.push_back(wxz::bench::now_ns() - sent);
+        received.fetch_add(1, std::memory_order_release);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint64_t ts = wxz::bench::now_ns();
+        while (!writer.publish(reinterpret_cast<const std::uint8_t*>(&ts), sizeof(ts))) std::this_thread::yield();
+        std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+    }
+    while (received.load(std::memory_order_acquire) < n) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    reader.stop();
+}
+
+void run_throughput(ShmChannel::Notify notify, std::size_t n, Result& out) {
+    const std::string name = "/wxz_bench_notify_tp";
+    ShmChannel writer(name, 0, 0, /*create=*/true, make_options(notify));
+    ShmChannel reader(name, 0, 0, /*create=*/false, make_options(notify));
+    std::atomic<std::size_t> received{0};
+    reader.subscribe([&](const std::uint8_t*, std::size_t) { received.fetch_add(1, std::memory_order_relaxed); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::uint8_t payload[64] = {};
+    const std::uint64_t start = wxz::bench::now_ns();
+    for (std::size_t i = 0; i < n; ++i) {
+        while (!writer.publish(payload, sizeof(payload))) std::this_thread::yield();
+    }
+    while (received.load(std::memory_order_relaxed) < n) std::this_thread::yield();
+    const std::uint64_t elapsed = wxz::bench::now_ns() - start;
+    out.throughput_mps = static_cast<double>(n) / (static_cast<double>(elapsed) / 1e9);
+    reader.stop();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t latency_msgs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    const std::size_t throughput_msgs = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+
+    const std::pair<const char*, ShmChannel::Notify> modes[] = {
+        {"futex", ShmChannel::Notify::futex},
+        {"semaphore", ShmChannel::Notify::semaphore},
+    };
+    for (const auto& [label, notify] : modes) {
+        Result r;
+        run_latency(notify, latency_msgs, 100, r);
+        wxz::bench::print_latency((std::string(label) + " wake latency @10kHz").c_str(), r.latency_ns);
+        run_throughput(notify, throughput_msgs, r);
+        std::printf("%-32s %.2f Mmsg/s (64 B)\n", (std::string(label) + " throughput").c_str(), r.throughput_mps / 1e6);
+    }
+    return 0;
+}
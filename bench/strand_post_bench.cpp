@@ -0,0 +1,55 @@
+// Strand 的单任务 post+drain 开销：同一线程向一个 strand post 一批空任务，再由 threads=0 的执行器 spin 排空，
+// 对比节点池关闭（node_cache=0，每次 post 堆分配一个节点）与默认节点池。
+// 批大小不超过节点池时，稳态下 post 不分配内存。
+//
+// 用法：strand_post_bench [tasks=2000000] [batch=32]
+
+#include "bench_util.h"
+#include "executor.h"
+#include "strand.h"
+
+#include <cstdlib>
+
+using wxz::core::Executor;
+using wxz::core::Strand;
+
+namespace {
+
+double ns_per_task(std::size_t node_cache, std::size_t tasks, std::size_t batch) {
+    Executor::Options opts;
+    opts.threads = 0; // 由本线程驱动，排除跨线程唤醒的噪声
+    opts.name = "bench";
+    Executor ex(opts);
+    ex.start();
+    Strand::Options so;
+    so.quantum = 0;
+    so.node_cache = node_cache;
+    Strand strand(ex, so);
+
+    std::uint64_t sink = 0;
+    const std::uint64_t start = wxz::bench::now_ns();
+    for (std::size_t done = 0; done < tasks; done += batch) {
+        for (std::size_t i = 0; i < batch; ++i) (void)strand.post([&sink] { ++sink; });
+        // quantum=0：一次 drain 排空整批。不多调一次 spin_once，空队列上的超时等待会计入内核定时器松弛（约 50 us）。
+        (void)ex.spin_once(std::chrono::nanoseconds(0));
+    }
+    const std::uint64_t elapsed = wxz::bench::now_ns() - start;
+    ex.stop();
+    const std::size_t expected = (tasks + batch - 1) / batch * batch;
+    if (sink != expected) std::printf("warning: %llu tasks ran\n", static_cast<unsigned long long>(sink));
+    return static_cast<double>(elapsed) / static_cast<double>(expected);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t tasks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const std::size_t batch = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 32;
+
+    (void)ns_per_task(64, tasks / 4, batch); // 预热
+    const double heap = ns_per_task(0, tasks, batch);
+    const double pooled = ns_per_task(64, tasks, batch);
+    std::printf("batch=%zu node_cache=0   %.1f ns/task\n", batch, heap);
+    std::printf("batch=%zu node_cache=64  %.1f ns/task (%+.1f ns)\n", batch, pooled, pooled - heap);
+    return 0;
+}
@@ -4,164 +4,223 @@
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #include "move_only_function.h"
 #include "observability.h"
+#include "task_instrumentation.h"
+
+namespace wxz::core::internal {
+class WorkStealingScheduler;
+class TimerQueue;
+class PriorityLanes;
+} // namespace wxz::core::internal
 
 namespace wxz::core {
 
 // 最小固定大小的执行器。
 // - post()：将任务入队，由工作线程执行。
+// - post_at()/post_after()/post_every()：延时/周期任务，到期后按普通任务入队执行。
 // - stop()：停止接收新任务，并尽量把队列里的任务执行完后退出。
 class Executor {
 public:
+    // 队列实现：
+    // - mutex_queue：单个互斥锁保护的 FIFO 队列（默认）。
+    // - work_stealing：每个工作线程一个无锁 Chase-Lev 队列 + 全局无锁注入队列，空闲线程互相窃取、
+    //   无任务时 park 在 eventcount 上。适合多个外部线程（DDS listener 等）高频 post 的场景。
+    //   任务之间不保证全局 FIFO（需要顺序时使用 Strand）。
+    enum class Backend {
+        mutex_queue,
+        work_stealing,
+    };
+
+    // 优先级 lane（严格优先级：realtime > normal > background）：
+    // - realtime：按 deadline 最早优先（EDF）；post(Lane::realtime, f) 以入队时刻为 deadline，等价于 FIFO。
+    // - normal：post(f) 的默认 lane，即原有队列（受 max_queue/block_when_full 约束）。
+    // - background：只有 realtime/normal 都没有任务时才执行。
+    // realtime/background 各有独立上限，满时直接拒绝（不阻塞），与 normal 的背压互不影响。
+    enum class Lane {
+        realtime,
+        normal,
+        background,
+    };
+
     struct Options {
         // threads：
         // - >0：start() 时创建 N 个工作线程。
         // - =0：不创建线程；由用户通过 spin()/spin_once() 驱动执行。
         std::size_t threads{1};
+        // 所有待执行任务的总数上限（0 表示不限）；两种 backend 语义相同。
         std::size_t max_queue{1024};
         bool block_when_full{true};
+        Backend backend{Backend::mutex_queue};
+
+        // 线程池名：工作线程按配置 threading.<name> 设置放置/调度策略并命名为 "<name>/<i>"；
+        // realtime 专用线程与定时线程分别使用 threading.<name>_rt、threading.<name>_timer。
+        std::string name{"executor"};
+
+        // realtime/background lane 的待执行任务上限（0 表示不限）。
+        std::size_t realtime_max_queue{256};
+        std::size_t background_max_queue{1024};
+        // >0：另建 N 个只执行 realtime lane 的专用线程（threads==0 时同样创建）。
+        std::size_t realtime_threads{0};
+        // 专用线程：>0 时设置 SCHED_FIFO 优先级（1..99，需要 CAP_SYS_NICE，失败时告警并以普通策略继续运行）。
+        // 非 0/非空时覆盖配置 threading.<name>_rt 中的对应项。
+        int realtime_priority{0};
+        // 专用线程的 CPU 亲和性（为空表示沿用配置/不绑定）。
+        std::vector<int> realtime_cpus;
+
+        // 采样埋点（见 task_instrumentation.h）：每 sample_every 个 post 采样 1 个（0 表示关闭，默认）。
+        // 被采样任务上报 wxz.executor.queue_wait_us/run_us{executor}、wxz.executor.lane.queue_wait_us{lane}（直方图，
+        // 三个 lane 都覆盖）与 wxz.executor.queue_depth{executor}（gauge）；
+        // 通过本执行器的 Strand 同样按此比例采样（wxz.strand.*{strand}）。
+        std::uint32_t sample_every{0};
+        // >0：被采样任务运行超过该阈值时计入 wxz.executor.long_task{executor,tag} 并发出同名 trace 事件。
+        std::chrono::microseconds long_task_threshold{0};
+    };
+
+    // 延时/周期任务句柄；id==0 表示无效（调度失败）。可拷贝，cancel() 幂等。
+    struct TimerHandle {
+        std::uint64_t id{0};
+        explicit operator bool() const { return id != 0; }
     };
 
-    Executor() = default;
-    explicit Executor(Options opts) : opts_(std::move(opts)) {}
+    Executor();
+    explicit Executor(Options opts);
     Executor(const Executor&) = delete;
     Executor& operator=(const Executor&) = delete;
 
-    ~Executor() { stop(); }
-
-    bool start() {
-        bool expected = false;
-        if (!running_.compare_exchange_strong(expected, true)) return false;
-        stopping_.store(false);
-        if (opts_.threads > 0) {
-            workers_.reserve(opts_.threads);
-            for (std::size_t i = 0; i < opts_.threads; ++i) {
-                workers_.emplace_back([this] { worker_loop(); });
-            }
-        }
-        return true;
-    }
+    ~Executor();
+
+    bool start();
 
     // 在当前调用线程上驱动执行队列任务，直到请求 stop()。
     // 用于类 ROS2 的“单 spin 线程”用法（opts_.threads==0）。
-    void spin() {
-        if (!running_.load() || stopping_.load()) return;
-        worker_loop();
-    }
+    void spin();
 
     // 最多执行一个任务。
     // - 若本次确实执行了一个任务则返回 true。
     // - 超时/无任务/正在停止时返回 false。
     template <class Rep, class Period>
     bool spin_once(const std::chrono::duration<Rep, Period>& timeout) {
-        if (!running_.load() || stopping_.load()) return false;
-
-        MoveOnlyFunction task;
-        {
-            std::unique_lock<std::mutex> lock(mu_);
-            if (tasks_.empty()) {
-                cv_task_.wait_for(lock, timeout, [&] { return stopping_.load() || !tasks_.empty(); });
-            }
-
-            if (tasks_.empty() || stopping_.load()) return false;
-            task = std::move(tasks_.front());
-            tasks_.pop_front();
-            cv_not_full_.notify_one();
-        }
-
-        task();
-        return true;
+        return spin_once_for(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout));
     }
 
-    void stop() {
-        if (!running_.load()) return;
-        stopping_.store(true);
-        {
-            std::lock_guard<std::mutex> lock(mu_);
-            cv_task_.notify_all();
-            cv_not_full_.notify_all();
-        }
-        for (auto& t : workers_) {
-            if (t.joinable()) t.join();
-        }
-        workers_.clear();
-        running_.store(false);
-    }
+    void stop();
 
     template <class F>
     bool post(F&& fn) {
         MoveOnlyFunction task(std::forward<F>(fn));
         if (!task) return true;
-        if (!running_.load()) {
-            if (wxz::core::has_metrics_sink()) {
-                wxz::core::metrics().counter_add("wxz.executor.post.reject", 1, {{"reason", "not_running"}});
-            }
-            return false;
-        }
-        if (stopping_.load()) {
-            if (wxz::core::has_metrics_sink()) {
-                wxz::core::metrics().counter_add("wxz.executor.post.reject", 1, {{"reason", "stopping"}});
-            }
-            return false;
-        }
-
-        std::unique_lock<std::mutex> lock(mu_);
-        if (opts_.max_queue > 0) {
-            if (opts_.block_when_full) {
-                cv_not_full_.wait(lock, [&] {
-                    return stopping_.load() || tasks_.size() < opts_.max_queue;
-                });
-            }
-            if (stopping_.load()) {
-                if (wxz::core::has_metrics_sink()) {
-                    wxz::core::metrics().counter_add("wxz.executor.post.reject", 1, {{"reason", "stopping"}});
-                }
-                return false;
-            }
-            if (tasks_.size() >= opts_.max_queue) {
-                if (wxz::core::has_metrics_sink()) {
-                    wxz::core::metrics().counter_add("wxz.executor.post.reject", 1, {{"reason", "queue_full"}});
-                }
-                return false;
-            }
-        }
-
-        tasks_.push_back(std::move(task));
-        cv_task_.notify_one();
-        return true;
+        return post_task(std::move(task));
+    }
+
+    // 带调用点标签的 post：tag 须为字符串字面量（或生命周期覆盖任务执行），用于长任务定位。
+    template <class F>
+    bool post_tagged(const char* tag, F&& fn) {
+        MoveOnlyFunction task(std::forward<F>(fn));
+        if (!task) return true;
+        return post_task(std::move(task), /*may_block=*/true, Lane::normal, nullptr, tag);
+    }
+
+    // 投递到指定 lane；Lane::normal 等价于 post(fn)。
+    template <class F>
+    bool post(Lane lane, F&& fn) {
+        MoveOnlyFunction task(std::forward<F>(fn));
+        if (!task) return true;
+        return post_task(std::move(task), /*may_block=*/true, lane);
     }
 
+    // 带绝对截止时间的 realtime 任务：realtime lane 内按 deadline 最早优先执行；
+    // 开始执行时已过 deadline 计入 wxz.executor.lane.deadline_miss（仍会执行）。
+    template <class F>
+    bool post_before(std::chrono::steady_clock::time_point deadline, F&& fn) {
+        MoveOnlyFunction task(std::forward<F>(fn));
+        if (!task) return true;
+        return post_task(std::move(task), /*may_block=*/true, Lane::realtime, &deadline);
+    }
+
+    // 不阻塞的 post：队列已满（或正在停止）时立即返回 false，不等待空位（block_when_full 对其无效）。
+    // 用于工作线程内部的自我重投（如 Strand 让出），避免所有工作线程都阻塞在满队列上。
+    template <class F>
+    bool try_post(F&& fn) {
+        return try_post(Lane::normal, std::forward<F>(fn));
+    }
+
+    template <class F>
+    bool try_post(Lane lane, F&& fn) {
+        MoveOnlyFunction task(std::forward<F>(fn));
+        if (!task) return true;
+        return post_task(std::move(task), /*may_block=*/false, lane);
+    }
+
+    // 延时任务（steady clock）：
+    // - 由执行器内部的定时线程（首次使用时创建）按最小堆等待到期，到期后以不阻塞的方式 post；
+    //   没有待触发定时器时该线程无限期等待，不产生空闲唤醒。
+    // - 可在 start() 之前调度；执行器停止期间不触发，重新 start() 后过期任务立即触发。
+    // - 到期时队列已满（或执行器正在停止）则本次触发被丢弃并计入 wxz.executor.post.reject。
+    template <class F>
+    TimerHandle post_at(std::chrono::steady_clock::time_point when, F&& fn) {
+        MoveOnlyFunction task(std::forward<F>(fn));
+        if (!task) return {};
+        return schedule_timer(when, std::chrono::nanoseconds(0), std::move(task));
+    }
+
+    template <class Rep, class Period, class F>
+    TimerHandle post_after(const std::chrono::duration<Rep, Period>& delay, F&& fn) {
+        return post_at(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::nanoseconds>(delay),
+                       std::forward<F>(fn));
+    }
+
+    // 周期任务（固定速率，首次在 now+period 触发）：
+    // - 同一周期任务不会重叠执行：上一次尚未执行完时本次触发跳过（计入 wxz.executor.timer.overrun）。
+    // - 触发严重滞后时追赶到下一个未来周期点，不补发。
+    // - period<=0 时返回无效句柄。
+    template <class Rep, class Period, class F>
+    TimerHandle post_every(const std::chrono::duration<Rep, Period>& period, F&& fn) {
+        const auto p = std::chrono::duration_cast<std::chrono::nanoseconds>(period);
+        if (p.count() <= 0) return {};
+        MoveOnlyFunction task(std::forward<F>(fn));
+        if (!task) return {};
+        return schedule_timer(std::chrono::steady_clock::now() + p, p, std::move(task));
+    }
+
+    // 取消定时器：返回后回调不会再开始执行（已在其它线程上执行中的那一次不受影响）。
+    // 返回 false 表示句柄无效、一次性任务已触发或已取消。
+    bool cancel(TimerHandle h);
+
     bool running() const { return running_.load(); }
 
+    const std::string& name() const { return opts_.name; }
+    std::uint32_t sample_every() const { return opts_.sample_every; }
+    std::chrono::microseconds long_task_threshold() const { return opts_.long_task_threshold; }
+
 private:
-    void worker_loop() {
-        for (;;) {
-            MoveOnlyFunction task;
-            {
-                std::unique_lock<std::mutex> lock(mu_);
-                cv_task_.wait(lock, [&] { return stopping_.load() || !tasks_.empty(); });
-
-                if (tasks_.empty()) {
-                    if (stopping_.load()) return;
-                    continue;
-                }
-
-                task = std::move(tasks_.front());
-                tasks_.pop_front();
-                cv_not_full_.notify_one();
-            }
-
-            task();
-        }
-    }
+    friend class internal::TimerQueue;
+
+    bool spin_once_for(std::chrono::nanoseconds timeout);
+    // may_block=false：队列满时直接拒绝（定时线程使用，不能被背压阻塞）。
+    // deadline 仅对 Lane::realtime 有效（nullptr 表示以入队时刻为 deadline）。
+    bool post_task(MoveOnlyFunction&& task,
+                   bool may_block = true,
+                   Lane lane = Lane::normal,
+                   const std::chrono::steady_clock::time_point* deadline = nullptr,
+                   const char* tag = nullptr);
+    void report_depth(std::size_t depth);
+    void wake_for_lane(Lane lane);
+    void realtime_loop();
+    TimerHandle schedule_timer(std::chrono::steady_clock::time_point when,
+                               std::chrono::nanoseconds period,
+                               MoveOnlyFunction&& task);
+    void worker_loop();
 
     Options opts_;
 
@@ -170,7 +229,15 @@ private:
     std::condition_variable cv_not_full_;
     std::deque<MoveOnlyFunction> tasks_;
 
+    // work_stealing backend（mutex_queue 时为空）。
+    std::unique_ptr<internal::WorkStealingScheduler> ws_;
+    // 延时/周期任务。
+    std::unique_ptr<internal::TimerQueue> timers_;
+    // realtime/background lane。
+    std::unique_ptr<internal::PriorityLanes> lanes_;
+
     std::vector<std::thread> workers_;
+    std::vector<std::thread> realtime_workers_;
     std::atomic<bool> running_{false};
     std::atomic<bool> stopping_{false};
 };
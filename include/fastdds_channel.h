@@ -10,6 +10,7 @@
 #include <vector>
 #include <chrono>
 
+#include "sharded_counter.h"
 #include "subscription.h"
 
 #include "inproc_channel.h" // for ChannelQoS
@@ -26,6 +27,7 @@ class DomainParticipant;
 class Publisher;
 class Subscriber;
 class Topic;
+class ContentFilteredTopic;
 class DataWriter;
 class DataReader;
 class DataReaderListener;
@@ -36,6 +38,13 @@ struct DataReaderQos;
 } // namespace fastdds
 } // namespace eprosima
 
+namespace wxz::core::internal {
+class SharedFastddsParticipant;
+class FastddsWriterPayloadPool;
+class FastddsRecvPayloadPool;
+class FastddsReceiveGroup;
+} // namespace wxz::core::internal
+
 namespace wxz::core {
 
 class Executor;
@@ -54,6 +63,70 @@ public:
         Handler handler;
     };
 
+    // copy-on-write 订阅表：订阅变更时整体替换；listener 每次 on_data_available 只复制一次 shared_ptr，
+    // 投递出去的任务也只持有该快照的引用（不再逐样本/逐 handler 复制 std::function）。
+    struct HandlerTable {
+        std::vector<HandlerEntry> entries;
+        ByteBufferPool* leased_pool{nullptr};
+        LeasedHandler leased_handler;
+        Executor* leased_executor{nullptr};
+        Strand* leased_strand{nullptr};
+        // entries 中存在投递到 executor/strand 的 handler（需要共享 payload）。
+        bool has_dispatched{false};
+    };
+
+    // 发布侧 loan：data() 直接指向即将交给 DataWriter 的 serialized payload（CDR 头之后）。
+    // - 通过 loan() 获得；写入后 commit(n)，再 publish(std::move(loan))，帧字节只写一次。
+    // - 未发布即析构时 buffer 自动归还；loan 只能交给创建它的 channel 发布。
+    class Loan {
+    public:
+        Loan() = default;
+        Loan(Loan&& other) noexcept { move_from(std::move(other)); }
+        Loan& operator=(Loan&& other) noexcept {
+            if (this != &other) {
+                release();
+                move_from(std::move(other));
+            }
+            return *this;
+        }
+        Loan(const Loan&) = delete;
+        Loan& operator=(const Loan&) = delete;
+        ~Loan() { release(); }
+
+        std::uint8_t* data() { return data_; }
+        const std::uint8_t* data() const { return data_; }
+        std::size_t capacity() const { return capacity_; }
+        std::size_t size() const { return size_; }
+        void commit(std::size_t size) { size_ = size; }
+        bool valid() const { return pool_ != nullptr; }
+
+    private:
+        friend class FastddsChannel;
+
+        std::shared_ptr<internal::FastddsWriterPayloadPool> pool_;
+        std::uint8_t* buffer_{nullptr}; // payload 起始（含 CDR 头）
+        std::uint32_t buffer_capacity_{0};
+        std::uint8_t* data_{nullptr};
+        std::size_t capacity_{0};
+        std::size_t size_{0};
+
+        void release();
+        void move_from(Loan&& other) {
+            pool_ = std::move(other.pool_);
+            buffer_ = other.buffer_;
+            buffer_capacity_ = other.buffer_capacity_;
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            size_ = other.size_;
+            other.pool_.reset();
+            other.buffer_ = nullptr;
+            other.buffer_capacity_ = 0;
+            other.data_ = nullptr;
+            other.capacity_ = 0;
+            other.size_ = 0;
+        }
+    };
+
     // domain_id：DDS domain；topic：topic 名；type_name 可选（默认使用内部 raw type）。
     FastddsChannel(int domain_id, std::string topic, const ChannelQoS& qos, std::size_t max_payload = 4096);
 
@@ -69,11 +142,28 @@ public:
     ~FastddsChannel();
 
     bool publish(const std::uint8_t* data, std::size_t size);
+
+    // 接收模式由 ChannelQoS::recv_batch 决定：
+    // - 0（默认）：每条样本一次 take_next_sample，反序列化进 listener 自有的消息缓冲。
+    // - N>0：每次 take 借出最多 N 条样本（loan），整批派发后 return_loan；同一次 listener 回调内处理完所有就绪样本。
+    //   本 handler 拿到的是借出样本的视图（只在回调期间有效）；投递型/leased handler 各拷贝一次。
+    // handler 的执行线程由 ChannelQoS::recv_threads/recv_group 决定：默认为 FastDDS listener 线程，
+    // 开启接收线程模式后为库自建的接收线程（FastDDS 内部线程不执行用户代码）。
     void subscribe(Handler handler);
 
+    // 零拷贝发布（大帧推荐）：
+    // - loan() 返回容量为 max_payload 的可写区域，该区域就是 DataWriter 将要发送的 payload；
+    //   channel 为仅订阅、或已停止时返回 invalid loan。
+    // - publish(Loan&&) 只补写 CDR 头，不再拷贝帧字节；无论成功与否 loan 都会被消费。
+    // 说明：raw 字节类型是变长类型，FastDDS 的 DataWriter::loan_sample 仅支持 plain 类型，
+    // 因此这里通过 channel 自有的 writer payload pool 把已填好的 buffer 直接交给 DataWriter。
+    // ChannelQoS::data_sharing 开启时 payload 来自 FastDDS 的共享内存 pool，publish(Loan&&) 会多一次拷贝。
+    Loan loan();
+    bool publish(Loan&& loan);
+
     // 类 ROS2 约定：不要在 FastDDS 的回调线程里直接调用用户 handler。
-    // 这里会先拷贝消息字节，然后把回调投递到指定的调度器上执行。
-    // 注意：如果希望接收侧做到“每条消息不分配内存”，优先使用 subscribe_leased_on()。
+    // 每条样本被反序列化进一个池化、引用计数的 payload，所有投递到 executor/strand 的 handler 共享它
+    // （最后一个 handler 执行完后 buffer 回到池中）；稳态下不分配内存，见 recv_buffer_allocations()。
     void subscribe_on(Executor& ex, Handler handler);
     void subscribe_on(Strand& strand, Handler handler);
 
@@ -109,13 +199,22 @@ public:
     std::uint64_t publish_success() const { return publish_success_.load(); }
     std::uint64_t publish_fail() const { return publish_fail_.load(); }
     std::uint64_t last_publish_duration_ns() const { return last_publish_duration_ns_.load(); }
-    std::uint64_t messages_received() const { return messages_received_.load(); }
+    // 成功发布的 loan 数（失败计入 publish_fail）。
+    std::uint64_t publish_loaned() const { return publish_loaned_.load(); }
+    std::uint64_t messages_received() const;
 
     // 丢弃统计（Drops）
     // - drop_pool_exhausted：请求 leased subscribe，但池里无可用 buffer。
     // - drop_dispatch_rejected：投递目标拒绝（executor/strand 已停止或队列已满）。
-    std::uint64_t recv_drop_pool_exhausted() const { return recv_drop_pool_exhausted_.load(); }
-    std::uint64_t recv_drop_dispatch_rejected() const { return recv_drop_dispatch_rejected_.load(); }
+    std::uint64_t recv_drop_pool_exhausted() const;
+    std::uint64_t recv_drop_dispatch_rejected() const;
+
+    // 接收侧共享 payload 池的分配次数（新建 buffer 或扩容）；预热后应保持不变。
+    std::uint64_t recv_buffer_allocations() const;
+
+    // 替换内容过滤表达式的参数（ChannelQoS::filter_expression 中的 %N），无需重建 reader。
+    // 未配置过滤、参数非法或 channel 已停止时返回 false（原参数保持不变）。
+    bool set_filter_parameters(const std::vector<std::string>& parameters);
 
     // 暴露 writer 以便诊断（matched count 等）。调用方不可在 channel 生命周期之外持有该指针。
     eprosima::fastdds::dds::DataWriter* data_writer() const;
@@ -128,6 +227,9 @@ private:
 
     void cleanup();
 
+    // 调用方需持有 entity_mutex_ 且 writer_ 非空。
+    bool write_sample(void* sample, std::size_t size);
+
     int domain_id_{0};
     std::string topic_name_;
     std::size_t max_payload_{0};
@@ -136,37 +238,44 @@ private:
     // 没有该锁的话，可能出现：定时线程还在 publish()，同时 cleanup() 删除 writer/participant。
     mutable std::mutex entity_mutex_;
 
-    // 构造是否成功（用于选择 teardown 策略）。
-    bool constructed_ok_{false};
+    // 进程内共享的 participant（含 Publisher/Subscriber），按 domain + profile 引用计数复用。
+    // participant_/publisher_/subscriber_ 仅为借用指针，生命周期由 shared_participant_ 保证。
+    std::shared_ptr<internal::SharedFastddsParticipant> shared_participant_;
 
     eprosima::fastdds::dds::DomainParticipant* participant_{nullptr};
     eprosima::fastdds::dds::Publisher* publisher_{nullptr};
     eprosima::fastdds::dds::Subscriber* subscriber_{nullptr};
     eprosima::fastdds::dds::Topic* topic_{nullptr};
+    // 配置了 ChannelQoS::filter_expression 时 reader 建在该过滤 topic 上。
+    eprosima::fastdds::dds::ContentFilteredTopic* filtered_topic_{nullptr};
     eprosima::fastdds::dds::DataWriter* writer_{nullptr};
     eprosima::fastdds::dds::DataReader* reader_{nullptr};
     eprosima::fastdds::dds::TypeSupport type_;
 
-    std::vector<HandlerEntry> handlers_;
-    ByteBufferPool* leased_pool_{nullptr};
-    LeasedHandler leased_handler_;
-    Executor* leased_executor_{nullptr};
-    Strand* leased_strand_{nullptr};
+    // writer 的 payload 内存池（同时承载 loan() 的 buffer）；由 DataWriter 与未发布的 loan 共同持有。
+    std::shared_ptr<internal::FastddsWriterPayloadPool> payload_pool_;
+
+    // 复制当前订阅表、应用 mutate 后整体替换（持 handler_mutex_）。
+    void update_handlers(const std::function<void(HandlerTable&)>& mutate);
+
+    std::shared_ptr<const HandlerTable> handlers_{std::make_shared<HandlerTable>()};
     std::uint64_t next_handler_id_{1};
     std::mutex handler_mutex_;
+    // 接收侧共享 payload 池（仅订阅端创建）；由 channel 与借出中的 payload 共同持有。
+    std::shared_ptr<internal::FastddsRecvPayloadPool> recv_pool_;
+    // 接收统计由 listener 持有（handler 内析构 channel 时 listener 可能晚于 channel 释放）。
     std::unique_ptr<eprosima::fastdds::dds::DataReaderListener> listener_;
+    // 接收线程模式下所属的接收线程组（listener 不挂到 reader 上，由组内线程调用）；为空表示 listener 模式。
+    std::shared_ptr<internal::FastddsReceiveGroup> recv_group_;
 
-    std::atomic<std::uint64_t> publish_success_{0};
-    std::atomic<std::uint64_t> publish_fail_{0};
+    // 热路径统计按线程分片（多个发布线程/FastDDS 接收线程不争同一缓存行）；读取时汇总。
+    ShardedCounter publish_success_;
+    ShardedCounter publish_fail_;
+    ShardedCounter publish_loaned_;
     std::atomic<std::uint64_t> last_publish_duration_ns_{0};
-    std::atomic<std::uint64_t> messages_received_{0};
-
-    std::atomic<std::uint64_t> recv_drop_pool_exhausted_{0};
-    std::atomic<std::uint64_t> recv_drop_dispatch_rejected_{0};
 
-    // 析构安全：避免在 listener 回调执行期间删除 FastDDS 实体。
+    // 析构安全：停止后 publish/loan 直接失败；listener 另有自己的停止标志与在途计数。
     std::atomic<bool> stopping_{false};
-    std::atomic<std::uint32_t> callbacks_inflight_{0};
 };
 
 } // namespace wxz::core
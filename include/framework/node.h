@@ -423,12 +423,21 @@ private:
 enum class CallbackGroupType { MutuallyExclusive, Reentrant };
 
 /// CallbackGroup：包装一个用于分派回调的 scheduler（要么是 Strand，要么是 Executor）。
+/// - lane：回调在执行器上的优先级（见 core::Executor::Lane）。MutuallyExclusive 组的 strand 整体投递到该 lane；
+///   Reentrant 组经由 post() 投递的回调使用该 lane（订阅/服务直接绑定 executor() 时仍走 normal lane）。
 class CallbackGroup {
 public:
-    explicit CallbackGroup(CallbackGroupType t, wxz::core::Executor& ex)
-        : type_(t), executor_(&ex) {
+    /// name：采样埋点标签（MutuallyExclusive 组的 strand 名，见 core::Executor::Options::sample_every）。
+    explicit CallbackGroup(CallbackGroupType t,
+                           wxz::core::Executor& ex,
+                           wxz::core::Executor::Lane lane = wxz::core::Executor::Lane::normal,
+                           std::string name = {})
+        : type_(t), executor_(&ex), lane_(lane) {
         if (type_ == CallbackGroupType::MutuallyExclusive) {
-            owned_strand_ = std::make_unique<wxz::core::Strand>(*executor_);
+            wxz::core::Strand::Options sopts;
+            sopts.lane = lane_;
+            if (!name.empty()) sopts.name = std::move(name);
+            owned_strand_ = std::make_unique<wxz::core::Strand>(*executor_, sopts);
             strand_ = owned_strand_.get();
         }
     }
@@ -440,10 +449,19 @@ public:
     CallbackGroupType type() const { return type_; }
     wxz::core::Executor* executor() const { return executor_; }
     wxz::core::Strand* strand() const { return strand_; }
+    wxz::core::Executor::Lane lane() const { return lane_; }
+
+    /// 按组的语义投递一个回调：MutuallyExclusive 走 strand，Reentrant 直接投递到执行器的 lane。
+    template <class F>
+    bool post(F&& fn) {
+        if (strand_) return strand_->post(std::forward<F>(fn));
+        return executor_->post(lane_, std::forward<F>(fn));
+    }
 
 private:
     CallbackGroupType type_;
     wxz::core::Executor* executor_{nullptr};
+    wxz::core::Executor::Lane lane_{wxz::core::Executor::Lane::normal};
     std::unique_ptr<wxz::core::Strand> owned_strand_;
     wxz::core::Strand* strand_{nullptr};
 };
@@ -554,13 +572,24 @@ public:
 
         // 定时器默认绑定到 default_strand（保持“回调串行化 + 不占用 DDS listener 线程”）。
         timers_.bind_scheduler(*default_strand_);
+
+        // NodeBase 的周期任务（health/capability/heartbeat/timesync）同样由执行器定时驱动：
+        // 空闲节点无需主循环按 spin 周期轮询，发布间隔也不受 spin 周期量化。启动时先执行一次（与轮询时一致）。
+        for (auto& job : base_.take_periodic_jobs()) {
+            (void)default_strand_->post(job.run);
+            (void)timers_.create_wall_timer(job.period, std::move(job.run));
+        }
     }
 
     /// 创建 CallbackGroup：
     /// - `MutuallyExclusive` 返回基于 Strand 的串行组
     /// - `Reentrant` 返回基于 Executor 的并发组
-    CallbackGroupPtr create_callback_group(CallbackGroupType type) {
-        return std::make_shared<CallbackGroup>(type, *executor_);
+    /// - `lane`：组内回调在执行器上的优先级（控制环回调可放到 realtime lane）
+    /// - `name`：采样埋点标签（MutuallyExclusive 组）
+    CallbackGroupPtr create_callback_group(CallbackGroupType type,
+                                           wxz::core::Executor::Lane lane = wxz::core::Executor::Lane::normal,
+                                           std::string name = {}) {
+        return std::make_shared<CallbackGroup>(type, *executor_, lane, std::move(name));
     }
 
     wxz::core::NodeBase& base() { return base_; }
@@ -578,6 +607,7 @@ public:
     CallbackGroupPtr default_callback_group_ptr() const { return default_callback_group_; }
 
     /// 在主循环里调用：统一 tick（NodeBase + timers）。
+    /// NodeBase 的周期任务与 wall timer 已由执行器定时驱动，这里只处理未交给定时器的部分（period<=0 的任务等）。
     void tick() {
         base_.tick();
         (void)tick_timers();
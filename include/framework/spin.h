@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <thread>
 
 #include "framework/node.h"
 #include "framework/time.h"
@@ -27,15 +28,20 @@ inline bool spin_some(Node& node) {
 }
 
 /// ROS2-like spin：阻塞循环，直到 node.base().running()==false。
-/// - slice: 单次 executor 等待/处理时间片
-/// - loop_period: 主循环周期（用于 sleep，避免空转）
+/// - slice: 单次 executor 等待/处理时间片（无任务时阻塞在 executor 上，timer 到期投递会立即唤醒）。
+/// - loop_period: 兜底限速周期。executor 无法阻塞时（未 start()、正在停止等）spin_once 会立即返回，
+///   此时本轮补足 sleep 到 loop_period（<=0 时取 slice），避免空转占满 CPU；未绑定 scheduler 的 timer 也按此粒度 tick。
 inline void spin(Node& node,
                  std::chrono::milliseconds slice = std::chrono::milliseconds(10),
                  std::chrono::milliseconds loop_period = std::chrono::milliseconds(10)) {
-    Rate rate(loop_period);
+    const auto fallback = loop_period.count() > 0 ? loop_period : slice;
     while (node.base().running()) {
-        (void)spin_once(node, slice);
-        (void)rate.sleep();
+        const auto start = std::chrono::steady_clock::now();
+        if (spin_once(node, slice)) continue;
+        // 超时返回说明已在 executor 上等满 slice；提前返回且没有执行任务才需要兜底 sleep。
+        if (std::chrono::steady_clock::now() - start < slice) {
+            std::this_thread::sleep_until(start + fallback);
+        }
     }
 }
 
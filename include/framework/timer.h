@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <functional>
@@ -9,6 +10,7 @@
 #include <vector>
 
 #include "executor.h"
+#include "observability.h"
 #include "strand.h"
 
 #include "framework/time.h"
@@ -18,7 +20,8 @@ namespace wxz::framework {
 /// ROS2-like wall timer：
 /// - 计时基于 steady clock。
 /// - 回调不直接执行：统一投递到 Executor/Strand。
-/// - 由于 core::Executor 当前不支持延时任务，本实现需要在主循环中显式 tick()。
+/// - 已绑定 scheduler 时由 core::Executor::post_every 驱动（到期即投递，无需轮询）；
+///   未绑定 scheduler 时退化为在主循环中显式 tick()。
 class TimerManager {
 public:
     using Callback = std::function<void()>;
@@ -28,15 +31,28 @@ public:
     };
 
     TimerManager() = default;
+    TimerManager(const TimerManager&) = delete;
+    TimerManager& operator=(const TimerManager&) = delete;
+
+    ~TimerManager() {
+        std::lock_guard<std::mutex> lock(mu_);
+        for (auto& t : timers_) cancel_locked(t);
+    }
 
     void bind_scheduler(wxz::core::Executor& ex) {
+        std::lock_guard<std::mutex> lock(mu_);
+        disarm_all_locked();
         ex_ = &ex;
         strand_ = nullptr;
+        rearm_all_locked();
     }
 
     void bind_scheduler(wxz::core::Strand& strand) {
+        std::lock_guard<std::mutex> lock(mu_);
+        disarm_all_locked();
         strand_ = &strand;
         ex_ = nullptr;
+        rearm_all_locked();
     }
 
     /// 创建 wall timer。
@@ -49,11 +65,12 @@ public:
         t.period = period;
         t.next_fire = steady_now() + period;
         t.cb = std::move(cb);
+        if (period.count() > 0) t.ex_handle = arm(t.period, t.cb);
         timers_.push_back(std::move(t));
         return TimerHandle{id};
     }
 
-    /// 在主循环里周期调用：触发到期 timer，并把回调投递到 scheduler。
+    /// 在主循环里周期调用：触发到期且未由 Executor 驱动的 timer，并把回调投递到 scheduler。
     /// - 返回 true 表示至少触发并投递了一个回调。
     bool tick() {
         const auto now = steady_now();
@@ -63,6 +80,7 @@ public:
             std::lock_guard<std::mutex> lock(mu_);
             for (auto& t : timers_) {
                 if (!t.enabled) continue;
+                if (t.ex_handle) continue; // 由 Executor 驱动
                 if (t.period.count() <= 0) continue;
                 if (now < t.next_fire) continue;
 
@@ -88,7 +106,7 @@ public:
         std::lock_guard<std::mutex> lock(mu_);
         for (auto& t : timers_) {
             if (t.id == h.id) {
-                t.enabled = false;
+                cancel_locked(t);
                 return;
             }
         }
@@ -101,8 +119,60 @@ private:
         std::chrono::milliseconds period{0};
         std::chrono::steady_clock::time_point next_fire{};
         Callback cb;
+        // 有效时表示由 Executor 周期任务驱动（tick() 跳过）。
+        wxz::core::Executor::TimerHandle ex_handle{};
     };
 
+    // 在已绑定的 scheduler 上挂周期任务；未绑定时返回无效句柄（由 tick() 驱动）。
+    wxz::core::Executor::TimerHandle arm(std::chrono::milliseconds period, const Callback& cb) {
+        if (strand_) {
+            // post_every 的防重叠只覆盖“投递到 strand”这一步，回调本身在 strand 上稍后执行：
+            // 单独跟踪回调是否仍在排队/执行，未完成时跳过本次触发（与 Executor 周期任务一致，计入 overrun）。
+            auto* s = strand_;
+            auto inflight = std::make_shared<std::atomic<bool>>(false);
+            return s->executor().post_every(period, [s, cb, inflight] {
+                if (inflight->exchange(true)) {
+                    if (wxz::core::has_metrics_sink()) {
+                        wxz::core::metrics().counter_add("wxz.executor.timer.overrun", 1, {});
+                    }
+                    return;
+                }
+                const bool ok = s->post([cb, inflight] {
+                    cb();
+                    inflight->store(false);
+                });
+                if (!ok) inflight->store(false);
+            });
+        }
+        if (ex_) {
+            return ex_->post_every(period, [cb] { cb(); });
+        }
+        return {};
+    }
+
+    void disarm_locked(Timer& t) {
+        if (!t.ex_handle) return;
+        wxz::core::Executor* ex = strand_ ? &strand_->executor() : ex_;
+        if (ex) (void)ex->cancel(t.ex_handle);
+        t.ex_handle = {};
+    }
+
+    void cancel_locked(Timer& t) {
+        t.enabled = false;
+        disarm_locked(t);
+    }
+
+    // 切换 scheduler：先撤销旧执行器上的周期任务，再在新 scheduler 上重挂。
+    void disarm_all_locked() {
+        for (auto& t : timers_) disarm_locked(t);
+    }
+
+    void rearm_all_locked() {
+        for (auto& t : timers_) {
+            if (t.enabled && t.period.count() > 0) t.ex_handle = arm(t.period, t.cb);
+        }
+    }
+
     void dispatch(Callback cb) {
         if (strand_) {
             (void)strand_->post([cb = std::move(cb)] { cb(); });
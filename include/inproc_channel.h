@@ -4,7 +4,6 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
-#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -12,6 +11,7 @@
 #include <utility>
 #include <vector>
 
+#include "sharded_counter.h"
 #include "subscription.h"
 
 namespace wxz::core {
@@ -33,6 +33,36 @@ struct ChannelQoS {
     std::int32_t ownership_strength{0};      // 仅在 ownership == exclusive 时生效
     std::int32_t transport_priority{0};
     bool async_publish{false};               // fastdds：异步发布模式
+    std::size_t recv_batch{0};               // fastdds：每次 take 借出最多 N 条样本批量派发；0 表示逐条 take_next_sample
+    // fastdds：接收线程模式。recv_threads>0 或 recv_group 非空时，由库自建的接收线程（WaitSet + ReadCondition）取样并派发，
+    // FastDDS 内部线程不再执行用户代码；否则在 FastDDS listener 线程中派发。
+    std::size_t recv_threads{0};             // 接收线程数（至少 1）
+    std::string recv_group;                  // 接收线程组名：同名 channel 共享一组线程（以首个创建者的参数为准）；空表示每个 channel 独占
+    std::vector<int> recv_cpus;              // 接收线程 CPU 绑定；非空时覆盖配置 threading.<组名>（默认组名 fastdds_recv）
+    // fastdds：keyed 实例。key_size>0 时 payload 的 [key_offset, key_offset+key_size) 字节作为实例 key，
+    // topic 变为 WITH_KEY，history 深度按实例计算；同一 topic 的所有写端/读端须使用相同的 key 区间。
+    std::size_t key_offset{0};
+    std::size_t key_size{0};
+    std::size_t max_instances{0};            // keyed 时 reader/writer 最多跟踪的实例数；0 表示不限
+    // fastdds：reader 侧内容过滤（ContentFilteredTopic），不匹配的样本在进入 history 前被丢弃（写端支持时在写端即丢弃）。
+    // 语法见 internal/fastdds_raw_filter.h，例如 "key IN (%0, %1, %2)"、"bytes[0:4] = 0x01000000"；空表示不过滤。
+    std::string filter_expression;
+    std::vector<std::string> filter_parameters;
+    // fastdds：大数据模式（图像/点云等 64 KB~数 MB 的帧）。
+    // large_data=true 时样本按 initial_payload（默认 64 KB）预分配，更大的帧按 memory_policy 重新分配，
+    // 而不是为 history 中的每个样本预分配 max_payload；channel_factory 对其放宽 max_payload 上限。
+    enum class MemoryPolicy { unset, preallocated, preallocated_realloc, dynamic, dynamic_reusable };
+    bool large_data{false};
+    MemoryPolicy memory_policy{MemoryPolicy::unset}; // writer/reader history 的 payload 内存策略；unset 按 large_data/initial_payload 推导
+    std::size_t initial_payload{0};          // 每个样本预分配的 payload 字节数；0 表示 max_payload（large_data 时为 64 KB）
+    // fastdds：吞吐流控。flow_bytes_per_period>0 时 writer 改为异步发布，每 flow_period_ms 最多发送该字节数（realtime_hint 时不生效）。
+    // 流控器挂在 participant 上：同名流控器的 channel 共享一个 participant 与发送预算（以首个创建者的参数为准）；名字为空时按参数命名。
+    std::uint64_t flow_bytes_per_period{0};
+    std::uint64_t flow_period_ms{100};
+    std::string flow_controller;
+    // fastdds：同主机 data-sharing（读端直接映射写端的共享内存 history）。要求固定尺寸预分配：
+    // 开启后按 max_payload 预分配且 memory_policy 固定为 preallocated（覆盖 large_data/initial_payload）。
+    bool data_sharing{false};
     bool realtime_hint{false};
 
     static ChannelQoS realtime_preset(std::size_t depth = 8) {
@@ -48,9 +78,26 @@ struct ChannelQoS {
         q.deadline_ns = 2'000'000;       // 默认 2 ms deadline 目标
         return q;
     }
+
+    // 在现有配置上叠加 realtime 预设：只覆盖可靠性、history、持久性、liveliness、发布模式与传输优先级；
+    // deadline/latency_budget 未设置时取预设值。key、过滤、接收线程、大数据与 data-sharing 等其余字段保持不变。
+    void apply_realtime_preset(std::size_t depth = 8) {
+        const ChannelQoS p = realtime_preset(depth);
+        reliability = p.reliability;
+        history = p.history;
+        durability = p.durability;
+        liveliness = p.liveliness;
+        async_publish = p.async_publish;
+        realtime_hint = p.realtime_hint;
+        transport_priority = p.transport_priority;
+        if (deadline_ns == 0) deadline_ns = p.deadline_ns;
+        if (latency_budget_ns == 0) latency_budget_ns = p.latency_budget_ns;
+    }
 };
 
 class BufferPool;
+class Executor;
+class Strand;
 
 // RAII buffer 句柄：由预分配池提供；用于进程内传输的零拷贝发布路径。
 class BufferHandle {
@@ -101,28 +148,39 @@ private:
     }
 };
 
+// 预分配的定长 buffer 池；空闲链表为无锁 Treiber 栈，acquire/release 可从任意线程并发调用。
+// capacity 须小于 2^32-1。
 class BufferPool {
 public:
     BufferPool(std::size_t capacity, std::size_t buffer_bytes);
     BufferPool(const BufferPool&) = delete;
     BufferPool& operator=(const BufferPool&) = delete;
 
+    // acquire() 返回的 buffer 引用计数为 1；release() 递减，归零时回到空闲链表。
     BufferHandle acquire();
     void release(std::size_t idx);
+    // 多个订阅共享同一 buffer 时追加引用。
+    void retain(std::size_t idx, std::uint32_t n = 1);
     std::size_t buffer_size() const { return buffer_bytes_; }
     std::uint8_t* data(std::size_t idx);
     std::size_t committed_size(std::size_t idx) const;
     void set_committed_size(std::size_t idx, std::size_t size);
+    // 发布时间戳（steady_clock，ns），供 lifespan/time_based_filter/deadline 判定。
+    std::uint64_t timestamp_ns(std::size_t idx) const;
+    void set_timestamp_ns(std::size_t idx, std::uint64_t ns);
 
 private:
     struct Node {
         std::vector<std::uint8_t> buf;
-        std::atomic<std::size_t> next;
+        std::atomic<std::uint32_t> next;
         std::atomic<std::size_t> len;
+        std::atomic<std::uint64_t> stamp_ns;
+        std::atomic<std::uint32_t> refs;
     };
 
     std::vector<Node> nodes_;
-    std::atomic<std::size_t> free_head_;
+    // Treiber 栈头：带版本号的索引（见 inproc_channel.cpp），64 位单字 CAS，避免 ABA。
+    std::atomic<std::uint64_t> free_head_;
     std::size_t buffer_bytes_{0};
 };
 
@@ -136,31 +194,60 @@ public:
     bool enqueue(std::size_t v);
     bool dequeue(std::size_t& v);
     std::size_t capacity() const { return capacity_; }
+    // 近似长度（并发入队/出队时只是快照）。
+    std::size_t size_approx() const;
 
     // 尝试出队最多 max_items 个元素到调用方提供的缓冲区；返回实际数量。
     std::size_t dequeue_batch(std::size_t* out, std::size_t max_items);
 
 private:
-    struct Cell {
+    // 每个 cell 独占一条缓存行：相邻槽位分别被生产端/消费端写入时不互相失效。
+    struct alignas(kCacheLineSize) Cell {
         std::atomic<std::size_t> seq;
         std::size_t data;
     };
 
     std::vector<Cell> buffer_;
     std::size_t mask_{0};
-    std::atomic<std::size_t> enqueue_pos_{0};
-    std::atomic<std::size_t> dequeue_pos_{0};
     std::size_t capacity_{0};
+    // 生产端/消费端游标分居不同缓存行（只读字段放在前面，不与任何一端共享）。
+    alignas(kCacheLineSize) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(kCacheLineSize) std::atomic<std::size_t> dequeue_pos_{0};
 };
 
+// 进程内通道。QoS 语义与 FastddsChannel 对齐：
+// - history=N（keep_last）：订阅端积压超过 N 条时丢弃最旧样本；队列/缓冲池写满时发布端覆盖最旧样本而不是失败。
+//   history=0（keep_all）：不丢弃，写满时 publish 失败（与旧行为一致）。
+// - lifespan_ns：分发时丢弃发布时间早于 lifespan 的样本。
+// - time_based_filter_ns：每个订阅独立的最小间隔，间隔内的样本对该订阅丢弃。
+// - deadline_ns：每个订阅自收到第一条样本起，相邻样本间隔（或空闲时长）每超出一个周期计一次 deadline_missed。
+//   空闲检测：默认分发由分发线程按周期醒来检测；订阅队列由排空所用 Executor（Strand 取其底层 Executor）上的周期任务检测。
+//
+// 分发方式：
+// - 默认：单个分发线程按顺序调用所有 handler（慢 handler 会拖慢其它订阅）。
+// - 订阅队列：Options::dispatch_threads>0 时 subscribe() 的订阅、以及 subscribe_on() 的订阅，
+//   各自持有一个无锁索引队列（keep_last 深度按订阅独立生效），发布端把同一个 buffer 索引（引用计数）
+//   分发到每个订阅队列，由 channel 自带的分发线程池或调用方提供的 Executor/Strand 并行排空；
+//   最后一个订阅处理完后 buffer 才归还缓冲池，payload 不拷贝。同一订阅内消息按发布顺序串行交付。
+// - 尚无任何订阅时发布的消息先缓存在共享队列（受 capacity/history 约束），由首个订阅（无论哪种方式）接收。
 class InprocChannel {
 public:
     using Handler = std::function<void(const std::uint8_t* data, std::size_t size)>;
 
+    struct Options {
+        // >0：subscribe() 的订阅使用独立队列，由 channel 内部 N 个线程的分发池并行排空；
+        // 0：沿用单分发线程（subscribe_on() 不受影响，始终使用独立队列）。
+        std::size_t dispatch_threads{0};
+        // 默认分发线程 park 前的自旋轮数上限（低延迟场景）；0 表示直接 park。单核机器上自动禁用自旋。
+        std::uint32_t spin_iterations{256};
+    };
+
     InprocChannel(std::size_t capacity, std::size_t buffer_bytes, const ChannelQoS& qos = {});
+    InprocChannel(std::size_t capacity, std::size_t buffer_bytes, const ChannelQoS& qos, const Options& opts);
     ~InprocChannel();
 
     // 零拷贝发布路径：分配 buffer -> 填充 -> commit -> publish。
+    // keep_last 下缓冲池耗尽时会丢弃队列中最旧的样本来腾出 buffer。
     BufferHandle allocate();
     bool publish(BufferHandle&& h);
 
@@ -174,6 +261,13 @@ public:
     // owner 为可选 tag（例如插件实例指针），用于批量清理。
     Subscription subscribe_scoped(Handler handler, void* owner = nullptr);
 
+    // 类 ROS2 的“带调度投递”订阅：独立队列，由指定 Executor/Strand 排空（同一订阅串行）。
+    // Executor/Strand 必须比订阅活得久；取消订阅会等待正在执行的 handler 返回（handler 内自取消除外）。
+    void subscribe_on(Executor& ex, Handler handler);
+    void subscribe_on(Strand& strand, Handler handler);
+    Subscription subscribe_scoped_on(Executor& ex, Handler handler, void* owner = nullptr);
+    Subscription subscribe_scoped_on(Strand& strand, Handler handler, void* owner = nullptr);
+
     // 批量取消：移除所有带指定 owner tag 的 handler。
     void unsubscribe_owner(void* owner);
 
@@ -183,31 +277,107 @@ public:
     // 可观测性
     std::uint64_t publish_success() const { return publish_success_.load(); }
     std::uint64_t publish_fail() const { return publish_fail_.load(); }
+    // 默认分发按消息计；订阅队列按（消息, 订阅）计。
     std::uint64_t messages_delivered() const { return messages_delivered_.load(); }
 
+    // 订阅队列的丢弃统计
+    // - drop_queue_full：keep_all 下订阅队列已满，该订阅丢弃新样本。
+    // - drop_dispatch_rejected：Executor/Strand 拒绝排空任务（已停止或队列已满），样本留在订阅队列等待下次调度。
+    std::uint64_t recv_drop_queue_full() const { return recv_drop_queue_full_.load(); }
+    std::uint64_t recv_drop_dispatch_rejected() const { return recv_drop_dispatch_rejected_.load(); }
+
+    // QoS 丢弃/违约统计
+    // - drop_history：keep_last 覆盖或积压超过 history 而丢弃的样本数。
+    // - drop_lifespan：超过 lifespan 而丢弃的样本数。
+    // - drop_filtered：被 time_based_filter 过滤的（样本, 订阅）次数。
+    // - deadline_missed：所有订阅累计错过的 deadline 周期数。
+    std::uint64_t recv_drop_history() const { return recv_drop_history_.load(); }
+    std::uint64_t recv_drop_lifespan() const { return recv_drop_lifespan_.load(); }
+    std::uint64_t recv_drop_filtered() const { return recv_drop_filtered_.load(); }
+    std::uint64_t deadline_missed() const { return deadline_missed_.load(); }
+
 private:
     void dispatch_loop();
+    void wake_dispatcher();
+    // 从队列头丢弃一条最旧样本（keep_last 覆盖）；队列为空时返回 false。
+    bool evict_oldest();
+    void count_drop(std::atomic<std::uint64_t>& counter, const char* metric, std::uint64_t n);
+
+    // 每个订阅的 QoS 状态。last_delivered_ns 仅交付线程读写；next_deadline_ns 还会被空闲检测读写
+    // （订阅队列的空闲检测由定时任务在其它线程执行），用 CAS 推进，同一周期只计一次。
+    struct SubscriberState {
+        std::uint64_t last_delivered_ns{0};
+        std::atomic<std::uint64_t> next_deadline_ns{0};
+    };
+    void check_deadline(SubscriberState& st, std::uint64_t now_ns);
 
     struct HandlerEntry {
         std::uint64_t id{0};
         void* owner{nullptr};
         Handler handler;
+        std::shared_ptr<SubscriberState> state;
     };
 
+    // 订阅队列。scheduled 保证同一时刻最多一个排空任务（因此 state 无需加锁）；
+    // active 统计正在访问该订阅的发布端/排空任务，取消订阅时据此等待。
+    struct SubscriberQueue {
+        explicit SubscriberQueue(std::size_t capacity) : queue(capacity) {}
+
+        std::uint64_t id{0};
+        void* owner{nullptr};
+        Handler handler;
+        Executor* executor{nullptr};
+        Strand* strand{nullptr};
+        // deadline_ns>0 时的空闲检测定时器（挂在排空所用的 Executor 上，id 即 Executor::TimerHandle::id）。
+        Executor* deadline_executor{nullptr};
+        std::uint64_t deadline_timer{0};
+        std::size_t depth{0}; // keep_last 深度；0 表示 keep_all（受队列容量约束）
+        IndexQueue queue;
+        SubscriberState state;
+        std::atomic<bool> scheduled{false};
+        std::atomic<bool> closed{false};
+        std::atomic<std::uint32_t> active{0};
+        std::atomic<std::thread::id> runner{};
+    };
+    using SubscriberList = std::vector<std::shared_ptr<SubscriberQueue>>;
+
+    Subscription add_queued(Handler handler, Executor* ex, Strand* strand, void* owner);
+    void remove_queued(const std::function<bool(const SubscriberQueue&)>& pred);
+    void close_queued(const std::shared_ptr<SubscriberQueue>& sub);
+    void fan_out(std::size_t idx, const SubscriberList& subs);
+    bool post_drain(const std::shared_ptr<SubscriberQueue>& sub);
+    void hand_over_backlog();
+    void drain_queued(const std::shared_ptr<SubscriberQueue>& sub);
+    void check_idle_deadline(const std::shared_ptr<SubscriberQueue>& sub);
+    bool deliver(SubscriberState& st, const Handler& handler, std::size_t idx);
+
     ChannelQoS qos_;
     BufferPool pool_;
     IndexQueue queue_;
     std::vector<HandlerEntry> handlers_;
+    // 订阅队列表（copy-on-write，发布端每条消息只复制一次 shared_ptr）。
+    std::shared_ptr<const SubscriberList> queued_{std::make_shared<SubscriberList>()};
+    std::unique_ptr<Executor> dispatch_pool_;
     std::uint64_t next_handler_id_{1};
     std::atomic<bool> running_{false};
     std::thread worker_;
-    std::condition_variable cv_;
-    std::mutex wait_mutex_;
+    std::uint32_t spin_iterations_{0};
     std::mutex handler_mutex_;
-
-    std::atomic<std::uint64_t> publish_success_{0};
-    std::atomic<std::uint64_t> publish_fail_{0};
-    std::atomic<std::uint64_t> messages_delivered_{0};
+    // 默认分发线程的 eventcount：wake_seq_ 为 futex 字（每次发布 +1），sleepers_ 为 park 中的线程数。
+    // 前者每条消息都被发布端写，后者由分发线程写、发布端每次读，分开放避免互相失效。
+    alignas(kCacheLineSize) std::atomic<std::uint32_t> wake_seq_{0};
+    alignas(kCacheLineSize) std::atomic<std::uint32_t> sleepers_{0};
+
+    // 热路径统计按线程分片（读取时汇总）；丢弃类计数频率低，保持单个 atomic。
+    ShardedCounter publish_success_;
+    ShardedCounter publish_fail_;
+    ShardedCounter messages_delivered_;
+    std::atomic<std::uint64_t> recv_drop_queue_full_{0};
+    std::atomic<std::uint64_t> recv_drop_dispatch_rejected_{0};
+    std::atomic<std::uint64_t> recv_drop_history_{0};
+    std::atomic<std::uint64_t> recv_drop_lifespan_{0};
+    std::atomic<std::uint64_t> recv_drop_filtered_{0};
+    std::atomic<std::uint64_t> deadline_missed_{0};
 };
 
 } // namespace wxz::core
@@ -1,16 +1,26 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 
 namespace wxz::core {
 
 // 极简 HTTP server：只提供 GET /metrics（或自定义 path）
-// - 单线程 accept loop + 每连接同步处理，响应后 close
-// - 不依赖第三方库
+// - 单线程 epoll 事件循环（非阻塞 socket，支持 HTTP/1.1 keep-alive 与 pipelining），慢客户端不阻塞其它抓取。
+// - render() 在独立的渲染线程上执行，结果按 cache_ttl 缓存为快照；快照过期期间到达的请求共享同一次渲染。
+// - 客户端声明 Accept-Encoding: gzip 时返回 gzip 压缩的快照（需构建时找到 zlib）。
+// - 请求头上限 16 KiB（超出返回 431）、body 上限 4 KiB（超出或分块 body 返回 413），拒绝后关闭连接；
+//   每个连接缓冲的未处理输入有上限，等待渲染期间缓冲满时停止读取。
+// - 不依赖第三方库（zlib 可选）
 class MetricsHttpServer final {
 public:
     struct Options {
@@ -18,6 +28,19 @@ public:
         int port{9100};
         std::string path{"/metrics"};
         int backlog{64};
+
+        // 渲染快照的有效期；0 表示每个请求都重新渲染（并发请求仍合并为一次）。
+        std::chrono::milliseconds cache_ttl{1000};
+        // keep-alive 连接的空闲超时。
+        std::chrono::milliseconds idle_timeout{30000};
+        // 写停滞超时：有未发出的响应、且超过该时长没有任何发送进展时关闭连接
+        // （卡住不读的抓取端不会一直占着 max_connections 的名额）。
+        std::chrono::milliseconds write_timeout{10000};
+        // 同时保持的连接数上限（超出时新连接被直接关闭）。
+        std::size_t max_connections{64};
+        // 是否对声明支持 gzip 的客户端压缩响应；小于 gzip_min_bytes 的快照不压缩。
+        bool gzip{true};
+        std::size_t gzip_min_bytes{1024};
     };
 
     using RenderFn = std::function<std::string()>;
@@ -32,8 +55,50 @@ public:
     void stop();
 
 private:
+    struct Snapshot {
+        std::string body;
+        // 为空表示不提供 gzip 版本（未启用、zlib 不可用或快照太小）。
+        std::string gzip_body;
+        std::chrono::steady_clock::time_point built;
+    };
+
+    struct Conn {
+        int fd{-1};
+        std::string in;
+        std::string out;
+        std::size_t out_off{0};
+        // 正在等待渲染快照的请求（只在队首请求等待时暂停解析，保证 pipelining 的响应顺序）。
+        bool waiting{false};
+        bool want_gzip{false};
+        bool keep_alive{true};
+        bool close_after_write{false};
+        // 对端已半关闭：不再关注可读事件（避免等待渲染期间反复触发）。
+        bool read_closed{false};
+        // 等待渲染期间输入缓冲已满：暂停关注可读事件，响应发出后恢复。
+        bool read_paused{false};
+        bool want_write{false};
+        std::chrono::steady_clock::time_point last_active;
+        // 最近一次发送进展（或开始等待可写）的时刻；仅在有未发出的输出时有意义。
+        std::chrono::steady_clock::time_point last_write;
+    };
+
     void run_();
-    static void write_all_(int fd, const char* data, std::size_t size);
+    void render_loop_();
+
+    void accept_();
+    void close_conn_(int fd);
+    void on_readable_(Conn& c);
+    void process_(Conn& c);
+    void respond_(Conn& c, const Snapshot& snap);
+    // 返回 false 表示连接已关闭。
+    bool flush_(Conn& c);
+    void update_events_(Conn& c);
+    void on_snapshot_ready_();
+    // 关闭空闲超时与写停滞超时的连接。
+    void sweep_idle_();
+
+    std::shared_ptr<const Snapshot> fresh_snapshot_() const;
+    void request_render_();
 
 private:
     Options opts_;
@@ -41,7 +106,21 @@ private:
 
     std::atomic<bool> running_{false};
     int listen_fd_{-1};
+    int epoll_fd_{-1};
+    // 渲染完成/停止时唤醒事件循环。
+    int wake_fd_{-1};
     std::thread worker_;
+    std::thread renderer_;
+
+    // 仅事件循环线程访问。
+    std::unordered_map<int, Conn> conns_;
+    bool render_pending_{false};
+
+    // 渲染线程与事件循环之间的交接。
+    mutable std::mutex snap_mu_;
+    std::condition_variable render_cv_;
+    bool render_requested_{false};
+    std::shared_ptr<const Snapshot> snapshot_;
 };
 
 } // namespace wxz::core
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "observability.h"
+#include "sharded_counter.h"
 
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
@@ -14,20 +19,103 @@ namespace wxz::core {
 // 一个小型的进程内 metrics sink，可渲染 Prometheus 文本格式（exposition）。
 //
 // 说明：
-// - Histogram 渲染为最小实现：仅暴露 <name>_count 与 <name>_sum。
-// - 适用于小/中等规模的进程内指标，不适合高基数场景。
+// - Histogram 按 family 的桶布局渲染为 <name>_bucket{le=...}（累积）、<name>_sum 与 <name>_count；
+//   未单独配置的 family 使用 Options::default_buckets（指数桶）。
+// - 可按 family 额外开启分位数（DDSketch，相对误差有界），渲染为 summary family <name>_summary{quantile=...}。
+// - 每次 observe 为 O(1)（桶上界二分查找，桶数有上限；sketch 为一次对数运算），同一序列首次出现之后不再分配内存。
+// - 热路径无锁：每个序列是一个地址稳定的单元，counter/histogram 按线程分片累加（render 时汇总），gauge 为单个原子量。
+//   高频调用点应通过 counter()/gauge()/histogram() 预先取得句柄；字符串 API 经线程局部的驻留键缓存映射到同一单元，
+//   缓存命中时不加锁、不分配，只对原始 name/labels 做一次拷贝与哈希。
+// - 开启分位数的 family 在 sketch 上仍按序列加锁。
+// - 适用于小/中等规模的进程内指标，不适合高基数场景（序列只增不删）。
 class PrometheusMetricsSink final : public MetricsSink {
+    struct CounterCell;
+    struct GaugeCell;
+    struct HistogramCell;
+
 public:
-    PrometheusMetricsSink() = default;
-    ~PrometheusMetricsSink() override = default;
+    // 单个 family 最多的桶数（不含 +Inf）。
+    static constexpr std::size_t kMaxBuckets = 64;
+
+    struct Options {
+        // 未配置布局的 histogram family 使用的桶上界（严格递增；+Inf 桶隐含）。
+        // 默认 1,2,4,...,2^23：覆盖 1us..8s 的时延与 1B..8MiB 的消息大小。
+        std::vector<double> default_buckets = exponential_buckets(1.0, 2.0, 24);
+    };
+
+    // 指数桶：start, start*factor, ...，共 count 个（start>0、factor>1，否则返回空）。
+    static std::vector<double> exponential_buckets(double start, double factor, std::size_t count);
+
+    PrometheusMetricsSink() : PrometheusMetricsSink(Options{}) {}
+    explicit PrometheusMetricsSink(Options opts);
+    ~PrometheusMetricsSink() override;
 
     PrometheusMetricsSink(const PrometheusMetricsSink&) = delete;
     PrometheusMetricsSink& operator=(const PrometheusMetricsSink&) = delete;
 
+    // 预注册的序列句柄：可拷贝，在 sink 生命周期内有效；默认构造的句柄上的操作为空操作。
+    class CounterHandle {
+    public:
+        CounterHandle() = default;
+        void add(double value = 1.0) const noexcept {
+            if (cell_) cell_->add(value);
+        }
+        explicit operator bool() const noexcept { return cell_ != nullptr; }
+
+    private:
+        friend class PrometheusMetricsSink;
+        explicit CounterHandle(CounterCell* c) : cell_(c) {}
+        CounterCell* cell_{nullptr};
+    };
+
+    class GaugeHandle {
+    public:
+        GaugeHandle() = default;
+        void set(double value) const noexcept {
+            if (cell_) cell_->value.store(value, std::memory_order_relaxed);
+        }
+        explicit operator bool() const noexcept { return cell_ != nullptr; }
+
+    private:
+        friend class PrometheusMetricsSink;
+        explicit GaugeHandle(GaugeCell* c) : cell_(c) {}
+        GaugeCell* cell_{nullptr};
+    };
+
+    class HistogramHandle {
+    public:
+        HistogramHandle() = default;
+        void observe(double value) const noexcept {
+            if (cell_) observe_histogram_(*cell_, value);
+        }
+        explicit operator bool() const noexcept { return cell_ != nullptr; }
+
+    private:
+        friend class PrometheusMetricsSink;
+        explicit HistogramHandle(HistogramCell* c) : cell_(c) {}
+        HistogramCell* cell_{nullptr};
+    };
+
+    // 注册（或取得已有的）序列并返回句柄；name/labels 的处理与对应的字符串 API 相同。
+    CounterHandle counter(std::string_view name, std::initializer_list<LabelView> labels = {});
+    GaugeHandle gauge(std::string_view name, std::initializer_list<LabelView> labels = {});
+    HistogramHandle histogram(std::string_view name, std::initializer_list<LabelView> labels = {});
+
     void counter_add(std::string_view name, double value, std::initializer_list<LabelView> labels) noexcept override;
     void gauge_set(std::string_view name, double value, std::initializer_list<LabelView> labels) noexcept override;
     void histogram_observe(std::string_view name, double value, std::initializer_list<LabelView> labels) noexcept override;
 
+    // 为 histogram family 指定桶上界（name 为原始指标名，如 "wxz.shm.publish.bytes"）。
+    // 上界会排序去重，超过 kMaxBuckets 的部分截断；为空表示恢复默认布局。
+    // 该 family 已有的序列按新布局重建并清零（对 Prometheus 而言等价于一次计数器重置）；
+    // 旧的计数存储保留到 sink 析构（并发 observe 可能仍在写入），因此不宜频繁调用。
+    void set_histogram_buckets(std::string_view name, std::vector<double> upper_bounds);
+
+    // 为 histogram family 开启分位数（quantiles 取值 (0,1)，为空表示关闭）。
+    // relative_accuracy：DDSketch 相对误差（0.0001..0.1），每个序列固定占用约 ln(1e12)/(2*relative_accuracy) 个计数槽；
+    // 可表示的值域为 [1e-3, 1e9]，之外的值被钳到两端。该 family 已有的序列同样重建并清零。
+    void set_histogram_quantiles(std::string_view name, std::vector<double> quantiles, double relative_accuracy = 0.01);
+
     // 将当前已出现的所有指标渲染为 Prometheus 文本格式。
     std::string render() const;
 
@@ -47,23 +135,70 @@ private:
         }
     };
 
-    struct HistogramState {
-        std::uint64_t count{0};
-        double sum{0.0};
+    class Sketch;
+
+    // family 级配置；每份计数存储持有 shared_ptr，布局变更不影响正在渲染/写入的旧存储。
+    struct HistogramLayout {
+        std::vector<double> bounds;
+        std::vector<double> quantiles;
+        double relative_accuracy{0.0};
+    };
+
+    struct alignas(kCacheLineSize) DoubleShard {
+        std::atomic<double> value{0.0};
+    };
+
+    struct CounterCell {
+        std::array<DoubleShard, kThreadShards> shards{};
+
+        void add(double v) noexcept {
+            auto& a = shards[thread_shard_index()].value;
+            double cur = a.load(std::memory_order_relaxed);
+            while (!a.compare_exchange_weak(cur, cur + v, std::memory_order_relaxed)) {
+            }
+        }
+    };
+
+    struct alignas(kCacheLineSize) GaugeCell {
+        std::atomic<double> value{0.0};
+    };
+
+    // 分片桶计数 + 分片 sum + 可选 sketch（定义见 .cpp）；布局变更时整体替换。
+    struct HistogramData;
+
+    struct HistogramCell {
+        std::atomic<HistogramData*> data{nullptr};
     };
 
     static std::string sanitize_metric_name_(std::string_view in);
-    static std::string render_labels_(std::initializer_list<LabelView> labels);
-    static std::string escape_label_value_(std::string_view v);
+    static void observe_histogram_(HistogramCell& cell, double value) noexcept;
+
+    // 字符串 API：经线程局部驻留键缓存取得单元（未命中时加锁注册）。
+    void* cached_cell_(Type t, std::string_view name, std::initializer_list<LabelView> labels);
+    // 以下需持有 mutex_。
+    void* register_cell_(Type t, const Key& key);
+    std::shared_ptr<const HistogramLayout> layout_for_(const std::string& family) const;
+    HistogramData* new_histogram_data_(std::shared_ptr<const HistogramLayout> layout);
+    void reset_histograms_(const std::string& family);
+
+    // 进程内唯一（不复用），用于区分驻留键缓存中属于已析构 sink 的条目。
+    const std::uint64_t id_;
 
     mutable std::mutex mutex_;
 
+    std::shared_ptr<const HistogramLayout> default_layout_;
+    // 按 sanitize 后的 family 名单独配置的布局。
+    std::unordered_map<std::string, std::shared_ptr<const HistogramLayout>> layouts_;
+
     // 指标 family 类型（按 sanitize 后的 name 归类）。
     std::unordered_map<std::string, Type> types_;
 
-    std::unordered_map<Key, double, KeyHash> counters_;
-    std::unordered_map<Key, double, KeyHash> gauges_;
-    std::unordered_map<Key, HistogramState, KeyHash> histograms_;
+    // unordered_map 的节点地址稳定，句柄与驻留键缓存直接持有单元指针。
+    std::unordered_map<Key, CounterCell, KeyHash> counters_;
+    std::unordered_map<Key, GaugeCell, KeyHash> gauges_;
+    std::unordered_map<Key, HistogramCell, KeyHash> histograms_;
+    // 所有 histogram 计数存储（含布局变更后退役的），sink 析构时释放。
+    std::vector<std::unique_ptr<HistogramData>> histogram_data_;
 };
 
 } // namespace wxz::core
@@ -106,65 +106,43 @@ public:
         return fault_pub_->publish(reinterpret_cast<const std::uint8_t*>(payload.data()), payload.size());
     }
 
+    // 周期任务（timesync 探测、health 文件、capability/heartbeat 发布）：run 执行一次，period 为其周期。
+    struct PeriodicJob {
+        std::chrono::milliseconds period{0};
+        std::function<void()> run;
+    };
+
+    // 把 period>0 的已启用周期任务交给调用方的定时器驱动（例如 Executor::post_every），之后 tick() 不再轮询它们；
+    // period<=0 的任务仍由 tick() 每次执行。须在开始 tick() 之前调用；run 之间不可并发（调用方负责串行化）。
+    std::vector<PeriodicJob> take_periodic_jobs() {
+        std::vector<PeriodicJob> jobs;
+        const auto take = [&](bool enabled, int period_ms, bool& external, void (NodeBase::*fn)()) {
+            if (!enabled || period_ms <= 0 || external) return;
+            external = true;
+            jobs.push_back(PeriodicJob{std::chrono::milliseconds(period_ms), [this, fn] { (this->*fn)(); }});
+        };
+        take(cfg_.timesync_period_ms > 0, cfg_.timesync_period_ms, timesync_external_, &NodeBase::run_timesync);
+        take(!cfg_.health_file.empty(), cfg_.health_period_ms, health_external_, &NodeBase::run_health);
+        take(capability_pub_.has_value(), cfg_.capability_period_ms, capability_external_, &NodeBase::run_capability);
+        take(heartbeat_pub_.has_value(), cfg_.heartbeat_period_ms, heartbeat_external_, &NodeBase::run_heartbeat);
+        return jobs;
+    }
+
+    // 主循环轮询：执行到期且未交给定时器驱动的周期任务。
     void tick() {
         const auto now = clock_steady_now();
 
-        if (cfg_.timesync_period_ms > 0) {
-            if (elapsed_ms(now, last_timesync_) >= cfg_.timesync_period_ms) {
-                const TimeSyncStatus st = probe_timesync();
-                const std::string_view scope = cfg_.timesync_scope.empty() ? std::string_view(cfg_.service)
-                                                                          : std::string_view(cfg_.timesync_scope);
-                publish_timesync_metrics(st, scope);
-                if (!st.synced) {
-                    warn("timesync not synced (source=" + st.source + ")");
-                }
-                last_timesync_ = now;
-            }
+        if (cfg_.timesync_period_ms > 0 && due(now, last_timesync_, cfg_.timesync_period_ms, timesync_external_)) {
+            run_timesync();
         }
-
-        if (!cfg_.health_file.empty()) {
-            if (elapsed_ms(now, last_health_) >= cfg_.health_period_ms) {
-                const bool ok = write_health_file(cfg_.health_file, cfg_.service, true);
-                if (!ok) warn("health file write failed: '" + cfg_.health_file + "'");
-                last_health_ = now;
-            }
+        if (!cfg_.health_file.empty() && due(now, last_health_, cfg_.health_period_ms, health_external_)) {
+            run_health();
         }
-
-        if (capability_pub_) {
-            if (elapsed_ms(now, last_capability_) >= cfg_.capability_period_ms) {
-                CapabilityStatus st;
-                st.service = cfg_.service;
-                st.type = cfg_.type;
-                st.version = cfg_.version;
-                st.api_version = cfg_.api_version;
-                st.schema_version = cfg_.schema_version;
-                st.domain = cfg_.domain;
-                st.ok = true;
-                st.topics_pub = cfg_.topics_pub;
-                st.topics_sub = cfg_.topics_sub;
-                const std::string payload = build_capability_payload(st);
-                const bool ok = capability_pub_->publish(reinterpret_cast<const std::uint8_t*>(payload.data()), payload.size());
-                if (!ok) warn("capability publish failed");
-                last_capability_ = now;
-            }
+        if (capability_pub_ && due(now, last_capability_, cfg_.capability_period_ms, capability_external_)) {
+            run_capability();
         }
-
-        if (heartbeat_pub_) {
-            if (elapsed_ms(now, last_heartbeat_) >= cfg_.heartbeat_period_ms) {
-                HeartbeatDTO hb;
-                hb.version = 1;
-                hb.node = cfg_.service;
-                hb.timestamp = now_epoch_ms();
-                hb.state = 1; // HEALTHY
-                hb.message = cfg_.type;
-
-                std::vector<std::uint8_t> payload;
-                const bool encoded = wxz::dto::encode_heartbeat_dto_cdr(hb, payload, /*initial_reserve=*/512);
-                const bool ok = encoded && !payload.empty() &&
-                                heartbeat_pub_->publish(payload.data(), payload.size());
-                if (!ok) warn("heartbeat publish failed");
-                last_heartbeat_ = now;
-            }
+        if (heartbeat_pub_ && due(now, last_heartbeat_, cfg_.heartbeat_period_ms, heartbeat_external_)) {
+            run_heartbeat();
         }
     }
 
@@ -195,6 +173,58 @@ private:
         if (cfg_.warn) cfg_.warn(msg);
     }
 
+    static bool due(const Clock::time_point& now, Clock::time_point& last, int period_ms, bool external) {
+        if (external || elapsed_ms(now, last) < period_ms) return false;
+        last = now;
+        return true;
+    }
+
+    void run_timesync() {
+        const TimeSyncStatus st = probe_timesync();
+        const std::string_view scope = cfg_.timesync_scope.empty() ? std::string_view(cfg_.service)
+                                                                  : std::string_view(cfg_.timesync_scope);
+        publish_timesync_metrics(st, scope);
+        if (!st.synced) {
+            warn("timesync not synced (source=" + st.source + ")");
+        }
+    }
+
+    void run_health() {
+        const bool ok = write_health_file(cfg_.health_file, cfg_.service, true);
+        if (!ok) warn("health file write failed: '" + cfg_.health_file + "'");
+    }
+
+    void run_capability() {
+        CapabilityStatus st;
+        st.service = cfg_.service;
+        st.type = cfg_.type;
+        st.version = cfg_.version;
+        st.api_version = cfg_.api_version;
+        st.schema_version = cfg_.schema_version;
+        st.domain = cfg_.domain;
+        st.ok = true;
+        st.topics_pub = cfg_.topics_pub;
+        st.topics_sub = cfg_.topics_sub;
+        const std::string payload = build_capability_payload(st);
+        const bool ok = capability_pub_->publish(reinterpret_cast<const std::uint8_t*>(payload.data()), payload.size());
+        if (!ok) warn("capability publish failed");
+    }
+
+    void run_heartbeat() {
+        HeartbeatDTO hb;
+        hb.version = 1;
+        hb.node = cfg_.service;
+        hb.timestamp = now_epoch_ms();
+        hb.state = 1; // HEALTHY
+        hb.message = cfg_.type;
+
+        std::vector<std::uint8_t> payload;
+        const bool encoded = wxz::dto::encode_heartbeat_dto_cdr(hb, payload, /*initial_reserve=*/512);
+        const bool ok = encoded && !payload.empty() &&
+                        heartbeat_pub_->publish(payload.data(), payload.size());
+        if (!ok) warn("heartbeat publish failed");
+    }
+
     NodeBaseConfig cfg_;
     std::atomic<bool> running_{true};
 
@@ -202,6 +232,11 @@ private:
     Clock::time_point last_capability_;
     Clock::time_point last_heartbeat_;
     Clock::time_point last_timesync_;
+    // 已交给外部定时器驱动（take_periodic_jobs），tick() 跳过。
+    bool timesync_external_{false};
+    bool health_external_{false};
+    bool capability_external_{false};
+    bool heartbeat_external_{false};
 
     std::optional<FastddsChannel> capability_pub_;
     std::optional<FastddsChannel> fault_pub_;
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace wxz::core {
+
+// 缓存行大小（用于 alignas 隔离热字段，避免伪共享）。
+// 不直接用 std::hardware_destructive_interference_size：它随编译选项变化，放进公共头文件会带来 ABI 不一致（GCC 会告警）。
+inline constexpr std::size_t kCacheLineSize = 64;
+
+// 按线程分片的统计结构（ShardedCounter、PrometheusMetricsSink 的 counter/histogram 单元）共用的分片数与分片号。
+inline constexpr std::size_t kThreadShards = 8;
+
+// 线程首次使用时轮转分配分片号；线程数超过分片数时多个线程共享一个分片（仍正确，只是退化为共享写）。
+inline std::size_t thread_shard_index() noexcept {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t idx = next.fetch_add(1, std::memory_order_relaxed) & (kThreadShards - 1);
+    return idx;
+}
+
+// 分片统计计数器：写端按线程分散到不同缓存行的分片上，读端汇总。
+// - 适用于多线程高频递增、低频读取的统计量（publish_success/messages_delivered 等）。
+// - load() 只是各分片之和的快照，不与其它计数器构成一致视图。
+class ShardedCounter {
+public:
+    ShardedCounter() = default;
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    void add(std::uint64_t n) noexcept { shards_[thread_shard_index()].value.fetch_add(n, std::memory_order_relaxed); }
+    void operator++() noexcept { add(1); }
+
+    std::uint64_t load() const noexcept {
+        std::uint64_t sum = 0;
+        for (const auto& s : shards_) sum += s.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
+private:
+    struct alignas(kCacheLineSize) Shard {
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::array<Shard, kThreadShards> shards_{};
+};
+
+} // namespace wxz::core
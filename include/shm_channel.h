@@ -11,56 +11,226 @@
 #include <thread>
 #include <vector>
 
+#include "sharded_counter.h"
 #include "subscription.h"
 
 namespace wxz::core {
 
-// 同机共享内存通道（偏 SPSC 场景），使用命名 POSIX shm + 命名信号量进行通知。
-// 每个 slot 存储 length(uint32) + payload 字节；写端每条消息 post 一次信号量。
+// 同机共享内存通道，使用命名 POSIX shm；通知默认走 header 内的 futex 字，可回退到信号量。
+// 数据区是字节环：每条消息是一条 64 字节对齐、带长度前缀的变长记录（记录头 + payload）；
+// 环尾放不下时先写一条 padding 记录补齐，再从环首继续。超过 max_message 的消息直接拒绝并计数，不做截断。
+//
+// 两种模式（由创建方决定，写入 shm header；附加方沿用 header 中的设置）：
+// - queue（默认）：共享消费游标，多个附加进程之间“分摊”消息（每条消息只被一个读端消费）；写满时 publish 失败。
+// - broadcast：每个读端在 header 的读者表里持有独立游标，一次写入服务所有本机读端；
+//   写端从不等待慢读端，读端据 head 判定自己是否被覆盖（计入 lapped，并跳到最新一条已提交消息）。
+// multi_producer=true 时写端通过 CAS 预留空间，允许多个进程/线程同时 publish。
 class ShmChannel {
 public:
     using Handler = std::function<void(const std::uint8_t* data, std::size_t size)>;
 
+    // 批量交付：只读视图，仅在回调期间有效。queue 模式指向 shm 记录本身（回调结束前该记录不会被复用）；
+    // broadcast 模式指向读端本地副本（写端随时可能覆盖环内存，拷贝后校验通过的消息才会交付）。
+    struct Message {
+        const std::uint8_t* data{nullptr};
+        std::size_t size{0};
+    };
+    // 一次唤醒内排空的整批消息（msgs[0..count)），便于消费方对突发做向量化处理。
+    using BatchHandler = std::function<void(const Message* msgs, std::size_t count)>;
+
+    enum class Mode : std::uint32_t {
+        queue = 0,
+        broadcast = 1,
+    };
+
+    // 通知方式（由创建方决定）：
+    // - futex：读端先自旋再 park 在 header 的 futex 字上；写端只在有读端 park 时才发 FUTEX_WAKE。
+    // - semaphore：旧路径，写端每条消息 sem_post 一次（排障/兼容用）。
+    enum class Notify : std::uint32_t {
+        futex = 0,
+        semaphore = 1,
+    };
+
+    struct Options {
+        Mode mode{Mode::queue};
+        // 读者表容量（同时订阅的读端数上限，含已退出但尚未回收的条目）。
+        std::size_t max_readers{16};
+        bool multi_producer{false};
+        Notify notify{Notify::futex};
+        // futex 模式下读端 park 前的自旋轮数上限（本地设置，附加方同样生效）；0 表示直接 park。
+        // 实际轮数自适应：自旋命中时保持上限，连续 park 时逐步减半；单核机器上自动禁用自旋。
+        std::uint32_t spin_iterations{512};
+        // 每次唤醒最多排空的消息数（本地设置）。
+        std::size_t max_batch{64};
+        // 字节环大小（向上对齐到 64）；0 表示按 capacity 条 slot_size 大小的消息估算（与旧 slot 布局占用相同）。
+        std::size_t ring_bytes{0};
+        // 单条消息上限；0 表示环大小的一半扣除记录头。必须保证空环时能放下一条最大消息。
+        std::size_t max_message{0};
+    };
+
+    // 写端原地填充：reserve() 预留空间，写入 data() 后 commit(n)，再 publish(std::move(r))。
+    // - 未发布即析构时，该记录以 padding 提交（读端跳过），不会卡住后续消息。
+    // - 预留期间读端会停在该记录前等待，应尽快发布；reservation 不能比 channel 活得久。
+    // - broadcast 模式下若预留期间已被其他写端整圈覆盖，publish 返回 false（计入 publish_fail 与
+    //   wxz.shm.publish.lapped），不会改写覆盖它的新记录。
+    class Reservation {
+    public:
+        Reservation() = default;
+        Reservation(Reservation&& other) noexcept { move_from(std::move(other)); }
+        Reservation& operator=(Reservation&& other) noexcept {
+            if (this != &other) {
+                release();
+                move_from(std::move(other));
+            }
+            return *this;
+        }
+        Reservation(const Reservation&) = delete;
+        Reservation& operator=(const Reservation&) = delete;
+        ~Reservation() { release(); }
+
+        std::uint8_t* data() { return data_; }
+        const std::uint8_t* data() const { return data_; }
+        std::size_t capacity() const { return capacity_; }
+        std::size_t size() const { return size_; }
+        void commit(std::size_t size) { size_ = size; }
+        bool valid() const { return channel_ != nullptr; }
+
+    private:
+        friend class ShmChannel;
+
+        ShmChannel* channel_{nullptr};
+        std::uint64_t pos_{0};
+        std::uint8_t* data_{nullptr};
+        std::size_t capacity_{0};
+        std::size_t size_{0};
+
+        void release();
+        void move_from(Reservation&& other) {
+            channel_ = other.channel_;
+            pos_ = other.pos_;
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            size_ = other.size_;
+            other.channel_ = nullptr;
+            other.pos_ = 0;
+            other.data_ = nullptr;
+            other.capacity_ = 0;
+            other.size_ = 0;
+        }
+    };
+
     // name：POSIX shm 对象名（会确保前缀 '/';）。
-    // capacity：slot 数量（建议为 2 的幂）。
-    // slot_size：每个 slot 的字节数（可用 payload 字节 = slot_size - sizeof(uint32_t)）。
-    // create：true 表示创建/截断并初始化区域；false 表示附加到已有区域。
+    // capacity/slot_size：未指定 Options::ring_bytes 时用于估算字节环大小（capacity 条 slot_size 字节的消息）。
+    // create：true 表示创建/截断并初始化区域；false 表示附加到已有区域（布局参数以 header 为准）。
     ShmChannel(std::string name, std::size_t capacity, std::size_t slot_size, bool create);
+    ShmChannel(std::string name, std::size_t capacity, std::size_t slot_size, bool create, const Options& opts);
     ~ShmChannel();
 
+    // size > max_message() 时拒绝（计入 publish_oversize 与 publish_fail），不截断。
     bool publish(const std::uint8_t* data, std::size_t size);
 
+    // 预留 size 字节的记录；超限或空间不足（queue 模式）时返回 invalid reservation（同样计入 publish_fail）。
+    Reservation reserve(std::size_t size);
+    // 发布 reservation（长度取 commit() 的值，不能超过预留容量）；无论成功与否 reservation 都会被消费。
+    bool publish(Reservation&& r);
+
+    // broadcast 模式下每个订阅的 ShmChannel 实例占用读者表中的一个条目；表满时抛出 std::runtime_error。
     void subscribe(Handler handler);
 
     // 带作用域的订阅（可显式取消）。
     // owner 为可选 tag（例如插件实例指针），用于批量清理。
     Subscription subscribe_scoped(Handler handler, void* owner = nullptr);
 
+    // 批量订阅：每批调用一次；可与逐条 handler 混用（同一批先逐条、后整批）。
+    void subscribe_batch(BatchHandler handler);
+    Subscription subscribe_batch_scoped(BatchHandler handler, void* owner = nullptr);
+
     // 批量取消：移除所有带指定 owner tag 的 handler。
     void unsubscribe_owner(void* owner);
 
     void stop();
 
+    Mode mode() const;
+    Notify notify_mode() const;
+    std::size_t max_message() const;
+
     // 可观测性
     std::uint64_t publish_success() const { return publish_success_.load(); }
     std::uint64_t publish_fail() const { return publish_fail_.load(); }
+    std::uint64_t publish_oversize() const { return publish_oversize_.load(); }
     std::uint64_t messages_delivered() const { return messages_delivered_.load(); }
+    // broadcast：本读端被覆盖的次数（每次跳读计 1；拷贝期间被覆盖的消息逐条丢弃并计数，不交付给 handler）。
+    std::uint64_t messages_lapped() const { return messages_lapped_.load(); }
+
+    // broadcast：当前活跃读端数，以及最慢读端落后写端的字节数（诊断用，线性扫描读者表）。
+    std::size_t reader_count() const;
+    std::uint64_t slowest_reader_lag() const;
 
 private:
+    // 各字段按写入方分居不同缓存行（跨进程伪共享的代价同样是缓存行来回迁移）：
+    // - 首行：创建后只读的布局参数；
+    // - head/notify_seq：写端每条消息都写；
+    // - tail/reclaim：queue 读端每条消息都写（broadcast 下 tail 由写端写，同样与 head 分开）；
+    // - waiters：读端 park/唤醒时才写，写端每次 publish 都读，单独一行避免被上面两组拖累。
     struct Header {
-        std::atomic<std::uint32_t> head;
-        std::atomic<std::uint32_t> tail;
-        std::uint32_t capacity;
-        std::uint32_t slot_size;
         std::uint32_t magic;
+        std::uint32_t mode;
+        std::uint32_t flags;
+        std::uint32_t max_readers;
+        std::uint64_t ring_bytes;
+        std::uint64_t max_message;
+        // 下一个待预留的字节位置（单调递增，不取模；始终落在记录边界上）。读端只看 head。
+        alignas(kCacheLineSize) std::atomic<std::uint64_t> head;
+        // 多写端的认领游标：写端先 CAS reserve 认领区域，把记录头置为未提交后再按认领顺序推进 head；
+        // 单写端不使用（直接推进 head）。
+        std::atomic<std::uint64_t> reserve;
+        // futex 通知：notify_seq 为 futex 字（每次提交 +1）；waiters 为当前 park 的读端数。
+        std::atomic<std::uint32_t> notify_seq;
+        // queue：共享消费游标；broadcast：最新一条已提交消息的起始位置（读端被覆盖后的跳读目标）。
+        alignas(kCacheLineSize) std::atomic<std::uint64_t> tail;
+        // queue：已消费完毕、写端可以复用的边界。
+        std::atomic<std::uint64_t> reclaim;
+        alignas(kCacheLineSize) std::atomic<std::uint32_t> waiters;
     };
 
-    struct SlotView {
-        std::uint8_t* ptr{nullptr};
-        std::size_t bytes{0};
+    // 读者表条目（broadcast）。sem 为进程间共享的匿名信号量（pshared=1），仅 semaphore 通知模式下写端逐个 post。
+    // 每个条目独占缓存行：各读端推进自己的 cursor 时不影响相邻读端。
+    struct alignas(kCacheLineSize) ReaderEntry {
+        std::atomic<std::uint32_t> state;
+        std::atomic<std::int32_t> pid;
+        std::atomic<std::uint64_t> cursor;
+        std::atomic<std::uint64_t> lapped;
+        sem_t sem;
     };
 
-    SlotView slot(std::uint32_t idx) const;
+    // 记录头（位于字节位置 pos，64 字节对齐）：
+    // - seq：2*pos 已预留未提交（写端在写入 bytes 之前先置此值）；2*pos+1 已提交；2*pos+2 已消费（仅 queue）。
+    //   其余值表示该位置尚未预留本圈记录。
+    // - len：payload 字节数；kPadLen 表示 padding 或被放弃的预留（读端跳过）。
+    // - bytes：整条记录占用的字节数（含记录头，64 的倍数），预留时确定。
+    struct RecordHeader {
+        std::atomic<std::uint64_t> seq;
+        std::uint32_t len;
+        std::uint32_t bytes;
+    };
+
+    RecordHeader* record(std::uint64_t pos) const;
+    ReaderEntry* reader_entry(std::size_t i) const;
+    void invalidate_records(std::uint64_t pos, std::uint64_t pad);
+    bool reserve_record(std::size_t size, std::uint64_t& pos);
+    bool commit_record(std::uint64_t pos, std::uint32_t len);
+    void drop_lapped_commit(std::uint32_t len);
+    void reclaim_consumed();
+    bool reject_oversize(std::size_t size);
+    void count_publish(bool ok, std::size_t size);
+    void register_reader();
+    void unregister_reader();
+    void notify();
+    bool has_pending() const;
+    bool wait_signal();
+    void dispatch_queue();
+    void dispatch_broadcast();
+    void deliver_batch();
     void dispatch_loop();
     static std::string normalize_name(const std::string& n);
     static std::string sem_name_from(const std::string& n);
@@ -71,24 +241,50 @@ private:
     sem_t* sem_{nullptr};
     Header* hdr_{nullptr};
     std::uint8_t* base_{nullptr};
+    std::uint8_t* readers_base_{nullptr};
+    std::uint8_t* ring_base_{nullptr};
     std::size_t region_bytes_{0};
     bool owner_{false};
 
+    // broadcast：本实例在读者表中的条目与本地游标（仅 dispatch 线程访问 cursor_）。
+    ReaderEntry* reader_{nullptr};
+    std::uint64_t cursor_{0};
+
+    // futex 模式的自适应自旋（仅 dispatch 线程访问）。
+    std::uint32_t spin_max_{0};
+    std::uint32_t spin_limit_{0};
+
+    // 批量排空的复用缓冲（仅 dispatch 线程访问，预分配 max_batch_）。
+    // positions_：queue 为本批认领的全部记录（含 padding）；broadcast 与 batch_ 一一对应。
+    std::size_t max_batch_{1};
+    std::vector<Message> batch_;
+    std::vector<std::uint64_t> positions_;
+    // broadcast：本批消息的本地副本（按需增长后复用）。
+    std::vector<std::uint8_t> copy_buf_;
+
     struct HandlerEntry {
         std::uint64_t id{0};
         void* owner{nullptr};
         Handler handler;
+        BatchHandler batch_handler;
     };
 
-    std::vector<HandlerEntry> handlers_;
+    Subscription add_handler(HandlerEntry entry);
+    void remove_handlers(const std::function<bool(const HandlerEntry&)>& pred);
+
+    // copy-on-write：订阅变更时整体替换，dispatch 线程每批只复制一次 shared_ptr。
+    std::shared_ptr<const std::vector<HandlerEntry>> handlers_{std::make_shared<std::vector<HandlerEntry>>()};
     std::uint64_t next_handler_id_{1};
     std::mutex handler_mutex_;
     std::atomic<bool> running_{false};
     std::thread worker_;
 
-    std::atomic<std::uint64_t> publish_success_{0};
-    std::atomic<std::uint64_t> publish_fail_{0};
-    std::atomic<std::uint64_t> messages_delivered_{0};
+    // 热路径统计按线程分片（多写端同时 publish 时不争同一缓存行）；低频计数保持单个 atomic。
+    ShardedCounter publish_success_;
+    ShardedCounter publish_fail_;
+    ShardedCounter messages_delivered_;
+    std::atomic<std::uint64_t> publish_oversize_{0};
+    std::atomic<std::uint64_t> messages_lapped_{0};
 };
 
 } // namespace wxz::core
@@ -1,92 +1,245 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
-#include <deque>
-#include <functional>
-#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
 #include <utility>
 
 #include "executor.h"
 #include "observability.h"
+#include "sharded_counter.h"
+#include "task_instrumentation.h"
 
 namespace wxz::core {
 
 // Strand：基于底层 Executor 将任务串行化执行。
 // 通过同一个 Strand 投递的任务保证按 FIFO 顺序执行。
+// - 任务队列为侵入式 Vyukov MPSC 链表：post 只做一次原子 exchange，不加锁；同一时刻只有一个 drain 在消费。
+// - scheduled_ 原子状态：false->true 的那次 post 负责向 Executor 投递 drain。
+// - 每次 drain 最多执行 quantum 个任务，仍有积压时重新投递到 Executor 尾部，避免单个热点 strand 长期占住工作线程。
+// - 队列节点取自构造时预分配的节点池（空闲链表为带版本号的 Treiber 栈，与 BufferPool 相同）：排队任务不超过
+//   node_cache 个时 post 本身不分配内存（任务对象超出 MoveOnlyFunction 内联缓冲时仍会分配）；池取空时退回堆分配。
 class Strand {
 public:
-    explicit Strand(Executor& ex) : ex_(&ex) {}
+    struct Options {
+        // 单次 drain 最多执行的任务数（0 表示不限，一直执行到队列为空）。
+        std::size_t quantum{64};
+        // drain 投递到执行器的哪个 lane（见 Executor::Lane）。
+        Executor::Lane lane{Executor::Lane::normal};
+        // 采样埋点标签（wxz.strand.*{strand}）；采样比例沿用所属 Executor 的 sample_every。
+        std::string name{"strand"};
+        // 预分配的队列节点数（每个约 200 字节）；0 表示每次 post 都在堆上分配节点。
+        std::size_t node_cache{64};
+    };
+
+    explicit Strand(Executor& ex) : Strand(ex, Options{}) {}
+    Strand(Executor& ex, Options opts)
+        : ex_(&ex),
+          quantum_(opts.quantum),
+          lane_(opts.lane),
+          name_(std::move(opts.name)),
+          node_cache_(std::min<std::size_t>(opts.node_cache, kFreeNil)),
+          nodes_(node_cache_ > 0 ? new Node[node_cache_] : nullptr),
+          free_head_(pack_free_head(node_cache_ > 0 ? 0 : kFreeNil, 0)) {
+        for (std::size_t i = 0; i < node_cache_; ++i) {
+            nodes_[i].slot = static_cast<std::uint32_t>(i);
+            nodes_[i].free_next.store(i + 1 < node_cache_ ? static_cast<std::uint32_t>(i + 1) : kFreeNil,
+                                      std::memory_order_relaxed);
+        }
+    }
     Strand(const Strand&) = delete;
     Strand& operator=(const Strand&) = delete;
 
+    ~Strand() {
+        while (Node* n = pop()) free_node(n);
+    }
+
     template <class F>
     bool post(F&& fn) {
-        MoveOnlyFunction task(std::forward<F>(fn));
-        if (!task) return true;
+        return post_tagged(nullptr, std::forward<F>(fn));
+    }
+
+    // 带调用点标签的 post（tag 须为字符串字面量），用于长任务定位。
+    template <class F>
+    bool post_tagged(const char* tag, F&& fn) {
         if (stopped_.load()) {
-            if (wxz::core::has_metrics_sink()) {
-                wxz::core::metrics().counter_add("wxz.strand.post.reject", 1, {{"reason", "stopped"}});
-            }
+            count_reject("stopped");
             return false;
         }
-
-        bool need_schedule = false;
-        {
-            std::lock_guard<std::mutex> lock(mu_);
-            if (stopped_.load()) {
-                if (wxz::core::has_metrics_sink()) {
-                    wxz::core::metrics().counter_add("wxz.strand.post.reject", 1, {{"reason", "stopped"}});
-                }
-                return false;
-            }
-            q_.push_back(std::move(task));
-            if (!scheduled_) {
-                scheduled_ = true;
-                need_schedule = true;
-            }
+        MoveOnlyFunction task(std::forward<F>(fn));
+        if (!task) return true;
+        if (sample_task(ex_->sample_every())) {
+            task = instrument_task(std::move(task), TaskScope::strand, name_, tag, ex_->long_task_threshold());
         }
 
-        if (need_schedule) {
-            const bool ok = ex_->post([this] { drain(); });
-            if (!ok) {
-                if (wxz::core::has_metrics_sink()) {
-                    wxz::core::metrics().counter_add("wxz.strand.post.reject", 1, {{"reason", "executor_rejected"}});
-                }
-            }
-            return ok;
-        }
-        return true;
+        push(alloc_node(std::move(task)));
+        if (scheduled_.exchange(true)) return true;
+
+        if (ex_->post(lane_, [this] { drain(); })) return true;
+        // Executor 拒绝：任务保留在队列里，清除调度标记，由后续 post 重试调度。
+        scheduled_.store(false);
+        count_reject("executor_rejected");
+        return false;
     }
 
+    // 底层执行器（用于把延时/周期任务挂到同一执行器上，再经 strand 串行执行）。
+    Executor& executor() const { return *ex_; }
+    const std::string& name() const { return name_; }
+
+    // 停止接收新任务并丢弃排队任务（不执行）；正在执行的 drain 会丢弃剩余任务后退出。
     void stop() {
         stopped_.store(true);
-        std::lock_guard<std::mutex> lock(mu_);
-        q_.clear();
+        if (scheduled_.exchange(true)) return;
+        while (Node* n = pop()) free_node(n);
+        scheduled_.store(false);
     }
 
 private:
+    // 空闲链表头：低 32 位为节点池下标，高 32 位为版本号（每次成功修改 +1，避免 ABA）。
+    static constexpr std::uint32_t kFreeNil = 0xFFFFFFFFu;
+
+    static constexpr std::uint64_t pack_free_head(std::uint32_t idx, std::uint32_t tag) {
+        return (static_cast<std::uint64_t>(tag) << 32) | idx;
+    }
+    static constexpr std::uint32_t free_head_index(std::uint64_t head) { return static_cast<std::uint32_t>(head); }
+    static constexpr std::uint32_t free_head_tag(std::uint64_t head) { return static_cast<std::uint32_t>(head >> 32); }
+
+    struct Node {
+        Node() = default;
+        explicit Node(MoveOnlyFunction&& f) : fn(std::move(f)) {}
+        std::atomic<Node*> next{nullptr};
+        MoveOnlyFunction fn;
+        // 节点池下标；kFreeNil 表示堆上分配的节点（以及 stub_）。
+        std::uint32_t slot{kFreeNil};
+        // 空闲链表中的后继下标（仅池节点使用）。
+        std::atomic<std::uint32_t> free_next{kFreeNil};
+    };
+
+    // 多生产者从空闲链表取节点；池取空时退回堆分配。
+    Node* alloc_node(MoveOnlyFunction&& task) {
+        std::uint64_t head = free_head_.load(std::memory_order_acquire);
+        while (free_head_index(head) != kFreeNil) {
+            Node& n = nodes_[free_head_index(head)];
+            // free_next 可能已被并发的取/还改写（读到的是旧值）；此时版本号必然已变，CAS 失败重试。
+            const std::uint32_t next = n.free_next.load(std::memory_order_relaxed);
+            if (free_head_.compare_exchange_weak(head,
+                                                 pack_free_head(next, free_head_tag(head) + 1),
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+                n.fn = std::move(task);
+                return &n;
+            }
+        }
+        return new Node(std::move(task));
+    }
+
+    // 消费者（drain/stop/析构）归还节点：先销毁任务对象，池节点压回空闲链表。
+    void free_node(Node* n) {
+        if (n->slot == kFreeNil) {
+            delete n;
+            return;
+        }
+        n->fn.reset();
+        std::uint64_t head = free_head_.load(std::memory_order_acquire);
+        std::uint64_t desired = 0;
+        do {
+            n->free_next.store(free_head_index(head), std::memory_order_relaxed);
+            desired = pack_free_head(n->slot, free_head_tag(head) + 1);
+        } while (!free_head_.compare_exchange_weak(head, desired, std::memory_order_acq_rel, std::memory_order_acquire));
+    }
+
+    static void count_reject(const char* reason) {
+        if (wxz::core::has_metrics_sink()) {
+            wxz::core::metrics().counter_add("wxz.strand.post.reject", 1, {{"reason", reason}});
+        }
+    }
+
+    // 多生产者入队。
+    void push(Node* n) {
+        n->next.store(nullptr, std::memory_order_relaxed);
+        Node* prev = head_.exchange(n);
+        prev->next.store(n, std::memory_order_release);
+    }
+
+    // 单消费者出队（仅持有 scheduled_ 的一方调用）。
+    // 返回 nullptr 表示队列为空，或有生产者已 exchange head_ 但尚未链上 next（见 empty()）。
+    Node* pop() {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (!next) return nullptr;
+            tail_ = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail_ = next;
+            return tail;
+        }
+        if (tail != head_.load()) return nullptr;
+        push(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    // 消费者侧判空（仅持有 scheduled_ 的一方调用）：包括生产者 exchange 了 head_ 但尚未链入的中间态。
+    bool empty() const {
+        return tail_ == &stub_ && stub_.next.load(std::memory_order_acquire) == nullptr && head_.load() == &stub_;
+    }
+
     void drain() {
+        std::size_t n = 0;
         for (;;) {
-            MoveOnlyFunction task;
-            {
-                std::lock_guard<std::mutex> lock(mu_);
-                if (q_.empty()) {
-                    scheduled_ = false;
-                    return;
+            if (quantum_ > 0 && n >= quantum_ && !empty()) {
+                // 让出工作线程：重投到 Executor 尾部。队列满/正在停止时不等待，继续就地执行。
+                if (ex_->try_post(lane_, [this] { drain(); })) return;
+                n = 0;
+            }
+
+            Node* node = pop();
+            if (!node) {
+                if (!empty()) {
+                    // 生产者正在链入：稍后重试（通常只差一条 store）。
+                    std::this_thread::yield();
+                    continue;
                 }
-                task = std::move(q_.front());
-                q_.pop_front();
+                scheduled_.store(false);
+                // 释放时队列为空（head_==&stub_），之后任何入队都会改变 head_，因此这里只读 head_，不碰 tail_。
+                // 新任务的 post 若未抢到调度权，则由本 drain 重新取得后继续处理。
+                if (head_.load() == &stub_ || scheduled_.exchange(true)) return;
+                continue;
             }
 
-            task();
+            if (!stopped_.load(std::memory_order_relaxed)) node->fn();
+            free_node(node);
+            ++n;
         }
     }
 
     Executor* ex_{nullptr};
-    std::mutex mu_;
-    std::deque<MoveOnlyFunction> q_;
-    bool scheduled_{false};
+    std::size_t quantum_{64};
+    Executor::Lane lane_{Executor::Lane::normal};
+    std::string name_;
     std::atomic<bool> stopped_{false};
+
+    const std::size_t node_cache_;
+    std::unique_ptr<Node[]> nodes_;
+    // 生产者（取）与消费者（还）都会写，单独一行。
+    alignas(kCacheLineSize) std::atomic<std::uint64_t> free_head_;
+
+    // 生产者端（post 线程写）与消费者端（drain 线程写）分处不同缓存行。
+    alignas(kCacheLineSize) std::atomic<Node*> head_{&stub_};
+    std::atomic<bool> scheduled_{false};
+    alignas(kCacheLineSize) Node* tail_{&stub_};
+    Node stub_;
 };
 
 } // namespace wxz::core
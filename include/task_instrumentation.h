@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "move_only_function.h"
+
+namespace wxz::core {
+
+// Executor/Strand 的采样埋点。
+// - 采样在 post 时决定：被采样的任务包一层记录入队时刻的 wrapper（仅被采样任务多一次分配），
+//   执行时上报排队等待与运行时间直方图；未采样任务零额外开销（只有一次计数与分支）。
+// - sample_every==0 时完全关闭；定义 WXZ_NO_TASK_INSTRUMENTATION（CMake: WXZ_TASK_INSTRUMENTATION=OFF）时编译期移除。
+enum class TaskScope {
+    executor,
+    strand,
+};
+
+// 是否采样本次 post（每线程计数，所有执行器/strand 共用；只影响采样比例，不要求精确）。
+inline bool sample_task(std::uint32_t every) noexcept {
+#if defined(WXZ_NO_TASK_INSTRUMENTATION)
+    (void)every;
+    return false;
+#else
+    if (every == 0) return false;
+    static thread_local std::uint32_t tick = 0;
+    return ++tick % every == 0;
+#endif
+}
+
+// 包装一个被采样的任务。name 为执行器/strand 名（须在任务执行前保持有效）；
+// tag 为调用点标签（字符串字面量，可为空）；long_task>0 时运行超过阈值上报长任务。
+// lane 非空时（执行器的 lane 名，字符串字面量）另外按 lane 上报 wxz.executor.lane.queue_wait_us{lane}。
+MoveOnlyFunction instrument_task(MoveOnlyFunction&& task,
+                                 TaskScope scope,
+                                 const std::string& name,
+                                 const char* tag,
+                                 std::chrono::microseconds long_task,
+                                 const char* lane = nullptr);
+
+} // namespace wxz::core
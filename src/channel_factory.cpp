@@ -6,6 +6,7 @@ namespace channel_factory {
 
 namespace {
 constexpr std::size_t kMaxPayloadGuard = 1 * 1024 * 1024; // 1MB upper bound
+constexpr std::size_t kMaxLargePayloadGuard = 64 * 1024 * 1024; // large_data channels (not preallocated)
 constexpr std::size_t kMaxHistoryGuard = 1024;             // depth upper bound
 
 ChannelQoS guardrail_qos(ChannelQoS qos, const std::string& name) {
@@ -16,10 +17,11 @@ ChannelQoS guardrail_qos(ChannelQoS qos, const std::string& name) {
     return qos;
 }
 
-bool guardrail_payload(std::size_t payload, const std::string& name) {
-    if (payload > kMaxPayloadGuard) {
+bool guardrail_payload(std::size_t payload, const std::string& name, bool large_data = false) {
+    const std::size_t guard = large_data ? kMaxLargePayloadGuard : kMaxPayloadGuard;
+    if (payload > guard) {
         std::cerr << "[channel_factory] reject channel " << name << " max_payload " << payload
-                  << " exceeds guard " << kMaxPayloadGuard << "\n";
+                  << " exceeds guard " << guard << "\n";
         return false;
     }
     return true;
@@ -55,12 +57,12 @@ build_fastdds_channels_from_config(const Config& cfg) {
             std::cerr << "[channel_factory] skip fastdds channel without topic: " << c.name << "\n";
             continue;
         }
-        if (!guardrail_payload(c.max_payload, c.name)) continue;
+        if (!guardrail_payload(c.max_payload, c.name, c.qos.large_data)) continue;
         ChannelQoS qos = c.qos;
-        if (cfg.isRealtimeMode() && !qos.realtime_hint) {
-            qos = ChannelQoS::realtime_preset(qos.history == 0 ? 8 : qos.history);
-            if (qos.deadline_ns == 0) qos.deadline_ns = 2'000'000; // tighten default deadline in realtime
-            if (qos.latency_budget_ns == 0) qos.latency_budget_ns = 1'000'000;
+        // 大数据 channel 不套用 realtime 预设：同步发布会让流控失效，整帧发送也谈不上实时。
+        if (cfg.isRealtimeMode() && !qos.realtime_hint && !qos.large_data) {
+            // 只叠加实时相关字段；key、过滤、接收线程与 data-sharing 等保持配置值。
+            qos.apply_realtime_preset(qos.history == 0 ? 8 : qos.history);
         }
         qos = guardrail_qos(qos, c.name);
         try {
@@ -85,15 +87,31 @@ build_shm_channels_from_config(const Config& cfg, bool create) {
             std::cerr << "[channel_factory] skip shm channel without shm.name: " << c.name << "\n";
             continue;
         }
-        if (c.shm_capacity == 0 || c.shm_slot_size == 0) {
+        if (c.shm_ring_bytes == 0 && (c.shm_capacity == 0 || c.shm_slot_size == 0)) {
             std::cerr << "[channel_factory] skip shm channel with invalid capacity/slot_size: " << c.name << "\n";
             continue;
         }
 
-        // 保护阈值（复用 payload guard 作为 slot_size 上限）
-        if (!guardrail_payload(c.shm_slot_size, c.name)) continue;
+        // 保护阈值（复用 payload guard 作为单条消息上限）
+        if (c.shm_slot_size != 0 && !guardrail_payload(c.shm_slot_size, c.name)) continue;
+        if (c.shm_max_message != 0 && !guardrail_payload(c.shm_max_message, c.name)) continue;
+        wxz::core::ShmChannel::Options opts;
+        if (c.shm_mode == "broadcast") {
+            opts.mode = wxz::core::ShmChannel::Mode::broadcast;
+        } else if (c.shm_mode != "queue") {
+            std::cerr << "[channel_factory] unknown shm.mode '" << c.shm_mode << "', fallback to queue: " << c.name << "\n";
+        }
+        if (c.shm_max_readers > 0) opts.max_readers = c.shm_max_readers;
+        opts.multi_producer = c.shm_multi_producer;
+        opts.ring_bytes = c.shm_ring_bytes;
+        opts.max_message = c.shm_max_message;
+        if (c.shm_notify == "semaphore") {
+            opts.notify = wxz::core::ShmChannel::Notify::semaphore;
+        } else if (c.shm_notify != "futex") {
+            std::cerr << "[channel_factory] unknown shm.notify '" << c.shm_notify << "', fallback to futex: " << c.name << "\n";
+        }
         try {
-            auto ch = std::make_shared<wxz::core::ShmChannel>(c.shm_name, c.shm_capacity, c.shm_slot_size, create);
+            auto ch = std::make_shared<wxz::core::ShmChannel>(c.shm_name, c.shm_capacity, c.shm_slot_size, create, opts);
             out.emplace(c.name, std::move(ch));
         } catch (const std::exception& ex) {
             std::cerr << "[channel_factory] failed to create shm channel " << c.name << ": " << ex.what() << "\n";
@@ -1,4 +1,5 @@
 #include "internal/config.h"
+#include "internal/thread_policy.h"
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
@@ -40,6 +41,37 @@ Config::Config() {
                         if (n > 0) thread_counts_[module] = n;
                     } catch (...) {}
                 }
+                if (!node || !node.IsMap()) continue;
+                ThreadPolicyConfig pc;
+                bool any = false;
+                try {
+                    if (node["cpus"]) {
+                        if (node["cpus"].IsSequence()) {
+                            for (const auto& c : node["cpus"]) pc.cpus.push_back(c.as<int>());
+                        } else {
+                            pc.cpus = wxz::core::internal::parse_cpu_list(node["cpus"].as<std::string>());
+                        }
+                        any = true;
+                    }
+                    if (node["numa_node"]) {
+                        pc.numa_node = node["numa_node"].as<int>();
+                        any = true;
+                    }
+                    if (node["sched"]) {
+                        pc.sched = node["sched"].as<std::string>();
+                        std::transform(pc.sched.begin(), pc.sched.end(), pc.sched.begin(), ::tolower);
+                        any = true;
+                    }
+                    if (node["priority"]) {
+                        pc.priority = node["priority"].as<int>();
+                        any = true;
+                    }
+                    if (node["name"]) {
+                        pc.name = node["name"].as<std::string>();
+                        any = true;
+                    }
+                } catch (...) {}
+                if (any) thread_policies_[module] = std::move(pc);
             }
         }
         if (doc && doc["comm"]) {
@@ -247,11 +279,23 @@ Config::Config() {
                 //       name: /wxz_camera_req
                 //       capacity: 64
                 //       slot_size: 65536
+                //       mode: broadcast        # 可选：queue（默认）| broadcast
+                //       max_readers: 8         # 可选：broadcast 读者表容量
+                //       multi_producer: false  # 可选：允许多个写端
+                //       notify: futex          # 可选：futex（默认）| semaphore
+                //       ring_bytes: 4194304    # 可选：字节环大小（变长记录），默认按 capacity * slot_size
+                //       max_message: 1048576   # 可选：单条消息上限，超限消息直接拒绝
                 if (n["shm"]) {
                     auto s = n["shm"];
                     if (s["name"]) cfg.shm_name = s["name"].as<std::string>(cfg.shm_name);
                     if (s["capacity"]) cfg.shm_capacity = s["capacity"].as<std::size_t>(cfg.shm_capacity);
                     if (s["slot_size"]) cfg.shm_slot_size = s["slot_size"].as<std::size_t>(cfg.shm_slot_size);
+                    if (s["mode"]) cfg.shm_mode = s["mode"].as<std::string>(cfg.shm_mode);
+                    if (s["max_readers"]) cfg.shm_max_readers = s["max_readers"].as<std::size_t>(cfg.shm_max_readers);
+                    if (s["multi_producer"]) cfg.shm_multi_producer = s["multi_producer"].as<bool>(cfg.shm_multi_producer);
+                    if (s["notify"]) cfg.shm_notify = s["notify"].as<std::string>(cfg.shm_notify);
+                    if (s["ring_bytes"]) cfg.shm_ring_bytes = s["ring_bytes"].as<std::size_t>(cfg.shm_ring_bytes);
+                    if (s["max_message"]) cfg.shm_max_message = s["max_message"].as<std::size_t>(cfg.shm_max_message);
                 }
 
                 if (n["qos"]) {
@@ -290,6 +334,39 @@ Config::Config() {
                     if (q["transport_priority"]) cfg.qos.transport_priority = q["transport_priority"].as<std::int32_t>(cfg.qos.transport_priority);
                     if (q["async_publish"]) cfg.qos.async_publish = q["async_publish"].as<bool>(cfg.qos.async_publish);
                     if (q["realtime_hint"]) cfg.qos.realtime_hint = q["realtime_hint"].as<bool>(cfg.qos.realtime_hint);
+                    if (q["recv_batch"]) cfg.qos.recv_batch = q["recv_batch"].as<std::size_t>(cfg.qos.recv_batch);
+                    if (q["recv_threads"]) cfg.qos.recv_threads = q["recv_threads"].as<std::size_t>(cfg.qos.recv_threads);
+                    if (q["recv_group"]) cfg.qos.recv_group = q["recv_group"].as<std::string>(cfg.qos.recv_group);
+                    if (q["key_offset"]) cfg.qos.key_offset = q["key_offset"].as<std::size_t>(cfg.qos.key_offset);
+                    if (q["key_size"]) cfg.qos.key_size = q["key_size"].as<std::size_t>(cfg.qos.key_size);
+                    if (q["max_instances"]) cfg.qos.max_instances = q["max_instances"].as<std::size_t>(cfg.qos.max_instances);
+                    if (q["large_data"]) cfg.qos.large_data = q["large_data"].as<bool>(cfg.qos.large_data);
+                    if (q["memory_policy"]) {
+                        auto v = to_upper(q["memory_policy"].as<std::string>(""));
+                        if (v == "PREALLOCATED") cfg.qos.memory_policy = ChannelQoS::MemoryPolicy::preallocated;
+                        else if (v == "PREALLOCATED_WITH_REALLOC" || v == "PREALLOCATED_REALLOC") cfg.qos.memory_policy = ChannelQoS::MemoryPolicy::preallocated_realloc;
+                        else if (v == "DYNAMIC" || v == "DYNAMIC_RESERVE") cfg.qos.memory_policy = ChannelQoS::MemoryPolicy::dynamic;
+                        else if (v == "DYNAMIC_REUSABLE") cfg.qos.memory_policy = ChannelQoS::MemoryPolicy::dynamic_reusable;
+                        else cfg.qos.memory_policy = ChannelQoS::MemoryPolicy::unset;
+                    }
+                    if (q["initial_payload"]) cfg.qos.initial_payload = q["initial_payload"].as<std::size_t>(cfg.qos.initial_payload);
+                    if (q["flow_controller"]) cfg.qos.flow_controller = q["flow_controller"].as<std::string>(cfg.qos.flow_controller);
+                    if (q["flow_bytes_per_period"]) cfg.qos.flow_bytes_per_period = q["flow_bytes_per_period"].as<std::uint64_t>(cfg.qos.flow_bytes_per_period);
+                    if (q["flow_period_ms"]) cfg.qos.flow_period_ms = q["flow_period_ms"].as<std::uint64_t>(cfg.qos.flow_period_ms);
+                    if (q["data_sharing"]) cfg.qos.data_sharing = q["data_sharing"].as<bool>(cfg.qos.data_sharing);
+                    if (q["filter"]) cfg.qos.filter_expression = q["filter"].as<std::string>(cfg.qos.filter_expression);
+                    if (q["filter_parameters"] && q["filter_parameters"].IsSequence()) {
+                        cfg.qos.filter_parameters.clear();
+                        for (const auto& v : q["filter_parameters"]) cfg.qos.filter_parameters.push_back(v.as<std::string>());
+                    }
+                    if (q["recv_cpus"]) {
+                        cfg.qos.recv_cpus.clear();
+                        if (q["recv_cpus"].IsSequence()) {
+                            for (const auto& c : q["recv_cpus"]) cfg.qos.recv_cpus.push_back(c.as<int>());
+                        } else {
+                            cfg.qos.recv_cpus = wxz::core::internal::parse_cpu_list(q["recv_cpus"].as<std::string>());
+                        }
+                    }
                 }
 
                 channels_[cfg.name] = cfg;
@@ -383,6 +460,11 @@ int Config::getThreadCount(const std::string &module, int default_n, int max_n)
     return default_n;
 }
 
+const ThreadPolicyConfig* Config::getThreadPolicy(const std::string &module) const {
+    auto it = thread_policies_.find(module);
+    return it == thread_policies_.end() ? nullptr : &it->second;
+}
+
 std::string Config::getCommType() const {
     return comm_type_;
 }
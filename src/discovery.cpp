@@ -1,4 +1,5 @@
 #include "internal/discovery.h"
+#include "internal/thread_policy.h"
 
 #include <chrono>
 #include <curl/curl.h>
@@ -30,7 +31,10 @@ void DiscoveryClient::start(const std::string& endpoint,
     }
 
     running_ = true;
-    worker_ = std::thread([this]() { run(); });
+    worker_ = std::thread([this]() {
+        wxz::core::internal::apply_thread_policy("discovery", 0);
+        run();
+    });
 }
 
 void DiscoveryClient::stop() {
@@ -1,4 +1,5 @@
 #include "internal/event_dispatcher.h"
+#include "internal/thread_policy.h"
 
 #include <utility>
 
@@ -14,7 +15,10 @@ EventDispatcher::~EventDispatcher() {
 bool EventDispatcher::start() {
     if (running_.load()) return false;
     running_.store(true);
-    loop_thread_ = std::thread([this]() { loop(); });
+    loop_thread_ = std::thread([this]() {
+        wxz::core::internal::apply_thread_policy("event_dispatcher", 0);
+        loop();
+    });
     return true;
 }
 
@@ -0,0 +1,926 @@
+#include "executor.h"
+
+#include "internal/futex.h"
+#include "internal/thread_policy.h"
+#include "internal/work_stealing.h"
+
+#include <algorithm>
+#include <ctime>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace wxz::core {
+
+namespace {
+
+void count_reject(const char* reason) {
+    if (wxz::core::has_metrics_sink()) {
+        wxz::core::metrics().counter_add("wxz.executor.post.reject", 1, {{"reason", reason}});
+    }
+}
+
+struct timespec to_timespec(std::chrono::nanoseconds d) {
+    struct timespec ts {};
+    ts.tv_sec = static_cast<time_t>(d.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(d.count() % 1000000000);
+    return ts;
+}
+
+const char* lane_name(Executor::Lane lane) {
+    switch (lane) {
+    case Executor::Lane::realtime:
+        return "realtime";
+    case Executor::Lane::normal:
+        return "normal";
+    case Executor::Lane::background:
+        return "background";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+namespace internal {
+
+// realtime/background lane：一把互斥锁保护；非空状态另用原子计数暴露，lane 为空时工作线程只多一次原子读。
+// - realtime：(deadline, seq) 小顶堆（EDF，同 deadline 按入队顺序）。
+// - background：FIFO。
+// - realtime 专用线程在 cv_ 上等待；普通工作线程由执行器按 backend 各自的方式唤醒。
+class PriorityLanes {
+public:
+    struct Item {
+        std::chrono::steady_clock::time_point deadline{};
+        std::uint64_t seq{0};
+        bool has_deadline{false};
+        MoveOnlyFunction fn;
+    };
+
+    explicit PriorityLanes(const Executor::Options& opts)
+        : realtime_max_(opts.realtime_max_queue), background_max_(opts.background_max_queue) {}
+
+    PriorityLanes(const PriorityLanes&) = delete;
+    PriorityLanes& operator=(const PriorityLanes&) = delete;
+
+    // 满时返回 false（不阻塞）。
+    bool push(Executor::Lane lane, MoveOnlyFunction&& fn, const std::chrono::steady_clock::time_point* deadline) {
+        // 只有以入队时刻为 deadline 的 realtime 任务需要读时钟；background 按 seq 保持 FIFO。
+        const auto now = (lane == Executor::Lane::realtime && !deadline) ? std::chrono::steady_clock::now()
+                                                                         : std::chrono::steady_clock::time_point{};
+        bool notify = false;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if (lane == Executor::Lane::realtime) {
+                if (realtime_max_ > 0 && realtime_.size() >= realtime_max_) return false;
+                realtime_.push_back(Item{deadline ? *deadline : now, ++seq_, deadline != nullptr, std::move(fn)});
+                std::push_heap(realtime_.begin(), realtime_.end(), later);
+                realtime_size_.store(realtime_.size());
+                notify = realtime_waiters_ > 0;
+            } else {
+                if (background_max_ > 0 && background_.size() >= background_max_) return false;
+                background_.push_back(Item{now, ++seq_, false, std::move(fn)});
+                background_size_.store(background_.size());
+            }
+        }
+        if (notify) cv_.notify_one();
+        return true;
+    }
+
+    bool has_realtime() const { return realtime_size_.load() != 0; }
+    bool any() const { return realtime_size_.load() != 0 || background_size_.load() != 0; }
+
+    bool pop(Executor::Lane lane, Item& out) {
+        if (lane == Executor::Lane::realtime) {
+            if (!has_realtime()) return false;
+            std::lock_guard<std::mutex> lock(mu_);
+            return pop_realtime_locked(out);
+        }
+        if (background_size_.load() == 0) return false;
+        std::lock_guard<std::mutex> lock(mu_);
+        if (background_.empty()) return false;
+        out = std::move(background_.front());
+        background_.pop_front();
+        background_size_.store(background_.size());
+        return true;
+    }
+
+    // realtime 专用线程：阻塞等待 realtime 任务；停止且 realtime 已排空时返回 false。
+    bool wait_realtime(Item& out, const std::atomic<bool>& stopping) {
+        std::unique_lock<std::mutex> lock(mu_);
+        ++realtime_waiters_;
+        cv_.wait(lock, [&] { return stopping.load() || !realtime_.empty(); });
+        --realtime_waiters_;
+        return pop_realtime_locked(out);
+    }
+
+    void wake_all() {
+        { std::lock_guard<std::mutex> lock(mu_); }
+        cv_.notify_all();
+    }
+
+    // 排队等待直方图走采样埋点（见 Executor::post_task）；这里只对 post_before 的任务判定 deadline miss。
+    static void run(Executor::Lane lane, Item& item) {
+        MoveOnlyFunction fn = std::move(item.fn);
+        if (item.has_deadline && wxz::core::has_metrics_sink() && std::chrono::steady_clock::now() > item.deadline) {
+            wxz::core::metrics().counter_add("wxz.executor.lane.deadline_miss", 1, {{"lane", lane_name(lane)}});
+        }
+        fn();
+    }
+
+private:
+    static bool later(const Item& a, const Item& b) {
+        if (a.deadline != b.deadline) return a.deadline > b.deadline;
+        return a.seq > b.seq;
+    }
+
+    bool pop_realtime_locked(Item& out) {
+        if (realtime_.empty()) return false;
+        std::pop_heap(realtime_.begin(), realtime_.end(), later);
+        out = std::move(realtime_.back());
+        realtime_.pop_back();
+        realtime_size_.store(realtime_.size());
+        return true;
+    }
+
+    const std::size_t realtime_max_;
+    const std::size_t background_max_;
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::vector<Item> realtime_;
+    std::deque<Item> background_;
+    std::uint64_t seq_{0};
+    std::size_t realtime_waiters_{0};
+
+    alignas(kCacheLineSize) std::atomic<std::size_t> realtime_size_{0};
+    std::atomic<std::size_t> background_size_{0};
+};
+
+// work_stealing backend：
+// - 工作线程内 post 的任务进入本线程的 Chase-Lev 队列；外部线程 post 进入全局 MPMC 注入队列
+//   （max_queue=0 且注入队列写满时落到加锁的溢出队列，仅作兜底）。
+// - 取任务顺序：本地队列 -> 注入队列 -> 随机起点窃取其它线程；每 kInjectInterval 个任务先看一次注入队列，
+//   避免本地任务持续自我重投时外部任务饿死。
+// - 本地队列由 owner 从 bottom 端 LIFO 取（刚投递的任务缓存仍热）；连续 kLifoBudget 次后改从 top 端取一次最早的任务，
+//   自我重投的任务（Strand/订阅队列按配额让出）在单线程下也不会饿死同队列的其它任务。
+// - 空闲时有界自旋后 park 在 eventcount（futex）上；post 只在没有线程在搜索、且有线程 park 时才进内核唤醒，
+//   同一时刻最多一次唤醒在途。
+// - max_queue 由 pending_ 计数实现（所有队列中待执行任务总数），满时按 block_when_full 阻塞或拒绝。
+class WorkStealingScheduler {
+public:
+    enum class PushResult {
+        ok,
+        full,
+        stopping,
+    };
+
+    WorkStealingScheduler(const Executor::Options& opts, const std::atomic<bool>& stopping, PriorityLanes& lanes)
+        : stopping_(stopping),
+          lanes_(lanes),
+          max_queue_(opts.max_queue),
+          block_when_full_(opts.block_when_full),
+          spin_iterations_(std::thread::hardware_concurrency() > 1 ? kSpinIterations : 0),
+          inject_(opts.max_queue > 0 ? opts.max_queue : kDefaultInjectCapacity) {
+        workers_.reserve(opts.threads);
+        for (std::size_t i = 0; i < opts.threads; ++i) {
+            workers_.push_back(std::make_unique<Worker>(static_cast<std::uint32_t>(i)));
+        }
+    }
+
+    WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+    ~WorkStealingScheduler() {
+        // 与 mutex_queue 一致：stop() 之后仍留在队列里的任务不执行，直接销毁。
+        while (Task* t = pop_injected()) delete t;
+        for (auto& w : workers_) {
+            while (Task* t = w->deque.steal()) delete t;
+        }
+    }
+
+    PushResult push(MoveOnlyFunction&& fn, bool may_block) {
+        if (max_queue_ > 0 && !reserve_slot(may_block)) {
+            return stopping_.load() ? PushResult::stopping : PushResult::full;
+        }
+        Task* t = new Task(std::move(fn));
+        Worker* self = current_ == this ? current_worker_ : nullptr;
+        if (!self || !self->deque.push(t)) {
+            if (!inject_.push(t)) {
+                std::lock_guard<std::mutex> lock(overflow_mu_);
+                overflow_.push_back(t);
+                overflow_size_.fetch_add(1, std::memory_order_release);
+            }
+        }
+        notify_one();
+        return PushResult::ok;
+    }
+
+    // index < threads：工作线程；否则为 spin() 调用线程（无本地队列，只取注入队列与窃取）。
+    void run_worker(std::size_t index) {
+        Worker* self = index < workers_.size() ? workers_[index].get() : nullptr;
+        // spin() 可能在另一个执行器的任务里被调用：退出时恢复外层上下文。
+        WorkStealingScheduler* const prev = current_;
+        Worker* const prev_worker = current_worker_;
+        current_ = this;
+        current_worker_ = self;
+        bool searching = false;
+        Next next;
+        for (;;) {
+            bool found = find_next(self, next);
+            if (!found) {
+                if (!searching) {
+                    searching = true;
+                    searching_.fetch_add(1, std::memory_order_seq_cst);
+                }
+                for (std::uint32_t i = 0; !found && i < spin_iterations_; ++i) {
+                    cpu_relax();
+                    found = find_next(self, next);
+                }
+            }
+            if (found) {
+                // 最后一个搜索者转入执行时再唤醒一个线程接着找（突发任务逐个唤醒，而不是每次 post 都唤醒）。
+                if (searching) {
+                    searching = false;
+                    if (searching_.fetch_sub(1, std::memory_order_seq_cst) == 1) notify_one();
+                }
+                run(next);
+                continue;
+            }
+            // 放弃搜索：先撤销 searching_ 再在 park() 里复查队列，与 notify_one() 的判断配对，不会漏任务。
+            searching = false;
+            searching_.fetch_sub(1, std::memory_order_seq_cst);
+            if (stopping_.load()) break;
+            park(nullptr);
+            searching = true;
+            searching_.fetch_add(1, std::memory_order_seq_cst);
+            wake_pending_.store(false, std::memory_order_seq_cst);
+        }
+        current_ = prev;
+        current_worker_ = prev_worker;
+    }
+
+    bool run_one(std::chrono::nanoseconds timeout) {
+        Worker* self = current_ == this ? current_worker_ : nullptr;
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        Next next;
+        for (;;) {
+            if (find_next(self, next)) {
+                run(next);
+                return true;
+            }
+            if (stopping_.load()) return false;
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) return false;
+            const struct timespec ts = to_timespec(deadline - now);
+            park(&ts);
+            wake_pending_.store(false, std::memory_order_seq_cst);
+        }
+    }
+
+    // normal lane 待执行任务数（近似值，用于采样上报）。
+    std::size_t depth_approx() const {
+        if (max_queue_ > 0) return pending_.load(std::memory_order_relaxed);
+        std::size_t n = inject_.size_approx() + overflow_size_.load(std::memory_order_relaxed);
+        for (const auto& w : workers_) n += w->deque.size_approx();
+        return n;
+    }
+
+    // 唤醒一个 park 的线程（realtime/background lane 入队后由执行器调用）。
+    void notify() { notify_one(); }
+
+    void wake_all() {
+        wake_seq_.fetch_add(1, std::memory_order_seq_cst);
+        (void)futex_wake_all(&wake_seq_, /*process_shared=*/false);
+        space_seq_.fetch_add(1, std::memory_order_seq_cst);
+        (void)futex_wake_all(&space_seq_, /*process_shared=*/false);
+    }
+
+private:
+    using Task = MoveOnlyFunction;
+
+    static constexpr std::size_t kLocalCapacity = 256;
+    static constexpr std::size_t kDefaultInjectCapacity = 4096;
+    static constexpr std::uint32_t kInjectInterval = 61;
+    static constexpr std::uint32_t kLifoBudget = 8;
+    static constexpr std::uint32_t kSpinIterations = 64;
+
+    struct alignas(kCacheLineSize) Worker {
+        explicit Worker(std::uint32_t seed) : deque(kLocalCapacity), rng(seed * 2654435761u + 1) {}
+        ChaseLevDeque<Task> deque;
+        std::uint32_t tick{0};
+        // 连续从 bottom 端取到的任务数。
+        std::uint32_t lifo_run{0};
+        std::uint32_t rng{1};
+    };
+
+    // 一次取到的待执行项：normal lane 为本调度器的 Task，其它 lane 为 PriorityLanes::Item。
+    struct Next {
+        Executor::Lane lane{Executor::Lane::normal};
+        Task* task{nullptr};
+        PriorityLanes::Item item;
+    };
+
+    // 严格优先级：realtime lane -> 本调度器队列（normal）-> background lane。
+    bool find_next(Worker* self, Next& out) {
+        if (lanes_.pop(Executor::Lane::realtime, out.item)) {
+            out.lane = Executor::Lane::realtime;
+            return true;
+        }
+        if ((out.task = find_task(self)) != nullptr) {
+            out.lane = Executor::Lane::normal;
+            return true;
+        }
+        if (lanes_.pop(Executor::Lane::background, out.item)) {
+            out.lane = Executor::Lane::background;
+            return true;
+        }
+        return false;
+    }
+
+    void run(Next& next) {
+        if (next.lane == Executor::Lane::normal) {
+            run(next.task);
+            next.task = nullptr;
+            return;
+        }
+        PriorityLanes::run(next.lane, next.item);
+    }
+
+    Task* find_task(Worker* self) {
+        if (self) {
+            if (++self->tick % kInjectInterval == 0) {
+                if (Task* t = pop_injected()) return t;
+            }
+            if (self->lifo_run < kLifoBudget) {
+                if (Task* t = self->deque.pop()) {
+                    ++self->lifo_run;
+                    return t;
+                }
+            }
+            self->lifo_run = 0;
+            if (Task* t = self->deque.steal()) return t;
+        }
+        if (Task* t = pop_injected()) return t;
+        return steal_other(self);
+    }
+
+    Task* pop_injected() {
+        if (Task* t = inject_.pop()) return t;
+        if (overflow_size_.load(std::memory_order_acquire) == 0) return nullptr;
+        std::lock_guard<std::mutex> lock(overflow_mu_);
+        if (overflow_.empty()) return nullptr;
+        Task* t = overflow_.front();
+        overflow_.pop_front();
+        overflow_size_.fetch_sub(1, std::memory_order_relaxed);
+        return t;
+    }
+
+    Task* steal_other(Worker* self) {
+        const std::size_t n = workers_.size();
+        if (n == 0) return nullptr;
+        std::size_t start = 0;
+        if (self) {
+            // xorshift32：分散窃取起点，避免所有空闲线程同时盯着同一个队列。
+            self->rng ^= self->rng << 13;
+            self->rng ^= self->rng >> 17;
+            self->rng ^= self->rng << 5;
+            start = self->rng % n;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            Worker* victim = workers_[(start + i) % n].get();
+            if (victim == self) continue;
+            if (Task* t = victim->deque.steal()) return t;
+        }
+        return nullptr;
+    }
+
+    bool has_work() const {
+        if (lanes_.any()) return true;
+        if (!inject_.empty_approx() || overflow_size_.load(std::memory_order_acquire) != 0) return true;
+        for (const auto& w : workers_) {
+            if (!w->deque.empty_approx()) return true;
+        }
+        return false;
+    }
+
+    void run(Task* t) {
+        // 出队即释放容量（与 mutex_queue 在出队时 notify cv_not_full_ 一致）。
+        release_slot();
+        (*t)();
+        delete t;
+    }
+
+    // eventcount：与 notify_one() 配对。先登记 sleepers_ 再读 wake_seq_ 并复查队列，
+    // 要么 post 方看到 sleepers_>0 并唤醒，要么这里的复查能看到新任务。
+    // 返回后调用方负责清除 wake_pending_（无论是否真的被唤醒，醒来的线程都会先搜索一轮）。
+    void park(const struct timespec* timeout) {
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::uint32_t seq = wake_seq_.load(std::memory_order_seq_cst);
+        if (!has_work() && !stopping_.load() && !wake_pending_.load(std::memory_order_seq_cst)) {
+            (void)futex_wait(&wake_seq_, seq, timeout, /*process_shared=*/false);
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // 唤醒节流：已有线程在搜索（它会找到新任务）、没有线程 park、或已有一次唤醒在途时都不进内核。
+    void notify_one() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (searching_.load(std::memory_order_seq_cst) != 0) return;
+        if (sleepers_.load(std::memory_order_seq_cst) == 0) return;
+        if (wake_pending_.exchange(true, std::memory_order_seq_cst)) return;
+        wake_seq_.fetch_add(1, std::memory_order_seq_cst);
+        (void)futex_wake(&wake_seq_, 1, /*process_shared=*/false);
+    }
+
+    bool reserve_slot(bool may_block) {
+        for (;;) {
+            std::size_t p = pending_.load(std::memory_order_relaxed);
+            while (p < max_queue_) {
+                if (pending_.compare_exchange_weak(p, p + 1, std::memory_order_relaxed)) return true;
+            }
+            if (!block_when_full_ || !may_block || stopping_.load()) return false;
+            full_waiters_.fetch_add(1, std::memory_order_seq_cst);
+            const std::uint32_t seq = space_seq_.load(std::memory_order_seq_cst);
+            if (pending_.load(std::memory_order_seq_cst) >= max_queue_ && !stopping_.load()) {
+                (void)futex_wait(&space_seq_, seq, nullptr, /*process_shared=*/false);
+            }
+            full_waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // 每空出一个名额唤醒一个阻塞的 post（与 mutex_queue 出队时 cv_not_full_.notify_one() 一致）；
+    // 没有阻塞者时只多一次原子读。
+    void release_slot() {
+        if (max_queue_ == 0) return;
+        pending_.fetch_sub(1, std::memory_order_seq_cst);
+        if (full_waiters_.load(std::memory_order_seq_cst) == 0) return;
+        space_seq_.fetch_add(1, std::memory_order_seq_cst);
+        (void)futex_wake(&space_seq_, 1, /*process_shared=*/false);
+    }
+
+    static thread_local WorkStealingScheduler* current_;
+    static thread_local Worker* current_worker_;
+
+    const std::atomic<bool>& stopping_;
+    PriorityLanes& lanes_;
+    const std::size_t max_queue_;
+    const bool block_when_full_;
+    const std::uint32_t spin_iterations_;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    MpmcPtrQueue<Task> inject_;
+
+    std::mutex overflow_mu_;
+    std::deque<Task*> overflow_;
+    std::atomic<std::size_t> overflow_size_{0};
+
+    alignas(kCacheLineSize) std::atomic<std::size_t> pending_{0};
+    alignas(kCacheLineSize) std::atomic<std::uint32_t> wake_seq_{0};
+    alignas(kCacheLineSize) std::atomic<std::uint32_t> sleepers_{0};
+    std::atomic<std::uint32_t> searching_{0};
+    std::atomic<bool> wake_pending_{false};
+    alignas(kCacheLineSize) std::atomic<std::uint32_t> space_seq_{0};
+    std::atomic<std::uint32_t> full_waiters_{0};
+};
+
+thread_local WorkStealingScheduler* WorkStealingScheduler::current_ = nullptr;
+thread_local WorkStealingScheduler::Worker* WorkStealingScheduler::current_worker_ = nullptr;
+
+// 延时/周期任务：最小堆 + 专用定时线程。
+// - 定时线程在执行器运行且存在定时器时才创建；堆为空时无限期等待，到期前 wait_until 最早的 deadline。
+// - 到期后以 may_block=false post 包装任务：定时线程不受背压阻塞，队列满时本次触发丢弃。
+// - 取消采用惰性删除：cancel() 只打标记并从 active_ 移除，堆中条目在出堆时丢弃；
+//   堆中已取消条目过多时整体重建。
+class TimerQueue {
+public:
+    TimerQueue(Executor& ex, std::string pool) : ex_(ex), pool_(std::move(pool)) {}
+    TimerQueue(const TimerQueue&) = delete;
+    TimerQueue& operator=(const TimerQueue&) = delete;
+    ~TimerQueue() { stop(); }
+
+    Executor::TimerHandle schedule(std::chrono::steady_clock::time_point when,
+                                   std::chrono::nanoseconds period,
+                                   MoveOnlyFunction&& fn) {
+        auto t = std::make_shared<Timer>();
+        t->period = period;
+        t->fn = std::move(fn);
+        std::lock_guard<std::mutex> lock(mu_);
+        t->id = ++next_id_;
+        active_.emplace(t->id, t);
+        const bool earliest = heap_.empty() || when < heap_.front().deadline;
+        push_locked(when, t);
+        if (running_) {
+            if (!thread_.joinable()) {
+                thread_ = std::thread([this] {
+                    apply_thread_policy(pool_, 0);
+                    loop();
+                });
+            } else if (earliest) {
+                cv_.notify_one();
+            }
+        }
+        return Executor::TimerHandle{t->id};
+    }
+
+    bool cancel(std::uint64_t id) {
+        std::lock_guard<std::mutex> lock(mu_);
+        auto it = active_.find(id);
+        if (it == active_.end()) return false;
+        const bool was = it->second->cancelled.exchange(true);
+        active_.erase(it);
+        if (heap_.size() > kCompactMin && heap_.size() > 2 * active_.size()) compact_locked();
+        return !was;
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mu_);
+        running_ = true;
+        if (!heap_.empty() && !thread_.joinable()) {
+            thread_ = std::thread([this] {
+                apply_thread_policy(pool_, 0);
+                loop();
+            });
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            running_ = false;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) thread_.join();
+    }
+
+private:
+    static constexpr std::size_t kCompactMin = 64;
+
+    struct Timer {
+        std::uint64_t id{0};
+        std::chrono::nanoseconds period{0};
+        MoveOnlyFunction fn;
+        // 一次性任务：触发执行或取消时置位（二者只有一个生效）；周期任务：取消标记。
+        std::atomic<bool> cancelled{false};
+        // 周期任务：已投递尚未执行完（用于跳过重叠触发）。
+        std::atomic<bool> inflight{false};
+    };
+
+    struct Entry {
+        std::chrono::steady_clock::time_point deadline;
+        std::uint64_t seq{0};
+        std::shared_ptr<Timer> timer;
+    };
+
+    // 小顶堆：deadline 早者优先，同一 deadline 按调度顺序。
+    static bool later(const Entry& a, const Entry& b) {
+        if (a.deadline != b.deadline) return a.deadline > b.deadline;
+        return a.seq > b.seq;
+    }
+
+    void push_locked(std::chrono::steady_clock::time_point when, std::shared_ptr<Timer> t) {
+        heap_.push_back(Entry{when, ++next_seq_, std::move(t)});
+        std::push_heap(heap_.begin(), heap_.end(), later);
+    }
+
+    void compact_locked() {
+        heap_.erase(std::remove_if(heap_.begin(), heap_.end(), [](const Entry& e) { return e.timer->cancelled.load(); }),
+                    heap_.end());
+        std::make_heap(heap_.begin(), heap_.end(), later);
+    }
+
+    void forget(std::uint64_t id) {
+        std::lock_guard<std::mutex> lock(mu_);
+        active_.erase(id);
+    }
+
+    void loop() {
+        std::vector<std::shared_ptr<Timer>> due;
+        std::unique_lock<std::mutex> lock(mu_);
+        while (running_) {
+            if (heap_.empty()) {
+                cv_.wait(lock);
+                continue;
+            }
+            const auto next = heap_.front().deadline;
+            auto now = std::chrono::steady_clock::now();
+            if (now < next) {
+                cv_.wait_until(lock, next);
+                continue;
+            }
+            due.clear();
+            while (!heap_.empty() && heap_.front().deadline <= now) {
+                std::pop_heap(heap_.begin(), heap_.end(), later);
+                Entry e = std::move(heap_.back());
+                heap_.pop_back();
+                if (e.timer->cancelled.load()) continue;
+                if (e.timer->period.count() > 0) {
+                    // 固定速率；滞后超过一个周期时追赶到下一个未来周期点。
+                    auto d = e.deadline + e.timer->period;
+                    if (d <= now) d += ((now - d) / e.timer->period + 1) * e.timer->period;
+                    push_locked(d, e.timer);
+                }
+                due.push_back(std::move(e.timer));
+            }
+            lock.unlock();
+            for (auto& t : due) fire(t);
+            due.clear();
+            lock.lock();
+        }
+    }
+
+    void fire(const std::shared_ptr<Timer>& t) {
+        if (t->period.count() == 0) {
+            const std::uint64_t id = t->id;
+            const bool ok = ex_.post_task(
+                [this, t] {
+                    if (t->cancelled.exchange(true)) return;
+                    t->fn();
+                    forget(t->id);
+                },
+                /*may_block=*/false);
+            if (!ok) forget(id);
+            return;
+        }
+        if (t->inflight.exchange(true)) {
+            if (wxz::core::has_metrics_sink()) {
+                wxz::core::metrics().counter_add("wxz.executor.timer.overrun", 1, {});
+            }
+            return;
+        }
+        const bool ok = ex_.post_task(
+            [t] {
+                if (!t->cancelled.load()) t->fn();
+                t->inflight.store(false);
+            },
+            /*may_block=*/false);
+        if (!ok) t->inflight.store(false);
+    }
+
+    Executor& ex_;
+    const std::string pool_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::vector<Entry> heap_;
+    std::unordered_map<std::uint64_t, std::shared_ptr<Timer>> active_;
+    std::uint64_t next_id_{0};
+    std::uint64_t next_seq_{0};
+    bool running_{false};
+    std::thread thread_;
+};
+
+} // namespace internal
+
+// Executor（执行器）----------------------------------------------------------
+
+Executor::Executor() : Executor(Options{}) {}
+
+Executor::Executor(Options opts)
+    : opts_(std::move(opts)),
+      timers_(std::make_unique<internal::TimerQueue>(*this, opts_.name + "_timer")),
+      lanes_(std::make_unique<internal::PriorityLanes>(opts_)) {
+    if (opts_.backend == Backend::work_stealing) {
+        ws_ = std::make_unique<internal::WorkStealingScheduler>(opts_, stopping_, *lanes_);
+    }
+}
+
+Executor::~Executor() { stop(); }
+
+bool Executor::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) return false;
+    stopping_.store(false);
+    if (opts_.threads > 0) {
+        workers_.reserve(opts_.threads);
+        for (std::size_t i = 0; i < opts_.threads; ++i) {
+            workers_.emplace_back([this, i] {
+                internal::apply_thread_policy(opts_.name, i);
+                if (ws_) {
+                    ws_->run_worker(i);
+                } else {
+                    worker_loop();
+                }
+            });
+        }
+    }
+    if (opts_.realtime_threads > 0) {
+        const std::string pool = opts_.name + "_rt";
+        internal::ThreadPolicy policy = internal::thread_policy_for(pool);
+        if (!opts_.realtime_cpus.empty()) policy.cpus = opts_.realtime_cpus;
+        if (opts_.realtime_priority > 0) {
+            policy.sched = internal::SchedPolicy::fifo;
+            policy.priority = opts_.realtime_priority;
+        }
+        for (std::size_t i = 0; i < opts_.realtime_threads; ++i) {
+            realtime_workers_.emplace_back([this, pool, policy, i] {
+                internal::apply_thread_policy(pool, policy, i);
+                realtime_loop();
+            });
+        }
+    }
+    timers_->start();
+    return true;
+}
+
+void Executor::spin() {
+    if (!running_.load() || stopping_.load()) return;
+    if (ws_) {
+        ws_->run_worker(std::numeric_limits<std::size_t>::max());
+        return;
+    }
+    worker_loop();
+}
+
+bool Executor::spin_once_for(std::chrono::nanoseconds timeout) {
+    if (!running_.load() || stopping_.load()) return false;
+    if (ws_) return ws_->run_one(timeout);
+
+    MoveOnlyFunction task;
+    internal::PriorityLanes::Item item;
+    Lane lane = Lane::normal;
+    {
+        std::unique_lock<std::mutex> lock(mu_);
+        if (tasks_.empty() && !lanes_->any()) {
+            cv_task_.wait_for(lock, timeout, [&] { return stopping_.load() || !tasks_.empty() || lanes_->any(); });
+        }
+        if (stopping_.load()) return false;
+
+        if (lanes_->pop(Lane::realtime, item)) {
+            lane = Lane::realtime;
+        } else if (!tasks_.empty()) {
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            cv_not_full_.notify_one();
+        } else if (lanes_->pop(Lane::background, item)) {
+            lane = Lane::background;
+        } else {
+            return false;
+        }
+    }
+
+    if (lane == Lane::normal) {
+        task();
+    } else {
+        internal::PriorityLanes::run(lane, item);
+    }
+    return true;
+}
+
+void Executor::stop() {
+    if (!running_.load()) return;
+    stopping_.store(true);
+    timers_->stop();
+    if (ws_) ws_->wake_all();
+    lanes_->wake_all();
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        cv_task_.notify_all();
+        cv_not_full_.notify_all();
+    }
+    for (auto& t : workers_) {
+        if (t.joinable()) t.join();
+    }
+    workers_.clear();
+    for (auto& t : realtime_workers_) {
+        if (t.joinable()) t.join();
+    }
+    realtime_workers_.clear();
+    running_.store(false);
+}
+
+Executor::TimerHandle Executor::schedule_timer(std::chrono::steady_clock::time_point when,
+                                               std::chrono::nanoseconds period,
+                                               MoveOnlyFunction&& task) {
+    return timers_->schedule(when, period, std::move(task));
+}
+
+bool Executor::cancel(TimerHandle h) {
+    if (!h) return false;
+    return timers_->cancel(h.id);
+}
+
+bool Executor::post_task(MoveOnlyFunction&& task,
+                         bool may_block,
+                         Lane lane,
+                         const std::chrono::steady_clock::time_point* deadline,
+                         const char* tag) {
+    if (!running_.load()) {
+        count_reject("not_running");
+        return false;
+    }
+    if (stopping_.load()) {
+        count_reject("stopping");
+        return false;
+    }
+
+    const bool sampled = sample_task(opts_.sample_every);
+    if (sampled) {
+        task = instrument_task(std::move(task), TaskScope::executor, opts_.name, tag, opts_.long_task_threshold, lane_name(lane));
+    }
+
+    if (lane != Lane::normal) {
+        if (!lanes_->push(lane, std::move(task), deadline)) {
+            count_reject("lane_full");
+            return false;
+        }
+        wake_for_lane(lane);
+        return true;
+    }
+
+    if (ws_) {
+        switch (ws_->push(std::move(task), may_block)) {
+        case internal::WorkStealingScheduler::PushResult::ok:
+            if (sampled) report_depth(ws_->depth_approx());
+            return true;
+        case internal::WorkStealingScheduler::PushResult::stopping:
+            count_reject("stopping");
+            return false;
+        case internal::WorkStealingScheduler::PushResult::full:
+            count_reject("queue_full");
+            return false;
+        }
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(mu_);
+    if (opts_.max_queue > 0) {
+        if (opts_.block_when_full && may_block) {
+            cv_not_full_.wait(lock, [&] {
+                return stopping_.load() || tasks_.size() < opts_.max_queue;
+            });
+        }
+        if (stopping_.load()) {
+            count_reject("stopping");
+            return false;
+        }
+        if (tasks_.size() >= opts_.max_queue) {
+            count_reject("queue_full");
+            return false;
+        }
+    }
+
+    tasks_.push_back(std::move(task));
+    const std::size_t depth = tasks_.size();
+    cv_task_.notify_one();
+    lock.unlock();
+    if (sampled) report_depth(depth);
+    return true;
+}
+
+void Executor::report_depth(std::size_t depth) {
+    if (!wxz::core::has_metrics_sink()) return;
+    wxz::core::metrics().gauge_set("wxz.executor.queue_depth", static_cast<double>(depth), {{"executor", opts_.name}});
+}
+
+void Executor::wake_for_lane(Lane lane) {
+    // realtime 任务已由 PriorityLanes 唤醒专用线程；没有专用线程（或 background）时唤醒普通工作线程。
+    if (lane == Lane::realtime && opts_.realtime_threads > 0) return;
+    if (ws_) {
+        ws_->notify();
+        return;
+    }
+    // 与 worker_loop 的等待谓词配对：lane 计数已在 PriorityLanes 的锁内更新，这里经 mu_ 再 notify，不会漏唤醒。
+    { std::lock_guard<std::mutex> lock(mu_); }
+    cv_task_.notify_one();
+}
+
+void Executor::realtime_loop() {
+    internal::PriorityLanes::Item item;
+    while (lanes_->wait_realtime(item, stopping_)) {
+        internal::PriorityLanes::run(Lane::realtime, item);
+    }
+}
+
+void Executor::worker_loop() {
+    for (;;) {
+        MoveOnlyFunction task;
+        internal::PriorityLanes::Item item;
+        Lane lane = Lane::normal;
+        {
+            std::unique_lock<std::mutex> lock(mu_);
+            cv_task_.wait(lock, [&] { return stopping_.load() || !tasks_.empty() || lanes_->any(); });
+
+            // 严格优先级：realtime -> normal -> background。
+            if (lanes_->pop(Lane::realtime, item)) {
+                lane = Lane::realtime;
+            } else if (!tasks_.empty()) {
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+                cv_not_full_.notify_one();
+            } else if (lanes_->pop(Lane::background, item)) {
+                lane = Lane::background;
+            } else {
+                if (stopping_.load()) return;
+                continue;
+            }
+        }
+
+        if (lane == Lane::normal) {
+            task();
+        } else {
+            internal::PriorityLanes::run(lane, item);
+        }
+    }
+}
+
+} // namespace wxz::core
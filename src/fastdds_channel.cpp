@@ -2,13 +2,20 @@
 
 #include "internal/dds_security_precheck.h"
 #include "internal/fastcdr_compat.h"
-#include "internal/fastdds_participant_factory.h"
+#include "internal/fastdds_participant_pool.h"
+#include "internal/fastdds_raw_filter.h"
+#include "internal/fastdds_recv_payload_pool.h"
+#include "internal/fastdds_writer_buffer_cache.h"
+#include "internal/thread_policy.h"
 #include "observability.h"
 
 #include "executor.h"
 #include "logger.h"
 #include "strand.h"
 
+#include <fastdds/dds/core/LoanableSequence.hpp>
+#include <fastdds/dds/core/condition/GuardCondition.hpp>
+#include <fastdds/dds/core/condition/WaitSet.hpp>
 #include <fastdds/dds/core/policy/QosPolicies.hpp>
 #include <fastdds/dds/domain/DomainParticipant.hpp>
 #include <fastdds/dds/domain/DomainParticipantFactory.hpp>
@@ -20,15 +27,20 @@
 #include <fastdds/dds/publisher/qos/PublisherQos.hpp>
 #include <fastdds/dds/subscriber/DataReader.hpp>
 #include <fastdds/dds/subscriber/DataReaderListener.hpp>
+#include <fastdds/dds/subscriber/ReadCondition.hpp>
 #include <fastdds/dds/subscriber/Subscriber.hpp>
 #include <fastdds/dds/subscriber/qos/DataReaderQos.hpp>
 #include <fastdds/dds/subscriber/qos/SubscriberQos.hpp>
 #include <fastdds/dds/subscriber/SampleInfo.hpp>
+#include <fastdds/dds/topic/ContentFilteredTopic.hpp>
 #include <fastdds/dds/topic/Topic.hpp>
 #include <fastdds/dds/topic/TopicDataType.hpp>
 #include <fastdds/dds/topic/TypeSupport.hpp>
 #include <fastdds/dds/topic/qos/TopicQos.hpp>
+#include <fastdds/rtps/common/CacheChange.h>
 #include <fastdds/rtps/common/SerializedPayload.h>
+#include <fastdds/rtps/history/IPayloadPool.h>
+#include <fastdds/rtps/resources/ResourceManagement.h>
 
 #ifdef MEMBER_ID_INVALID
 #undef MEMBER_ID_INVALID
@@ -36,35 +48,115 @@
 
 #include <fastcdr/Cdr.h>
 #include <fastcdr/FastBuffer.h>
+#include <fastrtps/utils/md5.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <mutex>
 #include <fstream>
+#include <limits>
 #include <stdexcept>
 #include <thread>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
 
 namespace wxz::core {
 
 namespace {
 
-bool env_truthy(const char* key) {
+bool env_falsy(const char* key) {
     const char* v = std::getenv(key);
     if (!v || !*v) return false;
-    return (std::string(v) == "1" || std::string(v) == "true" || std::string(v) == "TRUE" || std::string(v) == "yes" || std::string(v) == "YES");
+    return (std::string(v) == "0" || std::string(v) == "false" || std::string(v) == "FALSE" || std::string(v) == "no" || std::string(v) == "NO");
+}
+
+// Raw payload 布局：Encapsulation(4) + len(uint32=4) + bytes。loan 的可写区域从这里开始。
+constexpr std::size_t kRawHeaderBytes = 8;
+// 类型尺寸在 payload 之外的余量：Encapsulation(4) + len(uint32=4) + CDR 对齐/填充。
+constexpr std::size_t kRawTypeSlackBytes = 24;
+// 大数据模式下每个样本默认预分配的 payload；更大的帧按内存策略重新分配。
+constexpr std::size_t kLargeDataInitialPayload = 64 * 1024;
+
+// 样本 payload 的预分配尺寸（类型尺寸提示）与 writer/reader history 的内存策略。
+struct PayloadMemoryPlan {
+    std::size_t size_hint;
+    ChannelQoS::MemoryPolicy policy;
+};
+
+PayloadMemoryPlan plan_payload_memory(const ChannelQoS& qos, std::size_t max_payload, const std::string& topic) {
+    using Policy = ChannelQoS::MemoryPolicy;
+    if (qos.data_sharing) {
+        // data-sharing 的共享内存 history 按类型尺寸定长分段，且要求 PREALLOCATED。
+        if (qos.large_data || qos.initial_payload > 0 || (qos.memory_policy != Policy::unset && qos.memory_policy != Policy::preallocated)) {
+            wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                                 "fastdds data_sharing preallocates max_payload; large_data/initial_payload/memory_policy ignored",
+                                                 {{"topic", topic}});
+        }
+        return {max_payload, Policy::preallocated};
+    }
+
+    std::size_t hint = max_payload;
+    if (qos.initial_payload > 0) {
+        hint = std::min(qos.initial_payload, max_payload);
+    } else if (qos.large_data) {
+        hint = std::min(kLargeDataInitialPayload, max_payload);
+    }
+    Policy policy = qos.memory_policy;
+    if (policy == Policy::unset && hint < max_payload) {
+        // 大数据：按帧尺寸分配并复用；仅调小预分配时：预分配 + 超出时重新分配。
+        policy = qos.large_data ? Policy::dynamic_reusable : Policy::preallocated_realloc;
+    }
+    if (policy == Policy::preallocated && hint < max_payload) {
+        wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                             "fastdds preallocated memory policy cannot grow samples; preallocating max_payload",
+                                             {{"topic", topic}});
+        hint = max_payload;
+    }
+    return {hint, policy};
+}
+
+eprosima::fastrtps::rtps::MemoryManagementPolicy_t to_fastdds_memory_policy(ChannelQoS::MemoryPolicy policy) {
+    using namespace eprosima::fastrtps::rtps;
+    switch (policy) {
+        case ChannelQoS::MemoryPolicy::preallocated:
+            return PREALLOCATED_MEMORY_MODE;
+        case ChannelQoS::MemoryPolicy::dynamic:
+            return DYNAMIC_RESERVE_MEMORY_MODE;
+        case ChannelQoS::MemoryPolicy::dynamic_reusable:
+            return DYNAMIC_REUSABLE_MEMORY_MODE;
+        case ChannelQoS::MemoryPolicy::preallocated_realloc:
+        case ChannelQoS::MemoryPolicy::unset:
+            break;
+    }
+    return PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
 }
 
 struct RawMsg {
     std::vector<std::uint8_t> data;
+    // 发布侧：直接引用调用方（或 loan）的字节，serialize 时最多拷贝一次。
+    const std::uint8_t* view{nullptr};
+    std::size_t view_size{0};
     wxz::core::ByteBufferLease lease;
     wxz::core::ByteBufferPool* pool{nullptr};
     bool prefer_lease{false};
+    // 接收侧：存在投递型 handler 时直接反序列化进共享 payload（leased handler 优先占用 lease）。
+    internal::FastddsRecvPayloadPool* shared_pool{nullptr};
+    internal::RecvPayloadRef shared;
+    // 接收侧上限（按 channel 的 max_payload）；RawMsgType 在共享 participant 上被多个 channel 复用。
+    std::size_t max_size{std::numeric_limits<std::size_t>::max()};
 
-    void configure(wxz::core::ByteBufferPool* p, bool prefer) {
+    // 最近一次反序列化写入的位置。
+    enum class Target : std::uint8_t { vector, lease, shared };
+    Target target{Target::vector};
+
+    void configure(wxz::core::ByteBufferPool* p, bool prefer, internal::FastddsRecvPayloadPool* sp) {
         pool = p;
         prefer_lease = prefer;
+        shared_pool = sp;
     }
 
     void reserve(std::size_t n) { data.reserve(n); }
@@ -79,33 +171,86 @@ struct RawMsg {
             }
             if (lease && lease.capacity() >= len) {
                 lease.set_size(len);
+                target = Target::lease;
                 return lease.data();
             }
         }
 
-        // 回退到内部 vector。
         lease = wxz::core::ByteBufferLease();
+        if (shared_pool) {
+            // 上一条样本的 payload 仍被排队任务引用时换一个新的。
+            if (!shared.unique()) shared = shared_pool->acquire();
+            target = Target::shared;
+            return shared_pool->prepare(shared, len);
+        }
+
+        // 回退到内部 vector。
         data.resize(len);
+        target = Target::vector;
         return data.data();
     }
 
-    const std::uint8_t* bytes() const { return lease ? lease.data() : data.data(); }
-    std::size_t size() const { return lease ? lease.size() : data.size(); }
+    // 取得本条样本的共享 payload：已反序列化在共享 payload 中时只增加引用，否则拷贝一次。
+    internal::RecvPayloadRef share(internal::FastddsRecvPayloadPool& sp) {
+        if (target == Target::shared && shared) return shared;
+        auto ref = sp.acquire();
+        auto* dst = sp.prepare(ref, size());
+        if (size() > 0) std::memcpy(dst, bytes(), size());
+        return ref;
+    }
+
+    const std::uint8_t* bytes() const {
+        if (view) return view;
+        switch (target) {
+            case Target::lease:
+                return lease ? lease.data() : data.data();
+            case Target::shared:
+                return shared ? shared.data() : data.data();
+            case Target::vector:
+                break;
+        }
+        return data.data();
+    }
+    std::size_t size() const {
+        if (view) return view_size;
+        switch (target) {
+            case Target::lease:
+                return lease ? lease.size() : data.size();
+            case Target::shared:
+                return shared ? shared.size() : data.size();
+            case Target::vector:
+                break;
+        }
+        return data.size();
+    }
 };
 
 class RawMsgType : public eprosima::fastdds::dds::TopicDataType {
 public:
-    explicit RawMsgType(std::size_t max_payload) : max_payload_(max_payload) {
-        setName("WxzRawBytes");
-        // 预留额外空间，用于可能的 CDR 对齐/填充。
-        // Encapsulation(4) + len(uint32=4) + bytes + alignment 余量。
-        m_typeSize = static_cast<uint32_t>(max_payload_ + 24);
-        m_isGetKeyDefined = false;
+    // key_size>0：payload 的 [key_offset, key_offset+key_size) 作为实例 key；区间编码在类型名中（见 raw_bytes_type_name()）。
+    RawMsgType(std::size_t max_payload, std::size_t key_offset, std::size_t key_size)
+        : key_offset_(key_offset), key_size_(key_size) {
+        setName(internal::raw_bytes_type_name(key_offset, key_size).c_str());
+        set_size_hint(max_payload, /*bounded=*/false);
+        m_isGetKeyDefined = key_size > 0;
     }
 
+    // 同一 participant 上同名类型只能注册一次，因此该实例被多个 channel 共享。
+    // m_typeSize 与 is_bounded() 只在创建 DataWriter/DataReader 时被读取（决定 payload pool 的预分配尺寸、
+    // 是否满足 data-sharing 条件），调用方需在 SharedFastddsParticipant::endpoint_mutex() 保护下调整后再创建端点。
+    // - payload_bytes：每个样本预分配的 payload（max_payload，或大数据模式下的 initial_payload）。
+    // - bounded：channel 开启 data-sharing 时按 max_payload 定长处理（publish() 已保证不超过 max_payload）。
+    void set_size_hint(std::size_t payload_bytes, bool bounded) {
+        m_typeSize = static_cast<uint32_t>(payload_bytes + kRawTypeSlackBytes);
+        bounded_ = bounded;
+    }
+
+    bool is_bounded() const override { return bounded_; }
+
     bool serialize(void* data, eprosima::fastrtps::rtps::SerializedPayload_t* payload) override {
         RawMsg* msg = static_cast<RawMsg*>(data);
-        if (msg->size() > max_payload_) return false;
+        // 按 channel 的上限已在 publish() 校验；这里只保证不越过 payload 缓冲区。
+        if (kRawHeaderBytes + msg->size() > payload->max_size) return false;
         eprosima::fastcdr::FastBuffer fastbuffer(reinterpret_cast<char*>(payload->data), payload->max_size);
         eprosima::fastcdr::Cdr ser(fastbuffer);
 
@@ -114,10 +259,16 @@ public:
         wxz::internal::fastcdr_compat::serialize_encapsulation(ser);
 
         wxz::internal::fastcdr_compat::write(ser, static_cast<uint32_t>(msg->size()));
-        if (msg->size() > 0) {
-            wxz::internal::fastcdr_compat::serialize_array(ser, msg->bytes(), msg->size());
+        const std::size_t header = wxz::internal::fastcdr_compat::serialized_length(ser);
+        if (header + msg->size() > payload->max_size) return false;
+
+        // octet 数组的 CDR 编码即原始字节：直接落到 payload。
+        // loan 路径下字节已在 payload 内的目标位置（payload->data + header），无需再拷贝。
+        std::uint8_t* dst = payload->data + header;
+        if (msg->size() > 0 && msg->bytes() != dst) {
+            std::memmove(dst, msg->bytes(), msg->size());
         }
-        payload->length = wxz::internal::fastcdr_compat::serialized_length_u32(ser);
+        payload->length = static_cast<uint32_t>(header + msg->size());
         return true;
     }
 
@@ -131,7 +282,7 @@ public:
 
         uint32_t len = 0;
         wxz::internal::fastcdr_compat::read(deser, len);
-        if (len > max_payload_) return false;
+        if (len > msg->max_size) return false;
         auto* out = msg->writable_ptr(len);
         if (len > 0) {
             wxz::internal::fastcdr_compat::deserialize_array(deser, out, len);
@@ -141,49 +292,74 @@ public:
 
     std::function<uint32_t()> getSerializedSizeProvider(void* data) override {
         RawMsg* msg = static_cast<RawMsg*>(data);
-        return [msg]() { return static_cast<uint32_t>(4 + 4 + msg->size()); };
+        return [msg]() { return static_cast<uint32_t>(kRawHeaderBytes + msg->size()); };
     }
 
     void* createData() override { return new RawMsg(); }
     void deleteData(void* data) override { delete static_cast<RawMsg*>(data); }
-    bool getKey(void*, eprosima::fastrtps::rtps::InstanceHandle_t*, bool) override { return false; }
+    bool getKey(void* data, eprosima::fastrtps::rtps::InstanceHandle_t* handle, bool force_md5) override {
+        if (key_size_ == 0) return false;
+        const RawMsg* msg = static_cast<const RawMsg*>(data);
+        // payload 短于 key 区间时，缺失部分按 0 处理（与过滤器的补 0 语义一致）。
+        const std::uint8_t* bytes = msg->bytes();
+        const std::size_t avail = msg->size() > key_offset_ ? std::min(key_size_, msg->size() - key_offset_) : 0;
+
+        if (force_md5 || key_size_ > 16) {
+            MD5 md5;
+            md5.init();
+            if (avail > 0) md5.update(reinterpret_cast<const char*>(bytes + key_offset_), static_cast<unsigned int>(avail));
+            static constexpr char kZeros[64] = {};
+            for (std::size_t pad = key_size_ - avail; pad > 0;) {
+                const std::size_t n = std::min(pad, sizeof(kZeros));
+                md5.update(kZeros, static_cast<unsigned int>(n));
+                pad -= n;
+            }
+            md5.finalize();
+            for (std::size_t i = 0; i < 16; ++i) handle->value[i] = md5.digest[i];
+        } else {
+            std::memset(handle->value, 0, 16);
+            if (avail > 0) std::memcpy(handle->value, bytes + key_offset_, avail);
+        }
+        return true;
+    }
 
 private:
-    std::size_t max_payload_;
+    const std::size_t key_offset_;
+    const std::size_t key_size_;
+    bool bounded_{false};
 };
 
+// 接收统计、停止标志与 payload 池由 listener 自己持有：handler 内析构 channel 时，
+// 当前 drain 返回前 listener 仍在运行，不能再访问 channel 的成员（见 FastddsChannel::cleanup）。
+// 只有回调开头读取订阅表时引用 channel（此时尚未进入任何 handler）。
 class ReaderListener final : public eprosima::fastdds::dds::DataReaderListener {
 public:
-    using Entry = FastddsChannel::HandlerEntry;
+    using Table = FastddsChannel::HandlerTable;
 
-    explicit ReaderListener(std::vector<Entry>& entries,
+    explicit ReaderListener(std::shared_ptr<const Table>& table,
                             std::mutex& m,
-                            std::atomic<std::uint64_t>& recv_counter,
-                            std::atomic<std::uint64_t>& drop_pool_exhausted,
-                            std::atomic<std::uint64_t>& drop_dispatch_rejected,
-                            const std::string& topic_name,
-                            std::atomic<bool>& stopping,
-                            std::atomic<std::uint32_t>& inflight,
+                            std::shared_ptr<internal::FastddsRecvPayloadPool> payload_pool,
+                            std::string topic_name,
                             std::size_t max_payload,
-                            wxz::core::ByteBufferPool*& leased_pool,
-                            FastddsChannel::LeasedHandler& leased_handler,
-                            wxz::core::Executor*& leased_executor,
-                            wxz::core::Strand*& leased_strand)
-                : entries_(entries),
+                            std::size_t recv_batch)
+                : table_(table),
                     mutex_(m),
-                    recv_counter_(recv_counter),
-                    drop_pool_exhausted_(drop_pool_exhausted),
-                    drop_dispatch_rejected_(drop_dispatch_rejected),
-                    topic_name_(topic_name),
-                    stopping_(stopping),
-                    inflight_(inflight),
-                    leased_pool_(leased_pool),
-                    leased_handler_(leased_handler),
-                    leased_executor_(leased_executor),
-                    leased_strand_(leased_strand) {
-        msg_.reserve(max_payload);
+                    payload_pool_(std::move(payload_pool)),
+                    topic_name_(std::move(topic_name)),
+                    recv_batch_(recv_batch) {
+        // 大帧 channel 不为 listener 预留整帧：该 vector 只在没有共享 payload 的路径上使用，按需增长。
+        msg_.reserve(std::min(max_payload, kLargeDataInitialPayload));
+        msg_.max_size = max_payload;
     }
 
+    // 停止派发：之后的回调直接返回，进行中的回调在当前样本后退出。
+    void stop() { stopping_.store(true, std::memory_order_release); }
+    std::uint32_t inflight() const { return inflight_.load(std::memory_order_relaxed); }
+
+    std::uint64_t received() const { return recv_counter_.load(); }
+    std::uint64_t drop_pool_exhausted() const { return drop_pool_exhausted_.load(std::memory_order_relaxed); }
+    std::uint64_t drop_dispatch_rejected() const { return drop_dispatch_rejected_.load(std::memory_order_relaxed); }
+
     void on_data_available(eprosima::fastdds::dds::DataReader* reader) override {
         if (stopping_.load(std::memory_order_relaxed)) return;
 
@@ -193,160 +369,444 @@ public:
             ~InflightGuard() { v.fetch_sub(1, std::memory_order_relaxed); }
         } guard(inflight_);
 
-        bool want_lease = false;
-        wxz::core::ByteBufferPool* pool = nullptr;
-        wxz::core::Executor* leased_ex = nullptr;
-        wxz::core::Strand* leased_strand = nullptr;
+        // handler 表是不可变快照（写时复制）：每次回调只加锁取一次，逐样本不再拷贝 handler。
+        std::shared_ptr<const Table> table;
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            if (leased_pool_ && leased_handler_) {
-                want_lease = true;
-                pool = leased_pool_;
-                leased_ex = leased_executor_;
-                leased_strand = leased_strand_;
-            }
+            table = table_;
+        }
+
+        if (recv_batch_ > 0) {
+            take_batched(reader, table);
+            return;
         }
 
-        msg_.configure(pool, want_lease);
+        const bool want_lease = table->leased_pool && table->leased_handler;
+        msg_.configure(want_lease ? table->leased_pool : nullptr, want_lease, table->has_dispatched ? payload_pool_.get() : nullptr);
 
         eprosima::fastdds::dds::SampleInfo info;
         while (reader->take_next_sample(&msg_, &info) == eprosima::fastrtps::types::ReturnCode_t::RETCODE_OK) {
             if (stopping_.load(std::memory_order_relaxed)) break;
-            if (info.instance_state != eprosima::fastdds::dds::ALIVE_INSTANCE_STATE) continue;
-            std::vector<Entry> copy;
-            FastddsChannel::LeasedHandler leased;
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                copy.reserve(entries_.size());
-                for (const auto& e : entries_) copy.push_back(e);
-                leased = leased_handler_;
-                if (want_lease) {
-                    leased_ex = leased_executor_;
-                    leased_strand = leased_strand_;
-                }
+            if (!info.valid_data || info.instance_state != eprosima::fastdds::dds::ALIVE_INSTANCE_STATE) continue;
+            dispatch(table, msg_);
+        }
+    }
+
+private:
+    // 批量模式：一次 take 借出最多 recv_batch_ 条样本（DataReader 的样本池对象，不经过 msg_），
+    // 派发完整批后 return_loan。内联 handler 直接看到借出样本的字节；投递型/leased handler 各拷贝一次。
+    void take_batched(eprosima::fastdds::dds::DataReader* reader, const std::shared_ptr<const Table>& table) {
+        using namespace eprosima::fastdds::dds;
+        const auto max_samples = static_cast<std::int32_t>(std::min<std::size_t>(recv_batch_, std::numeric_limits<std::int32_t>::max()));
+
+        LoanableSequence<RawMsg> samples;
+        SampleInfoSeq infos;
+        while (!stopping_.load(std::memory_order_relaxed) &&
+               reader->take(samples, infos, max_samples) == eprosima::fastrtps::types::ReturnCode_t::RETCODE_OK) {
+            const auto n = samples.length();
+            for (LoanableCollection::size_type i = 0; i < n; ++i) {
+                if (stopping_.load(std::memory_order_relaxed)) break;
+                if (!infos[i].valid_data || infos[i].instance_state != ALIVE_INSTANCE_STATE) continue;
+                dispatch(table, samples[i]);
             }
+            reader->return_loan(samples, infos);
 
-            // 普通 handler：可选投递到 executor/strand 上执行。
-            for (auto& e : copy) {
-                if (!e.handler) continue;
-                if (!e.executor && !e.strand) {
-                    e.handler(msg_.bytes(), msg_.size());
-                    continue;
-                }
+            if (wxz::core::has_metrics_sink()) {
+                wxz::core::metrics().histogram_observe("wxz.fastdds.recv.batch_size", static_cast<double>(n), {{"topic", topic_name_}});
+            }
+        }
+    }
 
-                std::vector<std::uint8_t> buf(msg_.size());
-                if (!buf.empty()) {
-                    std::memcpy(buf.data(), msg_.bytes(), msg_.size());
-                }
+    void dispatch(const std::shared_ptr<const Table>& table, RawMsg& msg) {
+        // 普通 handler：可选投递到 executor/strand 上执行。
+        // 投递的任务共享同一份池化 payload（引用计数），并通过表快照保证 handler 在执行前存活。
+        internal::RecvPayloadRef payload;
+        for (const auto& e : table->entries) {
+            // 前一个 inline handler 可能刚析构了 channel：不再进入快照里剩余的 handler。
+            if (stopping_.load(std::memory_order_relaxed)) return;
+            if (!e.handler) continue;
+            if (!e.executor && !e.strand) {
+                e.handler(msg.bytes(), msg.size());
+                continue;
+            }
 
-                auto task = [h = e.handler, b = std::move(buf)]() mutable {
-                    if (h) h(b.data(), b.size());
-                };
+            if (!payload) payload = msg.share(*payload_pool_);
+            auto task = [t = table, h = &e.handler, p = payload]() {
+                (*h)(p.data(), p.size());
+            };
 
-                bool ok = false;
-                if (e.strand) {
-                    ok = e.strand->post(std::move(task));
-                } else if (e.executor) {
-                    ok = e.executor->post(std::move(task));
-                }
+            bool ok = false;
+            if (e.strand) {
+                ok = e.strand->post(std::move(task));
+            } else if (e.executor) {
+                ok = e.executor->post(std::move(task));
+            }
 
-                if (!ok) {
-                    const auto n = drop_dispatch_rejected_.fetch_add(1, std::memory_order_relaxed) + 1;
-                    if (wxz::core::has_metrics_sink()) {
-                        wxz::core::metrics().counter_add("wxz.fastdds.recv.drop_dispatch_rejected", 1, {{"topic", topic_name_}});
-                    }
-                    // 抽样日志，避免刷屏。
-                    if (n == 1 || (n % 1024) == 0) {
-                        wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
-                                                             "fastdds recv drop: dispatch rejected",
-                                                             {{"topic", topic_name_}});
-                    }
+            if (!ok) {
+                const auto n = drop_dispatch_rejected_.fetch_add(1, std::memory_order_relaxed) + 1;
+                if (wxz::core::has_metrics_sink()) {
+                    wxz::core::metrics().counter_add("wxz.fastdds.recv.drop_dispatch_rejected", 1, {{"topic", topic_name_}});
+                }
+                // 抽样日志，避免刷屏。
+                if (n == 1 || (n % 1024) == 0) {
+                    wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                                         "fastdds recv drop: dispatch rejected",
+                                                         {{"topic", topic_name_}});
                 }
             }
-
-            // Leased handler：基于 pool 的字节缓冲，且可选投递到调度器。
-            if (want_lease && leased) {
-                if (msg_.lease) {
-                    auto lease = std::move(msg_.lease);
-                    if (leased_strand) {
-                        bool ok = leased_strand->post([h = leased, l = std::move(lease)]() mutable {
-                            if (h) h(std::move(l));
-                        });
-                        if (!ok) {
-                            const auto n = drop_dispatch_rejected_.fetch_add(1, std::memory_order_relaxed) + 1;
-                            if (wxz::core::has_metrics_sink()) {
-                                wxz::core::metrics().counter_add("wxz.fastdds.recv.drop_dispatch_rejected", 1, {{"topic", topic_name_}});
-                            }
-                            if (n == 1 || (n % 1024) == 0) {
-                                wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
-                                                                     "fastdds recv drop: leased dispatch rejected",
-                                                                     {{"topic", topic_name_}});
-                            }
+        }
+        payload.reset();
+
+        // Leased handler：基于 pool 的字节缓冲，且可选投递到调度器。
+        if (table->leased_pool && table->leased_handler && !stopping_.load(std::memory_order_relaxed)) {
+            // 逐条模式下样本已直接反序列化进 lease；批量模式（或 lease 不够大时）在这里拷贝一次。
+            if (!msg.lease) {
+                auto opt = table->leased_pool->try_acquire();
+                if (opt.has_value() && opt->capacity() >= msg.size()) {
+                    msg.lease = std::move(*opt);
+                    if (msg.size() > 0) std::memcpy(msg.lease.data(), msg.bytes(), msg.size());
+                    msg.lease.set_size(msg.size());
+                }
+            }
+            if (msg.lease) {
+                auto lease = std::move(msg.lease);
+                if (table->leased_strand || table->leased_executor) {
+                    auto task = [t = table, h = &table->leased_handler, l = std::move(lease)]() mutable {
+                        (*h)(std::move(l));
+                    };
+                    const bool ok = table->leased_strand ? table->leased_strand->post(std::move(task))
+                                                         : table->leased_executor->post(std::move(task));
+                    if (!ok) {
+                        const auto n = drop_dispatch_rejected_.fetch_add(1, std::memory_order_relaxed) + 1;
+                        if (wxz::core::has_metrics_sink()) {
+                            wxz::core::metrics().counter_add("wxz.fastdds.recv.drop_dispatch_rejected", 1, {{"topic", topic_name_}});
                         }
-                    } else if (leased_ex) {
-                        bool ok = leased_ex->post([h = leased, l = std::move(lease)]() mutable {
-                            if (h) h(std::move(l));
-                        });
-                        if (!ok) {
-                            const auto n = drop_dispatch_rejected_.fetch_add(1, std::memory_order_relaxed) + 1;
-                            if (wxz::core::has_metrics_sink()) {
-                                wxz::core::metrics().counter_add("wxz.fastdds.recv.drop_dispatch_rejected", 1, {{"topic", topic_name_}});
-                            }
-                            if (n == 1 || (n % 1024) == 0) {
-                                wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
-                                                                     "fastdds recv drop: leased dispatch rejected",
-                                                                     {{"topic", topic_name_}});
-                            }
+                        if (n == 1 || (n % 1024) == 0) {
+                            wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                                                 "fastdds recv drop: leased dispatch rejected",
+                                                                 {{"topic", topic_name_}});
                         }
-                    } else {
-                        leased(std::move(lease));
                     }
                 } else {
-                    // 缓冲池耗尽：按设计直接丢弃 leased handler。
-                    const auto n = drop_pool_exhausted_.fetch_add(1, std::memory_order_relaxed) + 1;
-                    if (wxz::core::has_metrics_sink()) {
-                        wxz::core::metrics().counter_add("wxz.fastdds.recv.drop_pool_exhausted", 1, {{"topic", topic_name_}});
-                    }
-                    if (n == 1 || (n % 1024) == 0) {
-                        wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
-                                                             "fastdds recv drop: pool exhausted",
-                                                             {{"topic", topic_name_}});
-                    }
+                    table->leased_handler(std::move(lease));
+                }
+            } else {
+                // 缓冲池耗尽：按设计直接丢弃 leased handler。
+                const auto n = drop_pool_exhausted_.fetch_add(1, std::memory_order_relaxed) + 1;
+                if (wxz::core::has_metrics_sink()) {
+                    wxz::core::metrics().counter_add("wxz.fastdds.recv.drop_pool_exhausted", 1, {{"topic", topic_name_}});
+                }
+                if (n == 1 || (n % 1024) == 0) {
+                    wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                                         "fastdds recv drop: pool exhausted",
+                                                         {{"topic", topic_name_}});
                 }
             }
-            recv_counter_.fetch_add(1, std::memory_order_relaxed);
+        }
+        ++recv_counter_;
 
-            if (wxz::core::has_metrics_sink()) {
-                wxz::core::metrics().counter_add("wxz.fastdds.recv.messages", 1, {{"topic", topic_name_}});
-                wxz::core::metrics().histogram_observe(
-                    "wxz.fastdds.recv.bytes", static_cast<double>(msg_.size()), {{"topic", topic_name_}});
-            }
-            if (wxz::core::has_trace_hook()) {
-                wxz::core::trace().event("wxz.fastdds.recv", {{"topic", topic_name_}});
-            }
+        if (wxz::core::has_metrics_sink()) {
+            wxz::core::metrics().counter_add("wxz.fastdds.recv.messages", 1, {{"topic", topic_name_}});
+            wxz::core::metrics().histogram_observe(
+                "wxz.fastdds.recv.bytes", static_cast<double>(msg.size()), {{"topic", topic_name_}});
+        }
+        if (wxz::core::has_trace_hook()) {
+            wxz::core::trace().event("wxz.fastdds.recv", {{"topic", topic_name_}});
         }
     }
 
-private:
-    std::vector<Entry>& entries_;
+    std::shared_ptr<const Table>& table_;
     std::mutex& mutex_;
-    std::atomic<std::uint64_t>& recv_counter_;
-    std::atomic<std::uint64_t>& drop_pool_exhausted_;
-    std::atomic<std::uint64_t>& drop_dispatch_rejected_;
-    const std::string& topic_name_;
-    std::atomic<bool>& stopping_;
-    std::atomic<std::uint32_t>& inflight_;
-
-    wxz::core::ByteBufferPool*& leased_pool_;
-    FastddsChannel::LeasedHandler& leased_handler_;
-    wxz::core::Executor*& leased_executor_;
-    wxz::core::Strand*& leased_strand_;
+    const std::shared_ptr<internal::FastddsRecvPayloadPool> payload_pool_;
+    const std::string topic_name_;
+    const std::size_t recv_batch_;
+
+    ShardedCounter recv_counter_;
+    std::atomic<std::uint64_t> drop_pool_exhausted_{0};
+    std::atomic<std::uint64_t> drop_dispatch_rejected_{0};
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::uint32_t> inflight_{0};
 
     RawMsg msg_;
 };
 
 } // 匿名命名空间
 
+namespace internal {
+
+// DataWriter 的自定义 payload pool：buffer 的缓存与 loan 交接由 FastddsWriterBufferCache 完成，
+// 这里只把它接到 IPayloadPool 接口上。
+// 生命周期：DataWriter 与未发布的 Loan 各持有一份 shared_ptr。
+class FastddsWriterPayloadPool final : public eprosima::fastrtps::rtps::IPayloadPool {
+public:
+    FastddsWriterPayloadPool(std::uint32_t buffer_bytes, std::uint32_t frame_bytes) : cache_(buffer_bytes, frame_bytes) {}
+
+    std::uint8_t* acquire(std::uint32_t size, std::uint32_t& capacity) { return cache_.acquire(size, capacity); }
+    void release(std::uint8_t* buf, std::uint32_t capacity) { cache_.release(buf, capacity); }
+    void arm(std::uint8_t* buf, std::uint32_t capacity) { cache_.arm(buf, capacity); }
+    bool disarm() { return cache_.disarm(); }
+
+    bool get_payload(uint32_t size, eprosima::fastrtps::rtps::CacheChange_t& cache_change) override {
+        std::uint32_t capacity = 0;
+        auto* buf = cache_.take_armed_or_acquire(size, capacity);
+        return attach(cache_change, buf, capacity);
+    }
+
+    bool get_payload(eprosima::fastrtps::rtps::SerializedPayload_t& data,
+                     eprosima::fastrtps::rtps::IPayloadPool*& /*data_owner*/,
+                     eprosima::fastrtps::rtps::CacheChange_t& cache_change) override {
+        // 来自其他 pool 的 payload：总是拷贝一份，不与来源共享所有权。
+        std::uint32_t capacity = 0;
+        auto* buf = cache_.acquire(data.length, capacity);
+        if (!attach(cache_change, buf, capacity)) return false;
+        if (data.length > 0) {
+            std::memcpy(cache_change.serializedPayload.data, data.data, data.length);
+        }
+        cache_change.serializedPayload.length = data.length;
+        cache_change.serializedPayload.encapsulation = data.encapsulation;
+        return true;
+    }
+
+    bool release_payload(eprosima::fastrtps::rtps::CacheChange_t& cache_change) override {
+        auto& payload = cache_change.serializedPayload;
+        cache_.release(payload.data, payload.max_size);
+        // SerializedPayload_t 析构会 free(data)：必须先置空。
+        payload.data = nullptr;
+        payload.length = 0;
+        payload.max_size = 0;
+        payload.pos = 0;
+        cache_change.payload_owner(nullptr);
+        return true;
+    }
+
+private:
+    bool attach(eprosima::fastrtps::rtps::CacheChange_t& cache_change, std::uint8_t* buf, std::uint32_t capacity) {
+        auto& payload = cache_change.serializedPayload;
+        payload.data = buf;
+        payload.max_size = capacity;
+        payload.length = 0;
+        payload.pos = 0;
+        cache_change.payload_owner(this);
+        return true;
+    }
+
+    FastddsWriterBufferCache cache_;
+};
+
+// WaitSet 接收线程组：每个线程一个 WaitSet（FastDDS 不允许多线程同时 wait 同一个 WaitSet），
+// reader 的 ReadCondition 挂到当前 reader 最少的线程上；同一 reader 始终由同一线程取样，保持顺序。
+// - 线程按 threading.<name> 设置放置/调度策略（cpus 非空时覆盖其 CPU 集），命名为 "<name>/<i>"。
+// - 同名组在进程内共享（弱引用注册表），最后一个 channel 释放时停止线程；name 为空时不共享。
+class FastddsReceiveGroup final {
+public:
+    using Drain = std::function<void()>;
+
+    static std::shared_ptr<FastddsReceiveGroup> acquire(const std::string& group, std::size_t threads, const std::vector<int>& cpus) {
+        const std::string pool = group.empty() ? std::string("fastdds_recv") : group;
+        if (group.empty()) return std::shared_ptr<FastddsReceiveGroup>(new FastddsReceiveGroup(pool, threads, cpus));
+
+        static std::mutex registry_mutex;
+        static std::unordered_map<std::string, std::weak_ptr<FastddsReceiveGroup>> registry;
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        auto& slot = registry[group];
+        if (auto existing = slot.lock()) return existing;
+        std::shared_ptr<FastddsReceiveGroup> created(new FastddsReceiveGroup(pool, threads, cpus));
+        slot = created;
+        return created;
+    }
+
+    ~FastddsReceiveGroup() {
+        for (auto& w : workers_) {
+            w->stop.store(true, std::memory_order_release);
+            w->wake.set_trigger_value(true);
+        }
+        for (auto& w : workers_) {
+            if (!w->thread.joinable()) continue;
+            // 最后一个 channel 在本组的接收线程内析构：不能 join 自己；线程持有 Worker，退出时自行释放。
+            if (w->thread.get_id() == std::this_thread::get_id()) {
+                w->thread.detach();
+            } else {
+                w->thread.join();
+            }
+        }
+    }
+
+    bool attach(eprosima::fastdds::dds::DataReader* reader, Drain drain) {
+        using namespace eprosima::fastdds::dds;
+        auto* cond = reader->create_readcondition(NOT_READ_SAMPLE_STATE, ANY_VIEW_STATE, ANY_INSTANCE_STATE);
+        if (!cond) return false;
+
+        Worker* target = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& w : workers_) {
+                if (!target || w->readers < target->readers) target = w.get();
+            }
+            ++target->readers;
+            assigned_[reader] = target;
+        }
+        {
+            std::lock_guard<std::mutex> lock(target->mutex);
+            target->bindings[cond] = Binding{reader, cond, std::move(drain)};
+        }
+        // attach 会唤醒正在 wait 的线程；挂上时已有样本也会立即触发。
+        if (target->waitset.attach_condition(*cond) != eprosima::fastrtps::types::ReturnCode_t::RETCODE_OK) {
+            detach(reader);
+            return false;
+        }
+        return true;
+    }
+
+    // 返回时该 reader 不再被取样，其 ReadCondition 已删除。
+    // 返回 false 表示在该 reader 自己的 drain 内调用（handler 内析构 channel）：drain 仍在栈上，
+    // reader 与 listener 须通过 retire() 交给接收线程，在 drain 返回后再删除。
+    bool detach(eprosima::fastdds::dds::DataReader* reader) {
+        Worker* w = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = assigned_.find(reader);
+            if (it == assigned_.end()) return true;
+            w = it->second;
+            --w->readers;
+            assigned_.erase(it);
+        }
+
+        eprosima::fastdds::dds::ReadCondition* cond = nullptr;
+        bool in_drain = false;
+        {
+            std::unique_lock<std::mutex> lock(w->mutex);
+            // extract 不移动元素：接收线程可能仍在执行该 binding 的 drain。
+            decltype(w->bindings)::node_type node;
+            for (auto it = w->bindings.begin(); it != w->bindings.end(); ++it) {
+                if (it->second.reader != reader) continue;
+                cond = it->second.cond;
+                node = w->bindings.extract(it);
+                break;
+            }
+            if (cond) (void)w->waitset.detach_condition(*cond);
+            if (w->thread.get_id() != std::this_thread::get_id()) {
+                w->idle.wait(lock, [&] { return w->running != reader; });
+            } else {
+                in_drain = w->running == reader;
+                // 在 drain 内部退订（handler 内析构 channel）：drain 返回后再释放。
+                if (node) w->retired.push_back(std::move(node));
+            }
+        }
+        if (cond) (void)reader->delete_readcondition(cond);
+        return !in_drain;
+    }
+
+    // 仅在 detach() 返回 false 后、于同一接收线程内调用：fn 在当前 drain 返回后由该线程执行。
+    // 组随后即使被释放，线程也会先执行完 fn 再退出（线程自己持有 Worker）。
+    void retire(std::function<void()> fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& w : workers_) {
+            if (w->thread.get_id() != std::this_thread::get_id()) continue;
+            std::lock_guard<std::mutex> wlock(w->mutex);
+            w->deferred.push_back(std::move(fn));
+            return;
+        }
+    }
+
+private:
+    struct Binding {
+        eprosima::fastdds::dds::DataReader* reader{nullptr};
+        eprosima::fastdds::dds::ReadCondition* cond{nullptr};
+        Drain drain;
+    };
+
+    struct Worker {
+        // waitset 先于 wake 析构。
+        eprosima::fastdds::dds::GuardCondition wake;
+        eprosima::fastdds::dds::WaitSet waitset;
+        std::atomic<bool> stop{false};
+        std::thread thread;
+
+        std::mutex mutex;
+        std::condition_variable idle;
+        std::unordered_map<const eprosima::fastdds::dds::Condition*, Binding> bindings;
+        std::vector<decltype(bindings)::node_type> retired;
+        // 当前 drain 返回后执行的延迟释放（见 retire()）。
+        std::vector<std::function<void()>> deferred;
+        // 正在取样的 reader（detach 据此等待）。
+        eprosima::fastdds::dds::DataReader* running{nullptr};
+
+        // 仅在组的 mutex_ 下访问。
+        std::size_t readers{0};
+    };
+
+    FastddsReceiveGroup(const std::string& pool, std::size_t threads, const std::vector<int>& cpus) {
+        internal::ThreadPolicy policy = internal::thread_policy_for(pool);
+        if (!cpus.empty()) policy.cpus = cpus;
+        const std::size_t n = std::max<std::size_t>(threads, 1);
+        workers_.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            auto w = std::make_shared<Worker>();
+            (void)w->waitset.attach_condition(w->wake);
+            w->thread = std::thread([w, pool, policy, i] {
+                internal::apply_thread_policy(pool, policy, i);
+                run(*w);
+            });
+            workers_.push_back(std::move(w));
+        }
+    }
+
+    static void run(Worker& w) {
+        eprosima::fastdds::dds::ConditionSeq active;
+        while (!w.stop.load(std::memory_order_acquire)) {
+            active.clear();
+            if (w.waitset.wait(active, eprosima::fastrtps::c_TimeInfinite) != eprosima::fastrtps::types::ReturnCode_t::RETCODE_OK) {
+                continue;
+            }
+            for (auto* c : active) {
+                if (c == &w.wake) {
+                    w.wake.set_trigger_value(false);
+                    continue;
+                }
+                Drain* drain = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(w.mutex);
+                    auto it = w.bindings.find(c);
+                    if (it == w.bindings.end()) continue;
+                    w.running = it->second.reader;
+                    drain = &it->second.drain;
+                }
+                // 取样与派发在锁外进行；detach 等待 running 复位后才删除 binding 所属的 reader。
+                (*drain)();
+                decltype(w.retired) retired;
+                decltype(w.deferred) deferred;
+                {
+                    std::lock_guard<std::mutex> lock(w.mutex);
+                    w.running = nullptr;
+                    retired.swap(w.retired);
+                    deferred.swap(w.deferred);
+                }
+                for (auto& fn : deferred) fn();
+                w.idle.notify_all();
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<eprosima::fastdds::dds::DataReader*, Worker*> assigned_;
+    // 线程各自持有自己的 Worker（见析构）。
+    std::vector<std::shared_ptr<Worker>> workers_;
+};
+
+} // namespace internal
+
+void FastddsChannel::Loan::release() {
+    if (pool_ && buffer_) {
+        pool_->release(buffer_, buffer_capacity_);
+    }
+    pool_.reset();
+    buffer_ = nullptr;
+    buffer_capacity_ = 0;
+    data_ = nullptr;
+    capacity_ = 0;
+    size_ = 0;
+}
+
 FastddsChannel::FastddsChannel(int domain_id, std::string topic, const ChannelQoS& qos, std::size_t max_payload)
     : FastddsChannel(domain_id, std::move(topic), qos, max_payload, /*enable_pub=*/true, /*enable_sub=*/true) {}
 
@@ -367,32 +827,40 @@ FastddsChannel::FastddsChannel(int domain_id,
     // - 若设置 WXZ_FASTDDS_PROFILES_FILE，则该文件必须可读且可加载。
     // - 若设置 WXZ_FASTDDS_PARTICIPANT_PROFILE，则该 profile 必须存在。
     // 细节见内部 factory。
-    participant_ = wxz::core::internal::create_fastdds_participant_from_env(domain_id_);
-    if (!participant_) {
+    //
+    // participant（及其 Publisher/Subscriber）在进程内按 domain + profile 共享，
+    // 每个 channel 只创建自己的 topic/writer/reader，避免“每个 channel 一个 participant”带来的发现风暴与线程膨胀。
+    //
+    // 吞吐流控器只能在创建 participant 时注册：使用流控的 channel 按流控器名落到对应的共享 participant 上。
+    internal::FastddsFlowControllerSpec flow;
+    if (qos.flow_bytes_per_period > 0) {
+        if (qos.realtime_hint) {
+            // realtime 强制同步发布，而流控器只作用于异步发布。
+            wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                                 "fastdds flow control ignored for realtime channel",
+                                                 {{"topic", topic_name_}});
+        } else {
+            flow.bytes_per_period = qos.flow_bytes_per_period;
+            flow.period_ms = std::max<std::uint64_t>(qos.flow_period_ms, 1);
+            flow.name = !qos.flow_controller.empty()
+                            ? qos.flow_controller
+                            : "wxz_flow_" + std::to_string(flow.bytes_per_period) + "_" + std::to_string(flow.period_ms);
+        }
+    }
+    shared_participant_ = wxz::core::internal::FastddsParticipantPool::instance().acquire(
+        domain_id_, flow.name.empty() ? nullptr : &flow);
+    if (!shared_participant_) {
         throw std::runtime_error("FastDDS participant create failed");
     }
-
-    // TypeSupport 持有 TopicDataType 指针的所有权。
-    type_ = TypeSupport(new RawMsgType(max_payload_));
-    type_.register_type(participant_);
-
-    // 重要：始终同时创建 Publisher 与 Subscriber 实体。
-    // 经验上，如果 participant 只创建单边实体，在某些 FastDDS 配置下跨进程端点匹配会不稳定。
+    participant_ = shared_participant_->participant();
+    // 重要：共享 participant 始终同时持有 Publisher 与 Subscriber 实体（见 pool）。
     // 同时我们仍通过“按需只创建 writer/reader”来避免自订阅。
-    publisher_ = participant_->create_publisher(PublisherQos(), nullptr);
-    if (!publisher_) {
-        cleanup();
-        throw std::runtime_error("FastDDS publisher create failed");
-    }
+    publisher_ = shared_participant_->publisher();
+    subscriber_ = shared_participant_->subscriber();
 
-    subscriber_ = participant_->create_subscriber(SubscriberQos(), nullptr);
-    if (!subscriber_) {
-        cleanup();
-        throw std::runtime_error("FastDDS subscriber create failed");
-    }
-
-    TopicQos tqos;
-    topic_ = participant_->create_topic(topic_name_.c_str(), type_->getName(), tqos);
+    // TypeSupport 持有 TopicDataType 指针的所有权；若该 participant 已注册过同名类型，会替换为共享实例。
+    type_ = TypeSupport(new RawMsgType(max_payload_, qos.key_offset, qos.key_size));
+    topic_ = shared_participant_->acquire_topic(topic_name_, type_);
     if (!topic_) {
         cleanup();
         throw std::runtime_error("FastDDS topic create failed");
@@ -405,8 +873,44 @@ FastddsChannel::FastddsChannel(int domain_id,
             wqos.publish_mode().kind = SYNCHRONOUS_PUBLISH_MODE;
         }
 
+    // 大数据模式：每个样本只预分配 plan.size_hint，更大的帧按内存策略分配；unset 时沿用 FastDDS/XML profile 的策略。
+    const PayloadMemoryPlan plan = plan_payload_memory(qos, max_payload_, topic_name_);
+    if (plan.policy != ChannelQoS::MemoryPolicy::unset) {
+        wqos.endpoint().history_memory_policy = to_fastdds_memory_policy(plan.policy);
+        rqos.endpoint().history_memory_policy = to_fastdds_memory_policy(plan.policy);
+    }
+    if (qos.data_sharing) {
+        // AUTO：同主机且双方都满足条件时走共享内存，否则回退到普通传输。
+        wqos.data_sharing().automatic();
+        rqos.data_sharing().automatic();
+    }
+    const auto& flow_controller = shared_participant_->flow_controller();
+    if (!flow_controller.name.empty()) {
+        // 流控器只作用于异步发布：write() 入队后由 FastDDS 发送线程按预算分片发出。
+        wqos.publish_mode().kind = ASYNCHRONOUS_PUBLISH_MODE;
+        wqos.publish_mode().flow_controller_name = flow_controller.name.c_str();
+    }
+
+    // 共享类型的尺寸提示在创建端点时读取：持锁调整为本 channel 的尺寸提示后再创建。
+    // 局部持有一份引用：失败路径的 cleanup() 会释放 shared_participant_，锁必须先于 participant 析构。
+    const auto shared = shared_participant_;
+    std::lock_guard<std::mutex> endpoint_lock(shared->endpoint_mutex());
+    static_cast<RawMsgType*>(type_.get())->set_size_hint(plan.size_hint, qos.data_sharing);
+
     if (enable_pub) {
-        writer_ = publisher_->create_datawriter(topic_, wqos, nullptr);
+        // buffer 基础尺寸与 RawMsgType 的 m_typeSize 一致（尺寸提示 + CDR 头/对齐余量）。
+        payload_pool_ = std::make_shared<internal::FastddsWriterPayloadPool>(
+            static_cast<std::uint32_t>(plan.size_hint + kRawTypeSlackBytes),
+            static_cast<std::uint32_t>(max_payload_ + kRawTypeSlackBytes));
+        if (env_falsy("WXZ_FASTDDS_WRITER_POOL") || qos.data_sharing) {
+            // 排障（WXZ_FASTDDS_WRITER_POOL=0）或 data-sharing（由 FastDDS 的共享内存 pool 提供 payload）：
+            // 使用 FastDDS 自己的 payload pool；loan() 仍可用，但 publish 时会多一次拷贝。
+            writer_ = publisher_->create_datawriter(topic_, wqos, nullptr);
+        } else {
+            // 自定义 payload pool 与 data-sharing 互斥（未开启 data_sharing 时 raw 类型按变长类型处理，本就不满足其条件）。
+            wqos.data_sharing().off();
+            writer_ = publisher_->create_datawriter(topic_, wqos, nullptr, StatusMask::all(), payload_pool_);
+        }
         if (!writer_) {
             cleanup();
             throw std::runtime_error("FastDDS writer create failed");
@@ -414,27 +918,43 @@ FastddsChannel::FastddsChannel(int domain_id,
     }
 
     if (enable_sub) {
-        listener_ = std::make_unique<ReaderListener>(handlers_,
-                                                     handler_mutex_,
-                                                     messages_received_,
-                                                     recv_drop_pool_exhausted_,
-                                                     recv_drop_dispatch_rejected_,
-                                                     topic_name_,
-                                                     stopping_,
-                                                     callbacks_inflight_,
-                                                     max_payload_,
-                                                     leased_pool_,
-                                                     leased_handler_,
-                                                     leased_executor_,
-                                                     leased_strand_);
-        reader_ = subscriber_->create_datareader(topic_, rqos, listener_.get());
+        recv_pool_ = std::make_shared<internal::FastddsRecvPayloadPool>(topic_name_);
+        listener_ = std::make_unique<ReaderListener>(handlers_, handler_mutex_, recv_pool_, topic_name_, max_payload_, qos.recv_batch);
+        // 内容过滤：reader 建在 ContentFilteredTopic 上；表达式先在本地编译一次，语法错误直接抛出。
+        TopicDescription* reader_topic = topic_;
+        if (!qos.filter_expression.empty()) {
+            try {
+                (void)internal::compile_raw_bytes_filter(qos.filter_expression, qos.filter_parameters, qos.key_offset, qos.key_size);
+            } catch (...) {
+                cleanup();
+                throw;
+            }
+            // 过滤 topic 名在 participant 内唯一（同一 topic 上可有多个不同过滤条件的 reader）。
+            static std::atomic<std::uint64_t> next_filter_id{1};
+            const std::string filter_name = topic_name_ + "/wxz_filter/" + std::to_string(next_filter_id.fetch_add(1));
+            filtered_topic_ = participant_->create_contentfilteredtopic(
+                filter_name, topic_, qos.filter_expression, qos.filter_parameters, internal::kRawBytesFilterClass);
+            if (!filtered_topic_) {
+                cleanup();
+                throw std::runtime_error("FastDDS content filtered topic create failed");
+            }
+            reader_topic = filtered_topic_;
+        }
+
+        const bool own_threads = qos.recv_threads > 0 || !qos.recv_group.empty();
+        reader_ = subscriber_->create_datareader(reader_topic, rqos, own_threads ? nullptr : listener_.get());
         if (!reader_) {
             cleanup();
             throw std::runtime_error("FastDDS reader create failed");
         }
+        if (own_threads) {
+            recv_group_ = internal::FastddsReceiveGroup::acquire(qos.recv_group, qos.recv_threads, qos.recv_cpus);
+            if (!recv_group_->attach(reader_, [l = listener_.get(), r = reader_]() { l->on_data_available(r); })) {
+                cleanup();
+                throw std::runtime_error("FastDDS read condition create failed");
+            }
+        }
     }
-
-    constructed_ok_ = true;
 }
 
 FastddsChannel::~FastddsChannel() { cleanup(); }
@@ -446,23 +966,19 @@ eprosima::fastdds::dds::DataWriter* FastddsChannel::data_writer() const {
 
 void FastddsChannel::cleanup() {
     using namespace eprosima::fastdds::dds;
-    if (!participant_) {
+    if (!shared_participant_) {
         type_.reset();
         return;
     }
 
     stopping_.store(true, std::memory_order_release);
+    auto* listener = static_cast<ReaderListener*>(listener_.get());
+    if (listener) listener->stop();
+    eprosima::fastdds::dds::DataReader* recv_reader = nullptr;
 
     // 重要：尽早清空所有用户 handler，避免 teardown 期间仍执行回调。
     // 当 channel 作为 service 内的栈对象时，这一点尤其关键。
-    {
-        std::lock_guard<std::mutex> lock(handler_mutex_);
-        handlers_.clear();
-        leased_handler_ = {};
-        leased_pool_ = nullptr;
-        leased_executor_ = nullptr;
-        leased_strand_ = nullptr;
-    }
+    update_handlers([](HandlerTable& t) { t = HandlerTable{}; });
 
     {
         // 尽力做安全防护：在 teardown 过程中阻止回调进入用户 handler。
@@ -474,12 +990,20 @@ void FastddsChannel::cleanup() {
                 // 忽略
             }
         }
+        recv_reader = reader_;
     }
 
+    // 接收线程模式：从组中摘除 reader 并等待正在进行的取样结束（不持 entity_mutex_：handler 可能正在 publish）。
+    // 在本 reader 自己的 drain 内析构（handler 里销毁 channel）时无法等待：reader、listener 以及
+    // 它们依赖的过滤 topic/topic 交给接收线程在 drain 返回后删除（listener 不引用 channel 的成员）。
+    std::shared_ptr<internal::FastddsReceiveGroup> recv_group = std::move(recv_group_);
+    const bool in_drain = recv_group && recv_reader && !recv_group->detach(recv_reader);
+
     // 在删除 DDS 实体前，短暂等待正在执行中的 listener 回调结束。
     // 这用于缓解短生命周期进程里观察到的“退出时偶发 SIGSEGV”的竞态。
+    // 在自己的 drain 内时当前回调本身就在计数中，等待没有意义。
     auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
-    while (callbacks_inflight_.load(std::memory_order_relaxed) != 0 && std::chrono::steady_clock::now() < deadline) {
+    while (!in_drain && listener && listener->inflight() != 0 && std::chrono::steady_clock::now() < deadline) {
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
@@ -487,6 +1011,31 @@ void FastddsChannel::cleanup() {
         // 序列化 teardown 与 publish()。
         std::lock_guard<std::mutex> lock(entity_mutex_);
 
+        if (in_drain) {
+            // 删除顺序与下面相同：reader → listener → 过滤 topic → topic。持有共享 participant 与类型直到删除完成。
+            recv_group->retire([shared = shared_participant_,
+                                participant = participant_,
+                                subscriber = subscriber_,
+                                reader = std::exchange(reader_, nullptr),
+                                listener = listener_.release(),
+                                filtered = std::exchange(filtered_topic_, nullptr),
+                                topic = std::exchange(topic_, nullptr),
+                                type = type_]() {
+                try {
+                    if (subscriber && reader) (void)subscriber->delete_datareader(reader);
+                } catch (...) {
+                    // 忽略
+                }
+                delete listener;
+                try {
+                    if (filtered) (void)participant->delete_contentfilteredtopic(filtered);
+                } catch (...) {
+                    // 忽略
+                }
+                if (topic) shared->release_topic(topic);
+            });
+        }
+
         // 优先采用显式 teardown 顺序，而不是 delete_contained_entities()。
         // 实际上，当 DataReader 回调仍在执行时，某些 FastDDS 版本/配置对隐式 teardown 更敏感。
         if (subscriber_ && reader_) {
@@ -498,60 +1047,40 @@ void FastddsChannel::cleanup() {
             reader_ = nullptr;
         }
         listener_.reset();
-
-        if (publisher_ && writer_) {
+        if (filtered_topic_) {
             try {
-                (void)publisher_->delete_datawriter(writer_);
-            } catch (...) {
-                // 忽略
-            }
-            writer_ = nullptr;
-        }
-
-        // 额外安全措施：先删 publisher/subscriber，再删 topic。
-        if (participant_ && subscriber_) {
-            try {
-                (void)participant_->delete_subscriber(subscriber_);
+                (void)participant_->delete_contentfilteredtopic(filtered_topic_);
             } catch (...) {
                 // 忽略
             }
-            subscriber_ = nullptr;
+            filtered_topic_ = nullptr;
         }
 
-        if (participant_ && publisher_) {
+        if (publisher_ && writer_) {
             try {
-                (void)participant_->delete_publisher(publisher_);
+                (void)publisher_->delete_datawriter(writer_);
             } catch (...) {
                 // 忽略
             }
-            publisher_ = nullptr;
+            writer_ = nullptr;
         }
+        // 未发布的 loan 仍持有 pool 引用；这里只断开 channel 侧的引用。
+        payload_pool_.reset();
 
-        if (participant_ && topic_) {
-            try {
-                (void)participant_->delete_topic(topic_);
-            } catch (...) {
-                // 忽略
-            }
+        // Publisher/Subscriber 由共享 participant 持有；这里只释放本 channel 的 topic 引用。
+        if (topic_) {
+            shared_participant_->release_topic(topic_);
             topic_ = nullptr;
         }
-
-        // 注意：在部分环境中，我们观察到删除 DomainParticipant 时（PDP/TopicPayloadPool teardown）
-        // libfastrtps 内部会出现退出时偶发崩溃。
-        // 对于压测工具/短生命周期进程，允许选择一种“规避崩溃”的 teardown：跳过 participant 删除，
-        // 依赖进程退出时由 OS 回收资源。
-        const bool safe_teardown = env_truthy("WXZ_FASTDDS_SAFE_TEARDOWN");
-        if (!safe_teardown || !constructed_ok_) {
-            try {
-                (void)DomainParticipantFactory::get_instance()->delete_participant(participant_);
-            } catch (...) {
-                // 忽略
-            }
-        }
-
+        publisher_ = nullptr;
+        subscriber_ = nullptr;
         participant_ = nullptr;
         type_.reset();
-        constructed_ok_ = false;
+
+        // 最后一个引用释放时由 pool 删除 Publisher/Subscriber/participant。
+        // 注意：在部分环境中，我们观察到删除 DomainParticipant 时（PDP/TopicPayloadPool teardown）
+        // libfastrtps 内部会出现退出时偶发崩溃；WXZ_FASTDDS_SAFE_TEARDOWN=1 的规避策略同样由 pool 执行。
+        shared_participant_.reset();
     }
 }
 
@@ -561,13 +1090,58 @@ bool FastddsChannel::publish(const std::uint8_t* data, std::size_t size) {
     std::lock_guard<std::mutex> lock(entity_mutex_);
     if (stopping_.load(std::memory_order_relaxed)) return false;
     if (!writer_) return false;
-    auto t0 = std::chrono::steady_clock::now();
+    // 直接引用调用方字节：serialize 时一次拷贝进 payload，不再经过中间 vector。
+    RawMsg msg;
+    msg.view = data;
+    msg.view_size = size;
+    return write_sample(&msg, size);
+}
+
+FastddsChannel::Loan FastddsChannel::loan() {
+    Loan l;
+    if (stopping_.load(std::memory_order_acquire)) return l;
+    std::lock_guard<std::mutex> lock(entity_mutex_);
+    if (!writer_ || !payload_pool_) return l;
+    l.pool_ = payload_pool_;
+    // 按 max_payload 取整帧 buffer（大数据模式下类型尺寸提示可能更小）。
+    l.buffer_ = payload_pool_->acquire(static_cast<std::uint32_t>(max_payload_ + kRawTypeSlackBytes), l.buffer_capacity_);
+    l.data_ = l.buffer_ + kRawHeaderBytes;
+    l.capacity_ = max_payload_;
+    return l;
+}
+
+bool FastddsChannel::publish(Loan&& loan) {
+    Loan l = std::move(loan);
+    if (!l.valid()) return false;
+    if (stopping_.load(std::memory_order_acquire)) return false;
+    if (l.size() > l.capacity()) return false;
+    std::lock_guard<std::mutex> lock(entity_mutex_);
+    if (stopping_.load(std::memory_order_relaxed)) return false;
+    if (!writer_ || l.pool_ != payload_pool_) return false;
+
     RawMsg msg;
-    msg.data.resize(size);
-    if (size > 0) {
-        std::memcpy(msg.data.data(), data, size);
+    msg.view = l.data();
+    msg.view_size = l.size();
+
+    payload_pool_->arm(l.buffer_, l.buffer_capacity_);
+    const bool ok = write_sample(&msg, l.size());
+    if (payload_pool_->disarm()) {
+        // buffer 已被 DataWriter 取走（写失败时也由它归还）；loan 放弃所有权。
+        l.buffer_ = nullptr;
     }
-    auto rc = writer_->write(&msg);
+    // 失败已由 write_sample 计入 publish_fail（与拷贝路径一致）；loaned 只统计成功发布的 loan。
+    if (ok) {
+        ++publish_loaned_;
+        if (wxz::core::has_metrics_sink()) {
+            wxz::core::metrics().counter_add("wxz.fastdds.publish.loaned", 1, {{"topic", topic_name_}});
+        }
+    }
+    return ok;
+}
+
+bool FastddsChannel::write_sample(void* sample, std::size_t size) {
+    auto t0 = std::chrono::steady_clock::now();
+    auto rc = writer_->write(sample);
 
     // FastDDS API 差异：取决于安装的版本/头文件，DataWriter::write 可能返回 bool 或类似 ReturnCode 的枚举。
     bool ok = false;
@@ -584,9 +1158,9 @@ bool FastddsChannel::publish(const std::uint8_t* data, std::size_t size) {
     const auto duration_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count());
     last_publish_duration_ns_.store(duration_ns);
     if (ok || tolerate) {
-        publish_success_.fetch_add(1);
+        ++publish_success_;
     } else {
-        publish_fail_.fetch_add(1);
+        ++publish_fail_;
         using eprosima::fastdds::dds::PublicationMatchedStatus;
         PublicationMatchedStatus st{};
         try {
@@ -631,96 +1205,135 @@ void FastddsChannel::subscribe_on(Strand& strand, Handler handler) {
 }
 
 void FastddsChannel::subscribe_leased(ByteBufferPool& pool, LeasedHandler handler) {
-    std::lock_guard<std::mutex> lock(handler_mutex_);
-    leased_pool_ = &pool;
-    leased_handler_ = std::move(handler);
-    leased_executor_ = nullptr;
-    leased_strand_ = nullptr;
+    update_handlers([&](HandlerTable& t) {
+        t.leased_pool = &pool;
+        t.leased_handler = std::move(handler);
+        t.leased_executor = nullptr;
+        t.leased_strand = nullptr;
+    });
 }
 
 void FastddsChannel::subscribe_leased_on(ByteBufferPool& pool, Executor& ex, LeasedHandler handler) {
-    std::lock_guard<std::mutex> lock(handler_mutex_);
-    leased_pool_ = &pool;
-    leased_handler_ = std::move(handler);
-    leased_executor_ = &ex;
-    leased_strand_ = nullptr;
+    update_handlers([&](HandlerTable& t) {
+        t.leased_pool = &pool;
+        t.leased_handler = std::move(handler);
+        t.leased_executor = &ex;
+        t.leased_strand = nullptr;
+    });
 }
 
 void FastddsChannel::subscribe_leased_on(ByteBufferPool& pool, Strand& strand, LeasedHandler handler) {
-    std::lock_guard<std::mutex> lock(handler_mutex_);
-    leased_pool_ = &pool;
-    leased_handler_ = std::move(handler);
-    leased_executor_ = nullptr;
-    leased_strand_ = &strand;
+    update_handlers([&](HandlerTable& t) {
+        t.leased_pool = &pool;
+        t.leased_handler = std::move(handler);
+        t.leased_executor = nullptr;
+        t.leased_strand = &strand;
+    });
 }
 
 Subscription FastddsChannel::subscribe_scoped(Handler handler, void* owner) {
     std::uint64_t id = 0;
-    {
-        std::lock_guard<std::mutex> lock(handler_mutex_);
+    update_handlers([&](HandlerTable& t) {
         id = next_handler_id_++;
-        handlers_.push_back(HandlerEntry{.id = id, .owner = owner, .executor = nullptr, .strand = nullptr, .handler = std::move(handler)});
-    }
+        t.entries.push_back(HandlerEntry{.id = id, .owner = owner, .executor = nullptr, .strand = nullptr, .handler = std::move(handler)});
+    });
 
     return Subscription([this, id]() {
-        std::lock_guard<std::mutex> lock(handler_mutex_);
-        handlers_.erase(std::remove_if(handlers_.begin(), handlers_.end(), [&](const HandlerEntry& e) {
-                           return e.id == id;
-                       }),
-                       handlers_.end());
+        update_handlers([&](HandlerTable& t) {
+            t.entries.erase(std::remove_if(t.entries.begin(), t.entries.end(), [&](const HandlerEntry& e) {
+                                return e.id == id;
+                            }),
+                            t.entries.end());
+        });
     });
 }
 
 Subscription FastddsChannel::subscribe_scoped_on(Executor& ex, Handler handler, void* owner) {
     std::uint64_t id = 0;
-    {
-        std::lock_guard<std::mutex> lock(handler_mutex_);
+    update_handlers([&](HandlerTable& t) {
         id = next_handler_id_++;
-        handlers_.push_back(HandlerEntry{.id = id, .owner = owner, .executor = &ex, .strand = nullptr, .handler = std::move(handler)});
-    }
+        t.entries.push_back(HandlerEntry{.id = id, .owner = owner, .executor = &ex, .strand = nullptr, .handler = std::move(handler)});
+    });
 
     return Subscription([this, id]() {
-        std::lock_guard<std::mutex> lock(handler_mutex_);
-        handlers_.erase(std::remove_if(handlers_.begin(), handlers_.end(), [&](const HandlerEntry& e) {
-                           return e.id == id;
-                       }),
-                       handlers_.end());
+        update_handlers([&](HandlerTable& t) {
+            t.entries.erase(std::remove_if(t.entries.begin(), t.entries.end(), [&](const HandlerEntry& e) {
+                                return e.id == id;
+                            }),
+                            t.entries.end());
+        });
     });
 }
 
 Subscription FastddsChannel::subscribe_scoped_on(Strand& strand, Handler handler, void* owner) {
     std::uint64_t id = 0;
-    {
-        std::lock_guard<std::mutex> lock(handler_mutex_);
+    update_handlers([&](HandlerTable& t) {
         id = next_handler_id_++;
-        handlers_.push_back(HandlerEntry{.id = id, .owner = owner, .executor = nullptr, .strand = &strand, .handler = std::move(handler)});
-    }
+        t.entries.push_back(HandlerEntry{.id = id, .owner = owner, .executor = nullptr, .strand = &strand, .handler = std::move(handler)});
+    });
 
     return Subscription([this, id]() {
-        std::lock_guard<std::mutex> lock(handler_mutex_);
-        handlers_.erase(std::remove_if(handlers_.begin(), handlers_.end(), [&](const HandlerEntry& e) {
-                           return e.id == id;
-                       }),
-                       handlers_.end());
+        update_handlers([&](HandlerTable& t) {
+            t.entries.erase(std::remove_if(t.entries.begin(), t.entries.end(), [&](const HandlerEntry& e) {
+                                return e.id == id;
+                            }),
+                            t.entries.end());
+        });
     });
 }
 
 void FastddsChannel::unsubscribe_owner(void* owner) {
     if (!owner) return;
-    std::lock_guard<std::mutex> lock(handler_mutex_);
-    handlers_.erase(std::remove_if(handlers_.begin(), handlers_.end(), [&](const HandlerEntry& e) {
-                       return e.owner == owner;
-                   }),
-                   handlers_.end());
+    update_handlers([&](HandlerTable& t) {
+        t.entries.erase(std::remove_if(t.entries.begin(), t.entries.end(), [&](const HandlerEntry& e) {
+                            return e.owner == owner;
+                        }),
+                        t.entries.end());
+    });
 }
 
 void FastddsChannel::stop() {
-    std::lock_guard<std::mutex> lock(handler_mutex_);
-    handlers_.clear();
-    leased_handler_ = {};
-    leased_pool_ = nullptr;
-    leased_executor_ = nullptr;
-    leased_strand_ = nullptr;
+    update_handlers([](HandlerTable& t) { t = HandlerTable{}; });
+}
+
+void FastddsChannel::update_handlers(const std::function<void(HandlerTable&)>& mutate) {
+    std::shared_ptr<const HandlerTable> old;
+    {
+        std::lock_guard<std::mutex> lock(handler_mutex_);
+        auto next = std::make_shared<HandlerTable>(*handlers_);
+        mutate(*next);
+        next->has_dispatched = std::any_of(next->entries.begin(), next->entries.end(), [](const HandlerEntry& e) {
+            return e.handler && (e.executor || e.strand);
+        });
+        old = std::exchange(handlers_, std::move(next));
+    }
+    // 旧表（及其中的 handler）在锁外释放：可能是最后一个引用。
+}
+
+std::uint64_t FastddsChannel::messages_received() const {
+    const auto* l = static_cast<const ReaderListener*>(listener_.get());
+    return l ? l->received() : 0;
+}
+
+std::uint64_t FastddsChannel::recv_drop_pool_exhausted() const {
+    const auto* l = static_cast<const ReaderListener*>(listener_.get());
+    return l ? l->drop_pool_exhausted() : 0;
+}
+
+std::uint64_t FastddsChannel::recv_drop_dispatch_rejected() const {
+    const auto* l = static_cast<const ReaderListener*>(listener_.get());
+    return l ? l->drop_dispatch_rejected() : 0;
+}
+
+std::uint64_t FastddsChannel::recv_buffer_allocations() const {
+    return recv_pool_ ? recv_pool_->allocations() : 0;
+}
+
+bool FastddsChannel::set_filter_parameters(const std::vector<std::string>& parameters) {
+    std::lock_guard<std::mutex> lock(entity_mutex_);
+    if (!filtered_topic_ || stopping_.load(std::memory_order_acquire)) return false;
+    // FastDDS 经过滤工厂重新编译；参数非法时返回错误并保留原参数。
+    return filtered_topic_->set_expression_parameters(parameters) == eprosima::fastrtps::types::ReturnCode_t::RETCODE_OK;
 }
 
 void FastddsChannel::apply_qos(const ChannelQoS& qos,
@@ -753,6 +1366,19 @@ void FastddsChannel::apply_qos(const ChannelQoS& qos,
         rqos.resource_limits().max_samples = static_cast<int32_t>(history_depth);
     }
 
+    if (qos.key_size > 0) {
+        // keyed：depth 按实例计算，总样本上限随实例数放大（<=0 在 FastDDS 中表示不限）。
+        const auto depth = static_cast<int32_t>(history_depth);
+        const auto instances = static_cast<int32_t>(std::min<std::size_t>(qos.max_instances, std::numeric_limits<int32_t>::max()));
+        const std::int64_t total = instances > 0 ? static_cast<std::int64_t>(depth) * instances : 0;
+        const auto max_samples = static_cast<int32_t>(std::min<std::int64_t>(total, std::numeric_limits<int32_t>::max()));
+        for (auto* limits : {&wqos.resource_limits(), &rqos.resource_limits()}) {
+            limits->max_instances = instances;
+            limits->max_samples_per_instance = depth;
+            limits->max_samples = max_samples;
+        }
+    }
+
     if (qos.latency_budget_ns > 0) {
         wqos.latency_budget().duration = to_duration(qos.latency_budget_ns);
         rqos.latency_budget().duration = to_duration(qos.latency_budget_ns);
@@ -769,6 +1395,11 @@ void FastddsChannel::apply_qos(const ChannelQoS& qos,
     if (qos.time_based_filter_ns > 0) {
         rqos.time_based_filter().minimum_separation = to_duration(qos.time_based_filter_ns);
     }
+    if (qos.recv_batch > 0) {
+        // 默认每次 take 最多 32 条：按批量大小放宽，否则 recv_batch 被静默截断。
+        rqos.reader_resource_limits().max_samples_per_read =
+            static_cast<int32_t>(std::min<std::size_t>(qos.recv_batch, std::numeric_limits<int32_t>::max()));
+    }
 
     DurabilityQosPolicyKind dur = qos.durability == ChannelQoS::Durability::transient_local
                                       ? TRANSIENT_LOCAL_DURABILITY_QOS
@@ -7,10 +7,13 @@
 #include <fastdds/dds/domain/qos/DomainParticipantQos.hpp>
 
 #include <fastdds/rtps/attributes/ServerAttributes.h>
+#include <fastdds/rtps/flowcontrol/FlowControllerDescriptor.hpp>
 #include <fastdds/rtps/transport/UDPv4TransportDescriptor.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
@@ -121,9 +124,20 @@ void apply_udp_only_transport(eprosima::fastdds::dds::DomainParticipantQos& qos)
 eprosima::fastdds::dds::DomainParticipant* create_participant_with_fallback(
     int domain_id,
     eprosima::fastdds::dds::DomainParticipantFactory* factory,
-    eprosima::fastdds::dds::DomainParticipantQos qos) {
+    eprosima::fastdds::dds::DomainParticipantQos qos,
+    const FastddsFlowControllerSpec* flow) {
     using namespace eprosima::fastdds::dds;
 
+    if (flow && !flow->name.empty()) {
+        auto fc = std::make_shared<eprosima::fastdds::rtps::FlowControllerDescriptor>();
+        fc->name = flow->name.c_str();
+        fc->scheduler = eprosima::fastdds::rtps::FlowControllerSchedulerPolicy::FIFO;
+        fc->max_bytes_per_period = static_cast<int32_t>(
+            std::min<std::uint64_t>(flow->bytes_per_period, std::numeric_limits<int32_t>::max()));
+        fc->period_ms = std::max<std::uint64_t>(flow->period_ms, 1);
+        qos.flow_controllers().push_back(fc);
+    }
+
     const bool disable_shm_env = env_truthy("WXZ_FASTDDS_DISABLE_SHM");
     const bool force_udp_env = env_truthy("WXZ_FASTDDS_FORCE_UDP_ONLY");
     const bool force_udp_only = disable_shm_env || force_udp_env;
@@ -182,7 +196,9 @@ void load_fastdds_profiles_from_env_once() {
     });
 }
 
-[[nodiscard]] eprosima::fastdds::dds::DomainParticipant* create_fastdds_participant_from_env(int domain_id) {
+[[nodiscard]] eprosima::fastdds::dds::DomainParticipant* create_fastdds_participant_from_env(
+    int domain_id,
+    const FastddsFlowControllerSpec* flow) {
     using namespace eprosima::fastdds::dds;
 
     load_fastdds_profiles_from_env_once();
@@ -231,7 +247,7 @@ void load_fastdds_profiles_from_env_once() {
             }
         }
 
-        return create_participant_with_fallback(domain_id, factory, qos);
+        return create_participant_with_fallback(domain_id, factory, qos, flow);
     }
 
     // 未显式指定 participant profile：若已加载 install-tree 的 release 默认 profiles，则选择已知默认 profile。
@@ -239,14 +255,14 @@ void load_fastdds_profiles_from_env_once() {
         DomainParticipantQos qos;
         const auto ret = factory->get_participant_qos_from_profile(kDefaultParticipantProfile, qos);
         if (ret == eprosima::fastrtps::types::ReturnCode_t::RETCODE_OK) {
-            return create_participant_with_fallback(domain_id, factory, qos);
+            return create_participant_with_fallback(domain_id, factory, qos, flow);
         }
         // 若因任何原因未找到 profile，则继续走默认路径。
     }
 
     // 让 XML 默认 profile（若存在）生效。
     DomainParticipantQos qos = PARTICIPANT_QOS_DEFAULT;
-    return create_participant_with_fallback(domain_id, factory, qos);
+    return create_participant_with_fallback(domain_id, factory, qos, flow);
 }
 
 } // namespace wxz::core::internal
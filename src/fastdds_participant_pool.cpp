@@ -0,0 +1,234 @@
+#include "internal/fastdds_participant_pool.h"
+
+#include "internal/fastdds_participant_factory.h"
+#include "internal/fastdds_raw_filter.h"
+#include "logger.h"
+#include "observability.h"
+
+#include <fastdds/dds/domain/DomainParticipant.hpp>
+#include <fastdds/dds/domain/DomainParticipantFactory.hpp>
+#include <fastdds/dds/publisher/Publisher.hpp>
+#include <fastdds/dds/publisher/qos/PublisherQos.hpp>
+#include <fastdds/dds/subscriber/Subscriber.hpp>
+#include <fastdds/dds/subscriber/qos/SubscriberQos.hpp>
+#include <fastdds/dds/topic/Topic.hpp>
+#include <fastdds/dds/topic/qos/TopicQos.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+
+namespace wxz::core::internal {
+
+namespace {
+
+bool env_truthy(const char* key) {
+    const char* v = std::getenv(key);
+    if (!v || !*v) return false;
+    return (std::string(v) == "1" || std::string(v) == "true" || std::string(v) == "TRUE" || std::string(v) == "yes" || std::string(v) == "YES");
+}
+
+bool env_falsy(const char* key) {
+    const char* v = std::getenv(key);
+    if (!v || !*v) return false;
+    return (std::string(v) == "0" || std::string(v) == "false" || std::string(v) == "FALSE" || std::string(v) == "no" || std::string(v) == "NO");
+}
+
+// 存活的共享 participant 数量。析构路径不拿 pool 锁（见 acquire()），因此单独计数。
+std::atomic<std::size_t> g_live_participants{0};
+
+void publish_participant_gauge() {
+    if (wxz::core::has_metrics_sink()) {
+        wxz::core::metrics().gauge_set("wxz.fastdds.participants",
+                                       static_cast<double>(g_live_participants.load(std::memory_order_relaxed)),
+                                       {});
+    }
+}
+
+} // namespace
+
+SharedFastddsParticipant::~SharedFastddsParticipant() {
+    using namespace eprosima::fastdds::dds;
+
+    if (participant_) {
+        // 正常情况下所有 channel 已释放各自的 topic；这里兜底清理残留引用。
+        for (auto& kv : topics_) {
+            if (!kv.second.topic) continue;
+            try {
+                (void)participant_->delete_topic(kv.second.topic);
+            } catch (...) {
+                // 忽略
+            }
+        }
+        topics_.clear();
+
+        if (subscriber_) {
+            try {
+                (void)participant_->delete_subscriber(subscriber_);
+            } catch (...) {
+                // 忽略
+            }
+            subscriber_ = nullptr;
+        }
+        if (publisher_) {
+            try {
+                (void)participant_->delete_publisher(publisher_);
+            } catch (...) {
+                // 忽略
+            }
+            publisher_ = nullptr;
+        }
+
+        // 与 FastddsChannel 过去的行为一致：WXZ_FASTDDS_SAFE_TEARDOWN=1 时跳过删除 participant，
+        // 依赖进程退出时由 OS 回收资源（规避部分环境下 libfastrtps 退出时的偶发崩溃）。
+        if (!env_truthy("WXZ_FASTDDS_SAFE_TEARDOWN")) {
+            try {
+                (void)DomainParticipantFactory::get_instance()->delete_participant(participant_);
+            } catch (...) {
+                // 忽略
+            }
+        }
+        participant_ = nullptr;
+
+        g_live_participants.fetch_sub(1, std::memory_order_relaxed);
+        publish_participant_gauge();
+    }
+    types_.clear();
+}
+
+eprosima::fastdds::dds::Topic* SharedFastddsParticipant::acquire_topic(const std::string& topic_name,
+                                                                       eprosima::fastdds::dds::TypeSupport& type) {
+    using namespace eprosima::fastdds::dds;
+    if (!participant_ || !type) return nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const std::string type_name = type->getName();
+    auto tit = types_.find(type_name);
+    if (tit == types_.end()) {
+        if (type.register_type(participant_) != eprosima::fastrtps::types::ReturnCode_t::RETCODE_OK) {
+            return nullptr;
+        }
+        types_.emplace(type_name, type);
+    } else {
+        // 同名类型只能注册一次：让调用方与已注册实例共享同一个 TopicDataType。
+        type = tit->second;
+    }
+
+    auto it = topics_.find(topic_name);
+    if (it != topics_.end()) {
+        // 同名 topic 只能对应一个类型（例如 keyed 与非 keyed 的 raw 类型不可混用）。
+        if (it->second.topic->get_type_name() != type_name) return nullptr;
+        ++it->second.refs;
+        return it->second.topic;
+    }
+
+    Topic* topic = participant_->create_topic(topic_name, type_name, TOPIC_QOS_DEFAULT);
+    if (!topic) return nullptr;
+    topics_.emplace(topic_name, TopicRef{topic, 1});
+    return topic;
+}
+
+void SharedFastddsParticipant::release_topic(eprosima::fastdds::dds::Topic* topic) {
+    if (!topic || !participant_) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = topics_.begin(); it != topics_.end(); ++it) {
+        if (it->second.topic != topic) continue;
+        if (--it->second.refs == 0) {
+            try {
+                (void)participant_->delete_topic(topic);
+            } catch (...) {
+                // 忽略
+            }
+            topics_.erase(it);
+        }
+        return;
+    }
+}
+
+FastddsParticipantPool& FastddsParticipantPool::instance() {
+    static FastddsParticipantPool pool;
+    return pool;
+}
+
+std::size_t FastddsParticipantPool::size() const {
+    return g_live_participants.load(std::memory_order_relaxed);
+}
+
+std::shared_ptr<SharedFastddsParticipant> FastddsParticipantPool::create_entry(int domain_id,
+                                                                              const std::string& profile,
+                                                                              const FastddsFlowControllerSpec* flow) {
+    using namespace eprosima::fastdds::dds;
+
+    std::shared_ptr<SharedFastddsParticipant> entry(new SharedFastddsParticipant(domain_id, profile));
+    if (flow) entry->flow_ = *flow;
+
+    // 流控器描述只引用 entry 自己持有的名字（生命周期与 participant 一致）。
+    entry->participant_ = create_fastdds_participant_from_env(domain_id, entry->flow_.name.empty() ? nullptr : &entry->flow_);
+    if (!entry->participant_) return nullptr;
+    g_live_participants.fetch_add(1, std::memory_order_relaxed);
+
+    // 重要：始终同时创建 Publisher 与 Subscriber 实体。
+    // 经验上，如果 participant 只创建单边实体，在某些 FastDDS 配置下跨进程端点匹配会不稳定。
+    entry->publisher_ = entry->participant_->create_publisher(PublisherQos(), nullptr);
+    if (!entry->publisher_) return nullptr; // 析构负责回收 participant
+
+    entry->subscriber_ = entry->participant_->create_subscriber(SubscriberQos(), nullptr);
+    if (!entry->subscriber_) return nullptr;
+
+    // raw 字节 topic 的内容过滤类：同一进程内的写端与读端都注册，FastDDS 才能在写端过滤。
+    if (entry->participant_->register_content_filter_factory(kRawBytesFilterClass, &raw_bytes_filter_factory()) !=
+        eprosima::fastrtps::types::ReturnCode_t::RETCODE_OK) {
+        wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                             "fastdds content filter factory register failed",
+                                             {{"domain", std::to_string(domain_id)}});
+    }
+
+    publish_participant_gauge();
+    return entry;
+}
+
+std::shared_ptr<SharedFastddsParticipant> FastddsParticipantPool::acquire(int domain_id,
+                                                                         const FastddsFlowControllerSpec* flow) {
+    std::string profile;
+    if (const char* v = std::getenv("WXZ_FASTDDS_PARTICIPANT_PROFILE")) {
+        profile = v;
+    }
+
+    if (env_falsy("WXZ_FASTDDS_SHARED_PARTICIPANT")) {
+        return create_entry(domain_id, profile, flow);
+    }
+
+    // 注意：SharedFastddsParticipant 的析构（最后一个 channel 释放时）不获取本锁；
+    // 已过期但仍在 teardown 的 entry 会被直接替换为新 participant。
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto key = std::make_tuple(domain_id, profile, flow ? flow->name : std::string());
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        if (auto existing = it->second.lock()) {
+            const auto& have = existing->flow_controller();
+            if (flow && (have.bytes_per_period != flow->bytes_per_period || have.period_ms != flow->period_ms)) {
+                wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                                     "fastdds flow controller params differ from first creator; keeping existing",
+                                                     {{"flow_controller", flow->name},
+                                                      {"bytes_per_period", std::to_string(have.bytes_per_period)},
+                                                      {"period_ms", std::to_string(have.period_ms)}});
+            }
+            return existing;
+        }
+    }
+
+    auto entry = create_entry(domain_id, profile, flow);
+    if (!entry) return nullptr;
+    entries_[key] = entry;
+
+    wxz::core::Logger::getInstance().info(std::string("FastDDS shared participant created") +
+                                         " domain=" + std::to_string(domain_id) +
+                                         " profile=" + (profile.empty() ? "<auto>" : profile) +
+                                         (flow ? " flow_controller=" + flow->name : std::string()) +
+                                         " live=" + std::to_string(size()));
+    return entry;
+}
+
+} // namespace wxz::core::internal
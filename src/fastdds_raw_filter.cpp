@@ -0,0 +1,110 @@
+#include "internal/fastdds_raw_filter.h"
+
+#include "logger.h"
+
+#include <fastdds/dds/topic/IContentFilter.hpp>
+#include <fastdds/dds/topic/IContentFilterFactory.hpp>
+#include <fastdds/dds/topic/TopicDataType.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace wxz::core::internal {
+
+namespace {
+
+// 与 FastddsChannel 的 raw payload 布局一致：Encapsulation(4) + len(uint32=4) + bytes。
+constexpr std::size_t kRawHeaderBytes = 8;
+
+using eprosima::fastrtps::types::ReturnCode_t;
+
+class RawBytesFilter final : public eprosima::fastdds::dds::IContentFilter {
+public:
+    RawBytesFilter(std::string expression, std::shared_ptr<const RawBytesFilterProgram> program)
+        : expression_(std::move(expression)), program_(std::move(program)) {}
+
+    bool evaluate(const SerializedPayload& payload, const FilterSampleInfo& /*sample_info*/, const GUID_t& /*reader_guid*/) const override {
+        if (payload.length < kRawHeaderBytes) return false;
+        // 参数可能在运行时被替换：按快照求值。
+        const auto program = std::atomic_load(&program_);
+        return evaluate_raw_bytes_filter(*program, payload.data + kRawHeaderBytes, payload.length - kRawHeaderBytes);
+    }
+
+    // 仅由工厂调用（FastDDS 串行化同一 topic 的表达式/参数变更）。
+    const std::string& expression() const { return expression_; }
+    void update(std::string expression, std::shared_ptr<const RawBytesFilterProgram> program) {
+        expression_ = std::move(expression);
+        std::atomic_store(&program_, std::move(program));
+    }
+
+private:
+    std::string expression_;
+    std::shared_ptr<const RawBytesFilterProgram> program_;
+};
+
+class RawBytesFilterFactory final : public eprosima::fastdds::dds::IContentFilterFactory {
+public:
+    ReturnCode_t create_content_filter(const char* filter_class_name,
+                                       const char* type_name,
+                                       const eprosima::fastdds::dds::TopicDataType* /*data_type*/,
+                                       const char* filter_expression,
+                                       const ParameterSeq& filter_parameters,
+                                       eprosima::fastdds::dds::IContentFilter*& filter_instance) override {
+        if (!filter_class_name || std::strcmp(filter_class_name, kRawBytesFilterClass) != 0) {
+            return ReturnCode_t::RETCODE_BAD_PARAMETER;
+        }
+        std::size_t key_offset = 0;
+        std::size_t key_size = 0;
+        if (!type_name || !parse_raw_bytes_type_name(type_name, key_offset, key_size)) {
+            return ReturnCode_t::RETCODE_BAD_PARAMETER;
+        }
+
+        auto* existing = static_cast<RawBytesFilter*>(filter_instance);
+        // filter_expression 为空指针表示只有参数变化。
+        if (!filter_expression && !existing) return ReturnCode_t::RETCODE_BAD_PARAMETER;
+        std::string expression = filter_expression ? std::string(filter_expression) : existing->expression();
+
+        std::vector<std::string> params;
+        params.reserve(filter_parameters.length());
+        for (decltype(filter_parameters.length()) i = 0; i < filter_parameters.length(); ++i) {
+            params.emplace_back(filter_parameters[i] ? filter_parameters[i] : "");
+        }
+
+        std::shared_ptr<const RawBytesFilterProgram> program;
+        try {
+            program = compile_raw_bytes_filter(expression, params, key_offset, key_size);
+        } catch (const std::invalid_argument& e) {
+            wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                                 "fastdds content filter rejected",
+                                                 {{"type", type_name}, {"error", e.what()}});
+            return ReturnCode_t::RETCODE_BAD_PARAMETER;
+        }
+
+        if (existing) {
+            existing->update(std::move(expression), std::move(program));
+        } else {
+            filter_instance = new RawBytesFilter(std::move(expression), std::move(program));
+        }
+        return ReturnCode_t::RETCODE_OK;
+    }
+
+    ReturnCode_t delete_content_filter(const char* filter_class_name, eprosima::fastdds::dds::IContentFilter* filter_instance) override {
+        if (!filter_class_name || std::strcmp(filter_class_name, kRawBytesFilterClass) != 0) {
+            return ReturnCode_t::RETCODE_BAD_PARAMETER;
+        }
+        delete static_cast<RawBytesFilter*>(filter_instance);
+        return ReturnCode_t::RETCODE_OK;
+    }
+};
+
+} // namespace
+
+eprosima::fastdds::dds::IContentFilterFactory& raw_bytes_filter_factory() {
+    // 故意不析构：participant 可能晚于静态对象析构（WXZ_FASTDDS_SAFE_TEARDOWN）。
+    static auto* factory = new RawBytesFilterFactory();
+    return *factory;
+}
+
+} // namespace wxz::core::internal
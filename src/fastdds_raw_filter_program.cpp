@@ -0,0 +1,314 @@
+#include "internal/fastdds_raw_filter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+// 过滤表达式的编译/求值与 raw 类型名编解码。不依赖 FastDDS（便于单测）；FastDDS 过滤类见 fastdds_raw_filter.cpp。
+
+namespace wxz::core::internal {
+
+namespace {
+
+constexpr const char* kRawTypeName = "WxzRawBytes";
+constexpr const char* kRawKeyedTypePrefix = "WxzRawBytesKeyed_";
+
+struct Node {
+    enum class Kind { Or, And, Not, Match };
+    Kind kind{Kind::Match};
+    std::vector<Node> kids;
+    // Match：bytes[off, off+len) 等于 values 之一（negate 时取反）。
+    std::size_t off{0};
+    std::size_t len{0};
+    bool negate{false};
+    std::vector<std::string> values;
+};
+
+bool eval(const Node& n, const std::uint8_t* data, std::size_t size) {
+    switch (n.kind) {
+        case Node::Kind::Or:
+            return std::any_of(n.kids.begin(), n.kids.end(), [&](const Node& k) { return eval(k, data, size); });
+        case Node::Kind::And:
+            return std::all_of(n.kids.begin(), n.kids.end(), [&](const Node& k) { return eval(k, data, size); });
+        case Node::Kind::Not:
+            return !eval(n.kids.front(), data, size);
+        case Node::Kind::Match:
+            break;
+    }
+    if (n.off > size || n.len > size - n.off) return false;
+    const auto* field = data + n.off;
+    bool hit = false;
+    for (const auto& v : n.values) {
+        // 编译期已按字段长度补 0，长度不等的值直接不相等。
+        if (v.size() == n.len && std::memcmp(field, v.data(), n.len) == 0) {
+            hit = true;
+            break;
+        }
+    }
+    return hit != n.negate;
+}
+
+int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 参数/字面量的字节：'text'、0xHEX 或原样文本。
+std::string decode_value(const std::string& v) {
+    if (v.size() >= 2 && v.front() == '\'' && v.back() == '\'') {
+        std::string out;
+        for (std::size_t i = 1; i + 1 < v.size(); ++i) {
+            out.push_back(v[i]);
+            if (v[i] == '\'' && i + 2 < v.size() && v[i + 1] == '\'') ++i;
+        }
+        return out;
+    }
+    if (v.size() > 2 && v[0] == '0' && (v[1] == 'x' || v[1] == 'X')) {
+        if ((v.size() - 2) % 2 != 0) throw std::invalid_argument("odd number of hex digits: " + v);
+        std::string out;
+        for (std::size_t i = 2; i < v.size(); i += 2) {
+            const int hi = hex_digit(v[i]);
+            const int lo = hex_digit(v[i + 1]);
+            if (hi < 0 || lo < 0) throw std::invalid_argument("bad hex literal: " + v);
+            out.push_back(static_cast<char>((hi << 4) | lo));
+        }
+        return out;
+    }
+    return v;
+}
+
+class Parser {
+public:
+    Parser(const std::string& expr, const std::vector<std::string>& params, std::size_t key_offset, std::size_t key_size)
+        : s_(expr), params_(params), key_offset_(key_offset), key_size_(key_size) {}
+
+    Node parse() {
+        Node n = parse_or();
+        skip_ws();
+        if (pos_ != s_.size()) fail("unexpected trailing input");
+        return n;
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::invalid_argument("filter expression: " + what + " at offset " + std::to_string(pos_) + ": " + s_);
+    }
+
+    void skip_ws() {
+        while (pos_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[pos_]))) ++pos_;
+    }
+
+    bool eat(char c) {
+        skip_ws();
+        if (pos_ < s_.size() && s_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!eat(c)) fail(std::string("expected '") + c + "'");
+    }
+
+    // 关键字/标识符（大小写不敏感），只在整词匹配时消费。
+    bool eat_word(const char* w) {
+        skip_ws();
+        const std::size_t n = std::strlen(w);
+        if (pos_ + n > s_.size()) return false;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (std::toupper(static_cast<unsigned char>(s_[pos_ + i])) != w[i]) return false;
+        }
+        if (pos_ + n < s_.size()) {
+            const char next = s_[pos_ + n];
+            if (std::isalnum(static_cast<unsigned char>(next)) || next == '_') return false;
+        }
+        pos_ += n;
+        return true;
+    }
+
+    std::size_t parse_uint() {
+        skip_ws();
+        const std::size_t start = pos_;
+        std::size_t v = 0;
+        while (pos_ < s_.size() && std::isdigit(static_cast<unsigned char>(s_[pos_]))) {
+            v = v * 10 + static_cast<std::size_t>(s_[pos_] - '0');
+            if (v > (1u << 30)) fail("number too large");
+            ++pos_;
+        }
+        if (pos_ == start) fail("expected number");
+        return v;
+    }
+
+    Node parse_or() {
+        Node first = parse_and();
+        if (!eat_word("OR")) return first;
+        Node n;
+        n.kind = Node::Kind::Or;
+        n.kids.push_back(std::move(first));
+        do {
+            n.kids.push_back(parse_and());
+        } while (eat_word("OR"));
+        return n;
+    }
+
+    Node parse_and() {
+        Node first = parse_unary();
+        if (!eat_word("AND")) return first;
+        Node n;
+        n.kind = Node::Kind::And;
+        n.kids.push_back(std::move(first));
+        do {
+            n.kids.push_back(parse_unary());
+        } while (eat_word("AND"));
+        return n;
+    }
+
+    Node parse_unary() {
+        if (eat_word("NOT")) {
+            Node n;
+            n.kind = Node::Kind::Not;
+            n.kids.push_back(parse_unary());
+            return n;
+        }
+        if (eat('(')) {
+            Node n = parse_or();
+            expect(')');
+            return n;
+        }
+        return parse_match();
+    }
+
+    Node parse_match() {
+        Node n;
+        n.kind = Node::Kind::Match;
+        if (eat_word("KEY")) {
+            if (key_size_ == 0) fail("'key' used on a topic without key (ChannelQoS::key_size == 0)");
+            n.off = key_offset_;
+            n.len = key_size_;
+        } else if (eat_word("BYTES")) {
+            expect('[');
+            n.off = parse_uint();
+            expect(':');
+            n.len = parse_uint();
+            expect(']');
+            if (n.len == 0) fail("empty byte range");
+        } else {
+            fail("expected 'key' or 'bytes[offset:size]'");
+        }
+
+        if (eat('=')) {
+            n.values.push_back(parse_value(n.len));
+        } else if (eat('<')) {
+            expect('>');
+            n.negate = true;
+            n.values.push_back(parse_value(n.len));
+        } else if (eat_word("IN")) {
+            expect('(');
+            do {
+                n.values.push_back(parse_value(n.len));
+            } while (eat(','));
+            expect(')');
+        } else {
+            fail("expected '=', '<>' or 'IN'");
+        }
+        return n;
+    }
+
+    std::string parse_value(std::size_t field_len) {
+        skip_ws();
+        std::string raw;
+        if (eat('%')) {
+            const std::size_t idx = parse_uint();
+            if (idx >= params_.size()) fail("parameter %" + std::to_string(idx) + " not provided");
+            raw = params_[idx];
+        } else if (pos_ < s_.size() && s_[pos_] == '\'') {
+            const std::size_t start = pos_++;
+            for (;;) {
+                if (pos_ >= s_.size()) fail("unterminated string literal");
+                if (s_[pos_] == '\'') {
+                    if (pos_ + 1 < s_.size() && s_[pos_ + 1] == '\'') {
+                        pos_ += 2;
+                        continue;
+                    }
+                    ++pos_;
+                    break;
+                }
+                ++pos_;
+            }
+            raw = s_.substr(start, pos_ - start);
+        } else if (pos_ + 1 < s_.size() && s_[pos_] == '0' && (s_[pos_ + 1] == 'x' || s_[pos_ + 1] == 'X')) {
+            const std::size_t start = pos_;
+            pos_ += 2;
+            while (pos_ < s_.size() && hex_digit(s_[pos_]) >= 0) ++pos_;
+            raw = s_.substr(start, pos_ - start);
+        } else {
+            fail("expected %N, 'text' or 0xHEX");
+        }
+
+        std::string v = decode_value(raw);
+        // 短值右侧补 0；长值保留原长（求值时不相等）。
+        if (v.size() < field_len) v.resize(field_len, '\0');
+        return v;
+    }
+
+    const std::string& s_;
+    const std::vector<std::string>& params_;
+    const std::size_t key_offset_;
+    const std::size_t key_size_;
+    std::size_t pos_{0};
+};
+
+} // namespace
+
+class RawBytesFilterProgram {
+public:
+    explicit RawBytesFilterProgram(Node root) : root_(std::move(root)) {}
+    bool evaluate(const std::uint8_t* data, std::size_t size) const { return eval(root_, data, size); }
+
+private:
+    Node root_;
+};
+
+std::shared_ptr<const RawBytesFilterProgram> compile_raw_bytes_filter(const std::string& expression,
+                                                                     const std::vector<std::string>& parameters,
+                                                                     std::size_t key_offset,
+                                                                     std::size_t key_size) {
+    Parser p(expression, parameters, key_offset, key_size);
+    return std::make_shared<const RawBytesFilterProgram>(p.parse());
+}
+
+bool evaluate_raw_bytes_filter(const RawBytesFilterProgram& program, const std::uint8_t* data, std::size_t size) {
+    return program.evaluate(data, size);
+}
+
+std::string raw_bytes_type_name(std::size_t key_offset, std::size_t key_size) {
+    if (key_size == 0) return kRawTypeName;
+    return std::string(kRawKeyedTypePrefix) + std::to_string(key_offset) + "_" + std::to_string(key_size);
+}
+
+bool parse_raw_bytes_type_name(const std::string& type_name, std::size_t& key_offset, std::size_t& key_size) {
+    key_offset = 0;
+    key_size = 0;
+    if (type_name == kRawTypeName) return true;
+    const std::string prefix = kRawKeyedTypePrefix;
+    if (type_name.compare(0, prefix.size(), prefix) != 0) return false;
+    const std::string rest = type_name.substr(prefix.size());
+    const auto sep = rest.find('_');
+    if (sep == std::string::npos || sep == 0 || sep + 1 >= rest.size()) return false;
+    const auto all_digits = [](const std::string& s) {
+        return !s.empty() && std::all_of(s.begin(), s.end(), [](unsigned char c) { return std::isdigit(c) != 0; });
+    };
+    const std::string off = rest.substr(0, sep);
+    const std::string size = rest.substr(sep + 1);
+    if (!all_digits(off) || !all_digits(size) || off.size() > 9 || size.size() > 9) return false;
+    key_offset = static_cast<std::size_t>(std::stoul(off));
+    key_size = static_cast<std::size_t>(std::stoul(size));
+    return key_size > 0;
+}
+
+} // namespace wxz::core::internal
@@ -1,10 +1,13 @@
 #include "inproc_channel.h"
 
+#include "executor.h"
+#include "internal/futex.h"
+#include "internal/thread_policy.h"
 #include "observability.h"
+#include "strand.h"
 
 #include <algorithm>
 #include <chrono>
-#include <condition_variable>
 #include <stdexcept>
 #include <thread>
 
@@ -32,39 +35,74 @@ void BufferHandle::release() {
 
 // BufferPool（缓冲池）--------------------------------------------------------
 
+namespace {
+
+// 空闲链表头：低 32 位为节点索引，高 32 位为版本号（每次成功修改 +1）。
+// 只比较索引的 CAS 存在 ABA：线程读到 head=A、next=B 后被抢占，期间 A 被取走、B 被取走、A 又被归还，
+// CAS 仍会成功并把已被占用的 B 装回链表头，导致同一 buffer 被两个持有者拿到。带版本号后该 CAS 必然失败。
+constexpr std::uint32_t kFreeNil = 0xFFFFFFFFu;
+
+constexpr std::uint64_t pack_free_head(std::uint32_t idx, std::uint32_t tag) {
+    return (static_cast<std::uint64_t>(tag) << 32) | idx;
+}
+
+constexpr std::uint32_t free_head_index(std::uint64_t head) { return static_cast<std::uint32_t>(head); }
+
+constexpr std::uint32_t free_head_tag(std::uint64_t head) { return static_cast<std::uint32_t>(head >> 32); }
+
+} // namespace
+
 BufferPool::BufferPool(std::size_t capacity, std::size_t buffer_bytes)
-    : nodes_(capacity), free_head_(0), buffer_bytes_(buffer_bytes) {
+    : nodes_(capacity), free_head_(pack_free_head(kFreeNil, 0)), buffer_bytes_(buffer_bytes) {
+    if (capacity >= kFreeNil) {
+        throw std::invalid_argument("BufferPool capacity must be below 2^32-1");
+    }
     for (std::size_t i = 0; i < capacity; ++i) {
         nodes_[i].buf.resize(buffer_bytes_, 0);
-        nodes_[i].next.store(i + 1, std::memory_order_relaxed);
+        nodes_[i].next.store(i + 1 < capacity ? static_cast<std::uint32_t>(i + 1) : kFreeNil, std::memory_order_relaxed);
         nodes_[i].len.store(0, std::memory_order_relaxed);
+        nodes_[i].stamp_ns.store(0, std::memory_order_relaxed);
+        nodes_[i].refs.store(0, std::memory_order_relaxed);
     }
     if (!nodes_.empty()) {
-        nodes_.back().next.store(static_cast<std::size_t>(-1), std::memory_order_relaxed);
-    } else {
-        free_head_.store(static_cast<std::size_t>(-1), std::memory_order_relaxed);
+        free_head_.store(pack_free_head(0, 0), std::memory_order_relaxed);
     }
 }
 
 BufferHandle BufferPool::acquire() {
-    std::size_t head = free_head_.load(std::memory_order_acquire);
-    while (head != static_cast<std::size_t>(-1)) {
-        Node& n = nodes_[head];
-        std::size_t next = n.next.load(std::memory_order_relaxed);
-        if (free_head_.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    std::uint64_t head = free_head_.load(std::memory_order_acquire);
+    while (free_head_index(head) != kFreeNil) {
+        const std::uint32_t idx = free_head_index(head);
+        Node& n = nodes_[idx];
+        // next 可能已被并发的 acquire/release 改写（读到的是旧值）；此时 head 的版本号必然已变，下面的 CAS 会失败重试。
+        const std::uint32_t next = n.next.load(std::memory_order_relaxed);
+        if (free_head_.compare_exchange_weak(head,
+                                             pack_free_head(next, free_head_tag(head) + 1),
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
             n.len.store(0, std::memory_order_relaxed);
-            return BufferHandle(this, head, n.buf.data(), n.buf.size());
+            n.refs.store(1, std::memory_order_relaxed);
+            return BufferHandle(this, idx, n.buf.data(), n.buf.size());
         }
     }
     return {};
 }
 
+void BufferPool::retain(std::size_t idx, std::uint32_t n) {
+    if (idx >= nodes_.size()) return;
+    nodes_[idx].refs.fetch_add(n, std::memory_order_relaxed);
+}
+
 void BufferPool::release(std::size_t idx) {
     if (idx >= nodes_.size()) return;
-    std::size_t head = free_head_.load(std::memory_order_acquire);
+    // acq_rel：最后一个持有者归还前，其它订阅对 buffer 的读取都已完成。
+    if (nodes_[idx].refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    std::uint64_t head = free_head_.load(std::memory_order_acquire);
+    std::uint64_t desired = 0;
     do {
-        nodes_[idx].next.store(head, std::memory_order_relaxed);
-    } while (!free_head_.compare_exchange_weak(head, idx, std::memory_order_acq_rel, std::memory_order_acquire));
+        nodes_[idx].next.store(free_head_index(head), std::memory_order_relaxed);
+        desired = pack_free_head(static_cast<std::uint32_t>(idx), free_head_tag(head) + 1);
+    } while (!free_head_.compare_exchange_weak(head, desired, std::memory_order_acq_rel, std::memory_order_acquire));
 }
 
 std::uint8_t* BufferPool::data(std::size_t idx) {
@@ -82,6 +120,16 @@ void BufferPool::set_committed_size(std::size_t idx, std::size_t size) {
     nodes_[idx].len.store(size, std::memory_order_release);
 }
 
+std::uint64_t BufferPool::timestamp_ns(std::size_t idx) const {
+    if (idx >= nodes_.size()) return 0;
+    return nodes_[idx].stamp_ns.load(std::memory_order_acquire);
+}
+
+void BufferPool::set_timestamp_ns(std::size_t idx, std::uint64_t ns) {
+    if (idx >= nodes_.size()) return;
+    nodes_[idx].stamp_ns.store(ns, std::memory_order_release);
+}
+
 // IndexQueue（索引队列）------------------------------------------------------
 
 IndexQueue::IndexQueue(std::size_t capacity) : buffer_(capacity), mask_(capacity - 1), capacity_(capacity) {
@@ -134,6 +182,12 @@ bool IndexQueue::dequeue(std::size_t& v) {
     }
 }
 
+std::size_t IndexQueue::size_approx() const {
+    const std::size_t enq = enqueue_pos_.load(std::memory_order_relaxed);
+    const std::size_t deq = dequeue_pos_.load(std::memory_order_relaxed);
+    return enq > deq ? enq - deq : 0;
+}
+
 std::size_t IndexQueue::dequeue_batch(std::size_t* out, std::size_t max_items) {
     std::size_t count = 0;
     while (count < max_items) {
@@ -146,12 +200,79 @@ std::size_t IndexQueue::dequeue_batch(std::size_t* out, std::size_t max_items) {
 
 // InprocChannel（进程内通道）-------------------------------------------------
 
+namespace {
+std::uint64_t steady_now_ns() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+} // namespace
+
 InprocChannel::InprocChannel(std::size_t capacity, std::size_t buffer_bytes, const ChannelQoS& qos)
-    : qos_(qos), pool_(capacity, buffer_bytes), queue_(capacity) {}
+    : InprocChannel(capacity, buffer_bytes, qos, Options{}) {}
+
+InprocChannel::InprocChannel(std::size_t capacity, std::size_t buffer_bytes, const ChannelQoS& qos, const Options& opts)
+    : qos_(qos),
+      pool_(capacity, buffer_bytes),
+      queue_(capacity),
+      // 单核上自旋只会抢占发布端的 CPU。
+      spin_iterations_(std::thread::hardware_concurrency() > 1 ? opts.spin_iterations : 0) {
+    if (opts.dispatch_threads > 0) {
+        Executor::Options eo;
+        eo.threads = opts.dispatch_threads;
+        // 每个订阅同一时刻最多一个排空任务，任务数不超过订阅数。
+        eo.max_queue = 0;
+        eo.block_when_full = false;
+        eo.name = "inproc_dispatch";
+        dispatch_pool_ = std::make_unique<Executor>(eo);
+        dispatch_pool_->start();
+    }
+}
 
 InprocChannel::~InprocChannel() { stop(); }
 
-BufferHandle InprocChannel::allocate() { return pool_.acquire(); }
+BufferHandle InprocChannel::allocate() {
+    BufferHandle h = pool_.acquire();
+    // keep_last：buffer 都积压在队列里时覆盖最旧样本，发布端不因慢订阅者而失败。
+    while (!h.valid() && qos_.history > 0 && evict_oldest()) {
+        h = pool_.acquire();
+    }
+    return h;
+}
+
+bool InprocChannel::evict_oldest() {
+    std::size_t idx = 0;
+    if (queue_.dequeue(idx)) {
+        pool_.release(idx);
+        count_drop(recv_drop_history_, "wxz.inproc.recv.drop_history", 1);
+        return true;
+    }
+    // 订阅队列模式：buffer 被积压最多的订阅占着，从它的队列头丢弃。
+    std::shared_ptr<const SubscriberList> subs;
+    {
+        std::lock_guard<std::mutex> lock(handler_mutex_);
+        subs = queued_;
+    }
+    SubscriberQueue* victim = nullptr;
+    std::size_t backlog = 0;
+    for (const auto& sub : *subs) {
+        const std::size_t n = sub->queue.size_approx();
+        if (n > backlog) {
+            backlog = n;
+            victim = sub.get();
+        }
+    }
+    if (!victim || !victim->queue.dequeue(idx)) return false;
+    pool_.release(idx);
+    count_drop(recv_drop_history_, "wxz.inproc.recv.drop_history", 1);
+    return true;
+}
+
+void InprocChannel::count_drop(std::atomic<std::uint64_t>& counter, const char* metric, std::uint64_t n) {
+    counter.fetch_add(n, std::memory_order_relaxed);
+    if (wxz::core::has_metrics_sink()) {
+        wxz::core::metrics().counter_add(metric, static_cast<double>(n), {});
+    }
+}
 
 bool InprocChannel::publish(BufferHandle&& h) {
     if (!h.valid()) return false;
@@ -160,19 +281,45 @@ bool InprocChannel::publish(BufferHandle&& h) {
     if (pool_.committed_size(idx) == 0) {
         pool_.set_committed_size(idx, h.size());
     }
+    pool_.set_timestamp_ns(idx, steady_now_ns());
     // 所有权转移到队列；避免重复释放
     h.pool_ = nullptr;
     h.data_ = nullptr;
     h.capacity_ = 0;
     h.size_ = 0;
-    bool ok = queue_.enqueue(idx);
+
+    std::shared_ptr<const SubscriberList> subs;
+    bool serial = false;
+    bool unsubscribed = false;
+    {
+        std::lock_guard<std::mutex> lock(handler_mutex_);
+        subs = queued_;
+        // 尚无任何订阅时先缓存在共享队列：首个 subscribe() 由分发线程排空，
+        // 首个订阅队列（dispatch_threads>0 或 subscribe_on）由 hand_over_backlog() 转交。
+        unsubscribed = handlers_.empty() && subs->empty();
+        serial = !handlers_.empty() || subs->empty();
+    }
+    if (!subs->empty()) fan_out(idx, *subs);
+
+    bool ok = true;
+    if (serial) {
+        ok = queue_.enqueue(idx);
+        while (!ok && qos_.history > 0 && evict_oldest()) {
+            ok = queue_.enqueue(idx);
+        }
+    } else {
+        pool_.release(idx); // 发布端自身的引用；订阅队列各持一份
+    }
     if (ok) {
-        cv_.notify_one();
+        if (serial) wake_dispatcher();
+        // 与 add_queued() 的 “换表 -> 转交” 配对：入队期间恰好到来的首个订阅队列也不会漏掉这条缓存。
+        if (unsubscribed) hand_over_backlog();
         ++publish_success_;
         if (wxz::core::has_metrics_sink()) {
             wxz::core::metrics().counter_add("wxz.inproc.publish.success", 1, {});
         }
     } else {
+        // 只有共享队列这一路失败；已分发到订阅队列的引用不受影响。
         pool_.release(idx);
         ++publish_fail_;
         if (wxz::core::has_metrics_sink()) {
@@ -196,16 +343,28 @@ void InprocChannel::subscribe(Handler handler) {
 }
 
 Subscription InprocChannel::subscribe_scoped(Handler handler, void* owner) {
+    if (dispatch_pool_) {
+        return add_queued(std::move(handler), dispatch_pool_.get(), nullptr, owner);
+    }
+
     std::uint64_t id = 0;
     {
         std::lock_guard<std::mutex> lock(handler_mutex_);
         id = next_handler_id_++;
-        handlers_.push_back(HandlerEntry{.id = id, .owner = owner, .handler = std::move(handler)});
+        HandlerEntry e;
+        e.id = id;
+        e.owner = owner;
+        e.handler = std::move(handler);
+        e.state = std::make_shared<SubscriberState>();
+        handlers_.push_back(std::move(e));
     }
 
     bool expected = false;
     if (running_.compare_exchange_strong(expected, true)) {
-        worker_ = std::thread([this]() { dispatch_loop(); });
+        worker_ = std::thread([this]() {
+            internal::apply_thread_policy("inproc_dispatch", 0);
+            dispatch_loop();
+        });
     }
 
     return Subscription([this, id]() {
@@ -217,19 +376,231 @@ Subscription InprocChannel::subscribe_scoped(Handler handler, void* owner) {
     });
 }
 
+void InprocChannel::subscribe_on(Executor& ex, Handler handler) {
+    auto sub = subscribe_scoped_on(ex, std::move(handler), nullptr);
+    sub.detach();
+}
+
+void InprocChannel::subscribe_on(Strand& strand, Handler handler) {
+    auto sub = subscribe_scoped_on(strand, std::move(handler), nullptr);
+    sub.detach();
+}
+
+Subscription InprocChannel::subscribe_scoped_on(Executor& ex, Handler handler, void* owner) {
+    return add_queued(std::move(handler), &ex, nullptr, owner);
+}
+
+Subscription InprocChannel::subscribe_scoped_on(Strand& strand, Handler handler, void* owner) {
+    return add_queued(std::move(handler), nullptr, &strand, owner);
+}
+
+Subscription InprocChannel::add_queued(Handler handler, Executor* ex, Strand* strand, void* owner) {
+    // keep_last：队列容量取不小于 history 的 2 的幂，深度按 history 截断；keep_all：与共享队列同容量。
+    std::size_t cap = queue_.capacity();
+    if (qos_.history > 0) {
+        cap = 1;
+        while (cap < qos_.history) cap <<= 1;
+    }
+    auto sub = std::make_shared<SubscriberQueue>(cap);
+    sub->owner = owner;
+    sub->handler = std::move(handler);
+    sub->executor = ex;
+    sub->strand = strand;
+    sub->depth = qos_.history;
+    if (qos_.deadline_ns != 0) {
+        // 发布端停发时没有排空任务可以顺带检测 deadline，由周期任务做空闲检测。
+        sub->deadline_executor = ex ? ex : &strand->executor();
+        sub->deadline_timer =
+            sub->deadline_executor
+                ->post_every(std::chrono::nanoseconds(qos_.deadline_ns), [this, sub]() { check_idle_deadline(sub); })
+                .id;
+    }
+
+    std::uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(handler_mutex_);
+        id = next_handler_id_++;
+        sub->id = id;
+        auto next = std::make_shared<SubscriberList>(*queued_);
+        next->push_back(sub);
+        queued_ = std::move(next);
+    }
+    hand_over_backlog();
+    return Subscription([this, id]() { remove_queued([&](const SubscriberQueue& q) { return q.id == id; }); });
+}
+
+void InprocChannel::hand_over_backlog() {
+    // 只有订阅队列、没有默认分发订阅时，共享队列不会再有人按订阅交付（分发池模式下分发线程根本不启动）；
+    // 把首个订阅到来前缓存的消息按发布顺序转交给订阅队列，否则 keep_all 下这些 buffer 会永久占住缓冲池。
+    std::shared_ptr<const SubscriberList> subs;
+    {
+        std::lock_guard<std::mutex> lock(handler_mutex_);
+        if (!handlers_.empty() || queued_->empty()) return;
+        subs = queued_;
+    }
+    std::size_t idx = 0;
+    while (queue_.dequeue(idx)) {
+        fan_out(idx, *subs);
+        pool_.release(idx); // 共享队列持有的引用；订阅队列各持一份
+    }
+}
+
+void InprocChannel::remove_queued(const std::function<bool(const SubscriberQueue&)>& pred) {
+    SubscriberList removed;
+    {
+        std::lock_guard<std::mutex> lock(handler_mutex_);
+        auto next = std::make_shared<SubscriberList>();
+        next->reserve(queued_->size());
+        for (const auto& sub : *queued_) {
+            if (pred(*sub)) {
+                removed.push_back(sub);
+            } else {
+                next->push_back(sub);
+            }
+        }
+        queued_ = std::move(next);
+    }
+    for (const auto& sub : removed) close_queued(sub);
+}
+
+void InprocChannel::close_queued(const std::shared_ptr<SubscriberQueue>& sub) {
+    sub->closed.store(true, std::memory_order_seq_cst);
+    if (sub->deadline_timer != 0) {
+        // 取消后不再触发；已在执行的那一次受下面的 active 等待约束。
+        (void)sub->deadline_executor->cancel(Executor::TimerHandle{sub->deadline_timer});
+    }
+    // 等待仍持有旧快照的发布端、以及正在执行的排空任务退出；handler 内自取消时不能等自己。
+    if (sub->runner.load(std::memory_order_relaxed) != std::this_thread::get_id()) {
+        while (sub->active.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+    }
+    std::size_t idx = 0;
+    while (sub->queue.dequeue(idx)) pool_.release(idx);
+}
+
 void InprocChannel::unsubscribe_owner(void* owner) {
     if (!owner) return;
-    std::lock_guard<std::mutex> lock(handler_mutex_);
-    handlers_.erase(std::remove_if(handlers_.begin(), handlers_.end(), [&](const HandlerEntry& e) {
-                       return e.owner == owner;
-                   }),
-                   handlers_.end());
+    {
+        std::lock_guard<std::mutex> lock(handler_mutex_);
+        handlers_.erase(std::remove_if(handlers_.begin(), handlers_.end(), [&](const HandlerEntry& e) {
+                           return e.owner == owner;
+                       }),
+                       handlers_.end());
+    }
+    remove_queued([&](const SubscriberQueue& q) { return q.owner == owner; });
+}
+
+void InprocChannel::fan_out(std::size_t idx, const SubscriberList& subs) {
+    for (const auto& sub : subs) {
+        sub->active.fetch_add(1, std::memory_order_seq_cst);
+        if (sub->closed.load(std::memory_order_seq_cst)) {
+            sub->active.fetch_sub(1, std::memory_order_seq_cst);
+            continue;
+        }
+
+        pool_.retain(idx);
+        std::size_t old = 0;
+        if (sub->depth > 0) {
+            // keep_last：该订阅积压达到 history 时覆盖最旧样本，只影响这一个订阅。
+            while (sub->queue.size_approx() >= sub->depth && sub->queue.dequeue(old)) {
+                pool_.release(old);
+                count_drop(recv_drop_history_, "wxz.inproc.recv.drop_history", 1);
+            }
+        }
+        bool ok = sub->queue.enqueue(idx);
+        while (!ok && sub->depth > 0 && sub->queue.dequeue(old)) {
+            pool_.release(old);
+            count_drop(recv_drop_history_, "wxz.inproc.recv.drop_history", 1);
+            ok = sub->queue.enqueue(idx);
+        }
+        if (!ok) {
+            pool_.release(idx);
+            count_drop(recv_drop_queue_full_, "wxz.inproc.recv.drop_queue_full", 1);
+        } else if (!sub->scheduled.exchange(true, std::memory_order_acq_rel)) {
+            if (!post_drain(sub)) {
+                sub->scheduled.store(false, std::memory_order_release);
+                count_drop(recv_drop_dispatch_rejected_, "wxz.inproc.recv.drop_dispatch_rejected", 1);
+            }
+        }
+        sub->active.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+bool InprocChannel::post_drain(const std::shared_ptr<SubscriberQueue>& sub) {
+    // 任务只持有订阅的 shared_ptr：订阅关闭后才执行的任务不会再触碰 channel。
+    auto task = [this, sub]() { drain_queued(sub); };
+    if (sub->strand) return sub->strand->post(std::move(task));
+    if (sub->executor) return sub->executor->post(std::move(task));
+    return false;
+}
+
+void InprocChannel::drain_queued(const std::shared_ptr<SubscriberQueue>& sub) {
+    // 先登记 active 再检查 closed（与 close_queued 的顺序相反），保证关闭后 channel 可以安全析构。
+    sub->active.fetch_add(1, std::memory_order_seq_cst);
+    if (sub->closed.load(std::memory_order_seq_cst)) {
+        sub->active.fetch_sub(1, std::memory_order_seq_cst);
+        return;
+    }
+    sub->runner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+    // 每次最多处理一个 quantum 后让出，避免一个忙订阅独占共享的分发线程。
+    constexpr std::size_t kQuantum = 32;
+    std::size_t done = 0;
+    bool repost = false;
+    std::size_t idx = 0;
+    for (;;) {
+        while (done < kQuantum && !sub->closed.load(std::memory_order_relaxed) && sub->queue.dequeue(idx)) {
+            const std::uint64_t stamp = pool_.timestamp_ns(idx);
+            if (qos_.lifespan_ns != 0) {
+                const std::uint64_t now = steady_now_ns();
+                if (now > stamp && now - stamp > qos_.lifespan_ns) {
+                    count_drop(recv_drop_lifespan_, "wxz.inproc.recv.drop_lifespan", 1);
+                    pool_.release(idx);
+                    ++done;
+                    continue;
+                }
+            }
+            if (deliver(sub->state, sub->handler, idx)) {
+                ++messages_delivered_;
+            }
+            pool_.release(idx);
+            ++done;
+        }
+        if (sub->closed.load(std::memory_order_relaxed)) break;
+        if (done >= kQuantum) {
+            repost = true;
+            break;
+        }
+        // 与 fan_out 的 “入队 -> exchange(scheduled)” 配对：清标志后再看一眼队列，防止漏调度。
+        sub->scheduled.store(false, std::memory_order_seq_cst);
+        if (sub->queue.size_approx() == 0 || sub->scheduled.exchange(true, std::memory_order_acq_rel)) break;
+    }
+    sub->runner.store(std::thread::id{}, std::memory_order_relaxed);
+
+    if (sub->closed.load(std::memory_order_relaxed)) {
+        while (sub->queue.dequeue(idx)) pool_.release(idx);
+    } else if (repost && !post_drain(sub)) {
+        sub->scheduled.store(false, std::memory_order_release);
+        count_drop(recv_drop_dispatch_rejected_, "wxz.inproc.recv.drop_dispatch_rejected", 1);
+    }
+    sub->active.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+void InprocChannel::check_idle_deadline(const std::shared_ptr<SubscriberQueue>& sub) {
+    // 与 drain_queued 相同的登记顺序：关闭后 close_queued 会等到这里退出。
+    sub->active.fetch_add(1, std::memory_order_seq_cst);
+    if (!sub->closed.load(std::memory_order_seq_cst)) {
+        check_deadline(sub->state, steady_now_ns());
+    }
+    sub->active.fetch_sub(1, std::memory_order_seq_cst);
 }
 
 void InprocChannel::stop() {
     const bool was_running = running_.exchange(false);
     if (was_running) {
-        cv_.notify_all();
+        wake_seq_.fetch_add(1, std::memory_order_seq_cst);
+        (void)internal::futex_wake_all(&wake_seq_, /*process_shared=*/false);
         if (worker_.joinable()) {
             worker_.join();
         }
@@ -238,35 +609,122 @@ void InprocChannel::stop() {
         std::lock_guard<std::mutex> lock(handler_mutex_);
         handlers_.clear();
     }
+    remove_queued([](const SubscriberQueue&) { return true; });
+    if (dispatch_pool_) dispatch_pool_->stop();
+}
+
+void InprocChannel::check_deadline(SubscriberState& st, std::uint64_t now_ns) {
+    if (qos_.deadline_ns == 0) return;
+    // 每个完整错过的周期计一次；next_deadline 向前推进，避免同一周期被重复计数（交付与空闲检测可能并发）。
+    std::uint64_t next = st.next_deadline_ns.load(std::memory_order_acquire);
+    while (next != 0 && now_ns > next) {
+        const std::uint64_t missed = 1 + (now_ns - next) / qos_.deadline_ns;
+        if (st.next_deadline_ns.compare_exchange_weak(next, next + missed * qos_.deadline_ns,
+                                                      std::memory_order_acq_rel)) {
+            count_drop(deadline_missed_, "wxz.inproc.recv.deadline_missed", missed);
+            return;
+        }
+    }
+}
+
+bool InprocChannel::deliver(SubscriberState& st, const Handler& handler, std::size_t idx) {
+    if (!handler) return false;
+    const std::uint64_t stamp = pool_.timestamp_ns(idx);
+    if (qos_.deadline_ns != 0) {
+        check_deadline(st, stamp);
+        // 只前进不后退：空闲检测可能已把 next_deadline 推过 stamp + deadline（那些周期已经计过）。
+        const std::uint64_t next = stamp + qos_.deadline_ns;
+        std::uint64_t cur = st.next_deadline_ns.load(std::memory_order_relaxed);
+        while (cur < next && !st.next_deadline_ns.compare_exchange_weak(cur, next, std::memory_order_acq_rel)) {
+        }
+    }
+    // 多写端时时间戳可能略有乱序：早于上次交付的样本同样视为间隔不足。
+    if (qos_.time_based_filter_ns != 0 && st.last_delivered_ns != 0 &&
+        stamp < st.last_delivered_ns + qos_.time_based_filter_ns) {
+        count_drop(recv_drop_filtered_, "wxz.inproc.recv.drop_filtered", 1);
+        return false;
+    }
+    st.last_delivered_ns = stamp;
+    handler(pool_.data(idx), pool_.committed_size(idx));
+    return true;
+}
+
+void InprocChannel::wake_dispatcher() {
+    // eventcount：与 dispatch_loop 的 “sleepers++ -> 读 wake_seq -> 再试出队” 配对（均为 seq_cst）：
+    // 要么这里看到 sleepers>0 并唤醒，要么分发线程在 park 前已能出队到本条消息；没有人 park 时不进内核。
+    wake_seq_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) != 0) {
+        (void)internal::futex_wake(&wake_seq_, 1, /*process_shared=*/false);
+    }
 }
 
 void InprocChannel::dispatch_loop() {
     constexpr std::size_t kBatch = 32;
     std::size_t batch[kBatch];
+    std::vector<HandlerEntry> copy_handlers;
 
     while (running_.load(std::memory_order_relaxed)) {
         std::size_t n = queue_.dequeue_batch(batch, kBatch);
+        // 先有界自旋：突发流量下避免 park/wake 两次系统调用。
+        for (std::uint32_t i = 0; n == 0 && i < spin_iterations_; ++i) {
+            internal::cpu_relax();
+            n = queue_.dequeue_batch(batch, kBatch);
+        }
         if (n == 0) {
-            std::unique_lock<std::mutex> lk(wait_mutex_);
-            cv_.wait_for(lk, std::chrono::microseconds(50));
-            continue;
+            if (qos_.deadline_ns != 0) {
+                // 空闲时也要检测 deadline（发布端停发正是最需要告警的情况）。
+                const std::uint64_t now = steady_now_ns();
+                std::lock_guard<std::mutex> lock(handler_mutex_);
+                for (auto& e : handlers_) check_deadline(*e.state, now);
+            }
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            const std::uint32_t seq = wake_seq_.load(std::memory_order_seq_cst);
+            n = queue_.dequeue_batch(batch, kBatch);
+            if (n == 0 && running_.load(std::memory_order_relaxed)) {
+                // 无超时 park：空闲 channel 零唤醒；设置了 deadline 时按周期醒来做空闲检测。
+                struct timespec ts {};
+                const struct timespec* timeout = nullptr;
+                if (qos_.deadline_ns != 0) {
+                    ts.tv_sec = static_cast<time_t>(qos_.deadline_ns / 1000000000ull);
+                    ts.tv_nsec = static_cast<long>(qos_.deadline_ns % 1000000000ull);
+                    timeout = &ts;
+                }
+                (void)internal::futex_wait(&wake_seq_, seq, timeout, /*process_shared=*/false);
+            }
+            sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+            if (n == 0) continue;
         }
 
-        std::vector<Handler> copy_handlers;
         {
             std::lock_guard<std::mutex> lock(handler_mutex_);
-            copy_handlers.reserve(handlers_.size());
-            for (const auto& e : handlers_) copy_handlers.push_back(e.handler);
+            copy_handlers = handlers_;
         }
 
-        for (std::size_t i = 0; i < n; ++i) {
+        // keep_last：订阅端积压（本批 + 队列剩余）超过 history 时，只交付最新的 history 条。
+        std::size_t first = 0;
+        if (qos_.history > 0) {
+            const std::size_t backlog = n + queue_.size_approx();
+            if (backlog > qos_.history) {
+                first = std::min(n, backlog - qos_.history);
+                for (std::size_t i = 0; i < first; ++i) pool_.release(batch[i]);
+                count_drop(recv_drop_history_, "wxz.inproc.recv.drop_history", first);
+            }
+        }
+
+        for (std::size_t i = first; i < n; ++i) {
             auto idx = batch[i];
-            auto* buf = pool_.data(idx);
-            std::size_t sz = pool_.committed_size(idx);
-            for (auto& h : copy_handlers) {
-                if (h) h(buf, sz);
+            const std::uint64_t stamp = pool_.timestamp_ns(idx);
+            // 逐条取时间：同一批内前面的 handler 可能已耗时较久。
+            const std::uint64_t now = qos_.lifespan_ns != 0 ? steady_now_ns() : 0;
+            if (qos_.lifespan_ns != 0 && now > stamp && now - stamp > qos_.lifespan_ns) {
+                count_drop(recv_drop_lifespan_, "wxz.inproc.recv.drop_lifespan", 1);
+                pool_.release(idx);
+                continue;
+            }
+            for (auto& e : copy_handlers) {
+                (void)deliver(*e.state, e.handler, idx);
             }
-            messages_delivered_.fetch_add(1, std::memory_order_relaxed);
+            ++messages_delivered_;
             pool_.release(idx);
         }
     }
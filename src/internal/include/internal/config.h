@@ -27,6 +27,24 @@ struct ChannelConfig {
     std::string shm_name;
     std::size_t shm_capacity{0};
     std::size_t shm_slot_size{0};
+    // shm.mode：queue（默认，读端分摊消息）| broadcast（每个读端独立游标，一写多读）。
+    std::string shm_mode{"queue"};
+    std::size_t shm_max_readers{16};
+    bool shm_multi_producer{false};
+    // shm.notify：futex（默认）| semaphore（旧路径，排障用）。
+    std::string shm_notify{"futex"};
+    // shm.ring_bytes：字节环大小（0 表示按 capacity * slot_size 估算）；shm.max_message：单条消息上限（0 表示环大小的一半）。
+    std::size_t shm_ring_bytes{0};
+    std::size_t shm_max_message{0};
+};
+
+// threading.<module> 的线程放置/调度配置（字段缺省表示“不调整”）。
+struct ThreadPolicyConfig {
+    std::vector<int> cpus;     // cpus: "0-3,8" 或 [0, 1, 2]
+    int numa_node{-1};         // numa_node: 内存绑定到该节点；未配置 cpus 时同时绑定该节点的 CPU
+    std::string sched;         // sched: other|fifo|rr
+    int priority{0};           // priority: fifo/rr 为 1..99；other 为 nice 值
+    std::string name;          // name: 线程名前缀（默认使用模块名）
 };
 
 struct FaultRecoveryRuleConfig {
@@ -52,6 +70,8 @@ public:
     // 线程配置辅助：根据模块名（例如 `taskflow`）获取线程数。
     // 如果未配置或值非法则返回 `default_n`；返回值不会超过 `max_n`。
     int getThreadCount(const std::string &module, int default_n, int max_n) const;
+    // 线程放置/调度策略：未配置该模块时返回 nullptr。
+    const ThreadPolicyConfig* getThreadPolicy(const std::string &module) const;
 
     // 参数服务器
     bool isParamServerEnabled() const;
@@ -123,6 +143,8 @@ private:
     std::vector<std::string> channel_denylist_;
     // 每个模块的线程数，从本地配置加载
     std::map<std::string, int> thread_counts_;
+    // 每个模块的线程放置/调度策略，从本地配置加载
+    std::map<std::string, ThreadPolicyConfig> thread_policies_;
 
     // fastdds profiles（镜像环境变量；为空表示“未在此处配置”）
     std::string fastdds_environment_file_{};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace eprosima::fastdds::dds {
@@ -20,6 +21,14 @@ namespace wxz::core::internal {
 // - 若默认 profiles 缺失/不可读：尽力而为（no-op）。
 void load_fastdds_profiles_from_env_once();
 
+// participant 级吞吐流控器（FastDDS FlowControllerDescriptor，FIFO 调度）；DataWriter 按 name 引用。
+// FlowControllerDescriptor 只保存 name 指针：spec 须在 participant 的整个生命周期内有效。
+struct FastddsFlowControllerSpec {
+    std::string name;
+    std::uint64_t bytes_per_period{0};
+    std::uint64_t period_ms{100};
+};
+
 // 使用与 wxz::core::FastddsChannel 相同的“环境变量驱动行为”来创建 DomainParticipant：
 // - 若设置 WXZ_FASTDDS_PARTICIPANT_PROFILE：调用 create_participant_with_profile(domain_id, profile)，
 //   若 profile 不存在则抛异常。
@@ -31,6 +40,9 @@ void load_fastdds_profiles_from_env_once();
 // - 该函数不会做 DDS-Security 预检查；调用方需自行处理。
 // - 该函数会触发 XML profiles 加载（每进程一次）。
 // - factory 失败时返回 nullptr；仅在明确的契约违规时抛异常（例如 profile 名无效、profiles 文件无效）。
-[[nodiscard]] eprosima::fastdds::dds::DomainParticipant* create_fastdds_participant_from_env(int domain_id);
+// - flow 非空时在 profile 的 QoS 之上追加该流控器（流控器在 participant 启用后不可再增加）。
+[[nodiscard]] eprosima::fastdds::dds::DomainParticipant* create_fastdds_participant_from_env(
+    int domain_id,
+    const FastddsFlowControllerSpec* flow = nullptr);
 
 } // namespace wxz::core::internal
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include <fastdds/dds/topic/TypeSupport.hpp>
+
+#include "internal/fastdds_participant_factory.h"
+
+namespace eprosima::fastdds::dds {
+class DomainParticipant;
+class Publisher;
+class Subscriber;
+class Topic;
+} // namespace eprosima::fastdds::dds
+
+namespace wxz::core::internal {
+
+// 进程内共享的 DomainParticipant：一个 participant + 一个 Publisher + 一个 Subscriber。
+// - 由 FastddsParticipantPool 按 (domain_id, participant profile) 复用，shared_ptr 引用计数。
+// - Channel 只创建自己的 DataWriter/DataReader；Topic 在同一 participant 内按名字共享（引用计数）。
+// - 最后一个引用释放时按显式顺序 teardown（WXZ_FASTDDS_SAFE_TEARDOWN=1 时跳过删除 participant）。
+class SharedFastddsParticipant {
+public:
+    SharedFastddsParticipant(const SharedFastddsParticipant&) = delete;
+    SharedFastddsParticipant& operator=(const SharedFastddsParticipant&) = delete;
+    ~SharedFastddsParticipant();
+
+    eprosima::fastdds::dds::DomainParticipant* participant() const { return participant_; }
+    eprosima::fastdds::dds::Publisher* publisher() const { return publisher_; }
+    eprosima::fastdds::dds::Subscriber* subscriber() const { return subscriber_; }
+    int domain_id() const { return domain_id_; }
+    const std::string& profile() const { return profile_; }
+    // 本 participant 注册的流控器；name 为空表示没有（DataWriter 的 flow_controller_name 直接引用其 name 存储）。
+    const FastddsFlowControllerSpec& flow_controller() const { return flow_; }
+
+    // 注册类型并获取（或创建）topic。
+    // - 同名类型每个 participant 只注册一次；若已注册，type 会被替换为已注册的 TypeSupport 实例。
+    // - 失败返回 nullptr。
+    eprosima::fastdds::dds::Topic* acquire_topic(const std::string& topic_name,
+                                                 eprosima::fastdds::dds::TypeSupport& type);
+
+    // 释放 acquire_topic() 获得的引用；最后一个引用释放时删除 topic。
+    void release_topic(eprosima::fastdds::dds::Topic* topic);
+
+    // 串行化该 participant 上的 DataWriter/DataReader 创建。
+    // 共享 TypeSupport 的尺寸提示（m_typeSize）在创建端点时被读取，调用方需在持锁期间调整并创建。
+    std::mutex& endpoint_mutex() { return endpoint_mutex_; }
+
+private:
+    friend class FastddsParticipantPool;
+
+    SharedFastddsParticipant(int domain_id, std::string profile) : domain_id_(domain_id), profile_(std::move(profile)) {}
+
+    struct TopicRef {
+        eprosima::fastdds::dds::Topic* topic{nullptr};
+        std::size_t refs{0};
+    };
+
+    int domain_id_{0};
+    std::string profile_;
+    FastddsFlowControllerSpec flow_;
+
+    eprosima::fastdds::dds::DomainParticipant* participant_{nullptr};
+    eprosima::fastdds::dds::Publisher* publisher_{nullptr};
+    eprosima::fastdds::dds::Subscriber* subscriber_{nullptr};
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, eprosima::fastdds::dds::TypeSupport> types_;
+    std::unordered_map<std::string, TopicRef> topics_;
+
+    std::mutex endpoint_mutex_;
+};
+
+// 进程级 participant 池。
+// - key = (domain_id, WXZ_FASTDDS_PARTICIPANT_PROFILE, 流控器名)；同 key 的 channel 共享同一个 participant。
+//   流控器只能在创建 participant 时注册，因此使用流控的 channel 按流控器名落到各自的 participant 上；
+//   同名流控器以首个创建者的参数为准，参数不一致时记录告警。
+// - 设置 WXZ_FASTDDS_SHARED_PARTICIPANT=0 可回退为“每个 channel 独占一个 participant”（排障用）。
+// - 创建失败返回 nullptr；profile 等契约违规沿用 create_fastdds_participant_from_env() 的异常语义。
+class FastddsParticipantPool {
+public:
+    static FastddsParticipantPool& instance();
+
+    [[nodiscard]] std::shared_ptr<SharedFastddsParticipant> acquire(int domain_id,
+                                                                     const FastddsFlowControllerSpec* flow = nullptr);
+
+    // 当前存活的共享 participant 数量（诊断用）。
+    std::size_t size() const;
+
+private:
+    FastddsParticipantPool() = default;
+    FastddsParticipantPool(const FastddsParticipantPool&) = delete;
+    FastddsParticipantPool& operator=(const FastddsParticipantPool&) = delete;
+
+    static std::shared_ptr<SharedFastddsParticipant> create_entry(int domain_id,
+                                                                  const std::string& profile,
+                                                                  const FastddsFlowControllerSpec* flow);
+
+    mutable std::mutex mutex_;
+    std::map<std::tuple<int, std::string, std::string>, std::weak_ptr<SharedFastddsParticipant>> entries_;
+};
+
+} // namespace wxz::core::internal
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace eprosima::fastdds::dds {
+class IContentFilterFactory;
+} // namespace eprosima::fastdds::dds
+
+namespace wxz::core::internal {
+
+// raw 字节 topic 的内容过滤（FastDDS ContentFilteredTopic 的自定义过滤类）。
+//
+// raw 类型没有 TypeObject，FastDDS 默认的 DDS-SQL 过滤器无法按字段求值；这里直接对 payload 字节求值。
+// 过滤在 reader 侧入 history 之前执行；写端所在 participant 也注册了同名过滤类时，FastDDS 在写端即丢弃不匹配的样本。
+//
+// 表达式语法（关键字大小写不敏感）：
+//   expr  := and ("OR" and)*
+//   and   := unary ("AND" unary)*
+//   unary := "NOT" unary | "(" expr ")" | field ("=" | "<>") value | field "IN" "(" value ("," value)* ")"
+//   field := "key"                      // channel 的 key 区间（需 ChannelQoS::key_size>0）
+//          | "bytes[" offset ":" size "]"  // 用户 payload 的任意字节区间
+//   value := "%"N                       // 第 N 个表达式参数（可在运行时替换）
+//          | "'" text "'"               // 字面字节（'' 表示单引号）
+//          | "0x" hex                   // 十六进制字节
+// 参数值同样按 '...'/0x.../原样文本 解释。值短于字段时右侧补 0 后比较，长于字段时不相等；
+// payload 短于字段区间的样本视为不匹配。
+inline constexpr const char* kRawBytesFilterClass = "WXZ_RAW_BYTES";
+
+// 已编译的过滤表达式（不可变，可并发求值）。
+class RawBytesFilterProgram;
+
+// 编译表达式；语法错误、参数下标越界或 keyed 字段用于无 key 的类型时抛 std::invalid_argument。
+// key_size==0 表示类型没有 key。
+std::shared_ptr<const RawBytesFilterProgram> compile_raw_bytes_filter(const std::string& expression,
+                                                                     const std::vector<std::string>& parameters,
+                                                                     std::size_t key_offset,
+                                                                     std::size_t key_size);
+
+// 对用户 payload（不含 CDR 头）求值。
+bool evaluate_raw_bytes_filter(const RawBytesFilterProgram& program, const std::uint8_t* data, std::size_t size);
+
+// keyed raw 类型的类型名携带 key 区间，保证跨进程的写端/读端与过滤器对 key 的解释一致。
+std::string raw_bytes_type_name(std::size_t key_offset, std::size_t key_size);
+// 解析 raw_bytes_type_name() 生成的名字；无 key 的类型返回 true 且 key_size=0；非 raw 类型返回 false。
+bool parse_raw_bytes_type_name(const std::string& type_name, std::size_t& key_offset, std::size_t& key_size);
+
+// 进程级单例（生命周期覆盖所有 participant），由 FastddsParticipantPool 在创建 participant 时注册。
+eprosima::fastdds::dds::IContentFilterFactory& raw_bytes_filter_factory();
+
+} // namespace wxz::core::internal
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "observability.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// FastddsChannel 接收侧的共享 payload 池。不依赖 FastDDS，单独成头文件以便单测。
+
+namespace wxz::core::internal {
+
+class FastddsRecvPayloadPool;
+
+// 接收侧共享 payload：引用计数由 RecvPayloadRef 维护，归零时回到所属池。
+struct RecvPayload {
+    std::atomic<std::uint32_t> refs{0};
+    // 借出期间持有所属池，保证池晚于最后一个借出的 buffer 释放（channel 可能先于排队的任务析构）。
+    std::shared_ptr<FastddsRecvPayloadPool> home;
+    std::vector<std::uint8_t> data;
+    std::size_t size{0};
+};
+
+class RecvPayloadRef {
+public:
+    RecvPayloadRef() = default;
+    explicit RecvPayloadRef(RecvPayload* p) noexcept : p_(p) {}
+    RecvPayloadRef(const RecvPayloadRef& other) noexcept : p_(other.p_) {
+        if (p_) p_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    RecvPayloadRef(RecvPayloadRef&& other) noexcept : p_(std::exchange(other.p_, nullptr)) {}
+    RecvPayloadRef& operator=(RecvPayloadRef other) noexcept {
+        std::swap(p_, other.p_);
+        return *this;
+    }
+    ~RecvPayloadRef() { reset(); }
+
+    void reset() noexcept;
+
+    explicit operator bool() const noexcept { return p_ != nullptr; }
+    // 只有本引用持有时才可复用为下一条样本的反序列化目标。
+    bool unique() const noexcept { return p_ && p_->refs.load(std::memory_order_acquire) == 1; }
+    RecvPayload* get() const noexcept { return p_; }
+    const std::uint8_t* data() const noexcept { return p_->data.data(); }
+    std::size_t size() const noexcept { return p_->size; }
+
+private:
+    RecvPayload* p_{nullptr};
+};
+
+// 接收侧共享 payload 池：按需增长、只增不减；buffer 按实际消息大小扩容（不预分配 max_payload）。
+// 分配次数（新建 buffer/扩容）计入 allocations()，预热后应保持不变。
+class FastddsRecvPayloadPool final : public std::enable_shared_from_this<FastddsRecvPayloadPool> {
+public:
+    explicit FastddsRecvPayloadPool(std::string topic) : topic_(std::move(topic)) {}
+
+    RecvPayloadRef acquire() {
+        RecvPayload* p = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_.empty()) {
+                p = free_.back();
+                free_.pop_back();
+            }
+        }
+        if (!p) {
+            auto owned = std::make_unique<RecvPayload>();
+            p = owned.get();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                owned_.push_back(std::move(owned));
+                // 保证 release() 归还时不会扩容。
+                free_.reserve(owned_.size());
+            }
+            count_allocation();
+        }
+        p->home = shared_from_this();
+        p->size = 0;
+        p->refs.store(1, std::memory_order_relaxed);
+        return RecvPayloadRef(p);
+    }
+
+    // 准备写入 len 字节（调用方须唯一持有 ref）。
+    std::uint8_t* prepare(RecvPayloadRef& ref, std::size_t len) {
+        RecvPayload* p = ref.get();
+        if (p->data.capacity() < len) {
+            p->data.reserve(len);
+            count_allocation();
+        }
+        if (p->data.size() < len) p->data.resize(len);
+        p->size = len;
+        return p->data.data();
+    }
+
+    static void release(RecvPayload* p) noexcept {
+        // lock 先于 home 析构：池可能随最后一个 home 一起释放。
+        auto home = std::move(p->home);
+        std::lock_guard<std::mutex> lock(home->mutex_);
+        home->free_.push_back(p);
+    }
+
+    std::uint64_t allocations() const { return allocations_.load(std::memory_order_relaxed); }
+
+private:
+    void count_allocation() {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        if (wxz::core::has_metrics_sink()) {
+            wxz::core::metrics().counter_add("wxz.fastdds.recv.buffer_alloc", 1, {{"topic", topic_}});
+        }
+    }
+
+    const std::string topic_;
+    std::mutex mutex_;
+    std::vector<RecvPayload*> free_;
+    std::vector<std::unique_ptr<RecvPayload>> owned_;
+    std::atomic<std::uint64_t> allocations_{0};
+};
+
+inline void RecvPayloadRef::reset() noexcept {
+    if (p_ && p_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) FastddsRecvPayloadPool::release(p_);
+    p_ = nullptr;
+}
+
+} // namespace wxz::core::internal
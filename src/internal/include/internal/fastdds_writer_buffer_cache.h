@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace wxz::core::internal {
+
+// FastddsChannel 写端 payload buffer 的缓存（FastddsWriterPayloadPool 的实现，不依赖 FastDDS）。
+// - 普通 publish：与 FastDDS 默认 pool 相同，按需复用 buffer（至少 buffer_bytes，即类型尺寸提示）。
+// - loan 发布：FastddsChannel 先 arm() 已写好帧字节的 buffer，DataWriter 在 write() 内
+//   取 payload 时直接拿走它（take_armed_or_acquire），serialize 只补写 CDR 头。
+// - 大数据模式下 buffer_bytes 小于整帧：更大的帧按实际尺寸分配，空闲 buffer 按容量 best-fit 复用，
+//   缓存总量有上限（整帧 buffer 可复用，但不无限囤积）。
+class FastddsWriterBufferCache {
+public:
+    static constexpr std::size_t kMaxFree = 64;
+
+    // frame_bytes：整帧（max_payload）buffer 的尺寸；空闲缓存至少容纳两帧，大数据模式下整帧 buffer 也能复用。
+    FastddsWriterBufferCache(std::uint32_t buffer_bytes, std::uint32_t frame_bytes)
+        : buffer_bytes_(buffer_bytes),
+          max_free_bytes_(std::max<std::size_t>(kMaxFree * std::size_t{buffer_bytes}, 2 * std::size_t{frame_bytes})) {}
+
+    ~FastddsWriterBufferCache() {
+        for (auto& f : free_) delete[] f.buf;
+    }
+
+    FastddsWriterBufferCache(const FastddsWriterBufferCache&) = delete;
+    FastddsWriterBufferCache& operator=(const FastddsWriterBufferCache&) = delete;
+
+    // 返回容量不小于 size 的 buffer，capacity 为其实际容量（release 时原样交回）。
+    std::uint8_t* acquire(std::uint32_t size, std::uint32_t& capacity) {
+        const std::uint32_t need = std::max(size, buffer_bytes_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::size_t best = free_.size();
+            for (std::size_t i = 0; i < free_.size(); ++i) {
+                // 不拿大 buffer 承载小帧（否则紧随其后的大帧又得重新分配）。
+                if (free_[i].capacity < need || free_[i].capacity / 2 > need) continue;
+                if (best == free_.size() || free_[i].capacity < free_[best].capacity) best = i;
+                if (free_[i].capacity == need) break;
+            }
+            if (best != free_.size()) {
+                const FreeBuffer f = free_[best];
+                free_[best] = free_.back();
+                free_.pop_back();
+                free_bytes_ -= f.capacity;
+                capacity = f.capacity;
+                return f.buf;
+            }
+        }
+        capacity = need;
+        return new std::uint8_t[need];
+    }
+
+    void release(std::uint8_t* buf, std::uint32_t capacity) {
+        if (!buf) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (free_.size() < kMaxFree && free_bytes_ + capacity <= max_free_bytes_) {
+                free_.push_back(FreeBuffer{buf, capacity});
+                free_bytes_ += capacity;
+                return;
+            }
+        }
+        delete[] buf;
+    }
+
+    // 调用方持有 FastddsChannel::entity_mutex_：同一时刻最多一个 armed buffer。
+    void arm(std::uint8_t* buf, std::uint32_t capacity) {
+        armed_capacity_ = capacity;
+        armed_.store(buf, std::memory_order_release);
+    }
+
+    // 返回 true 表示 armed buffer 已被取走（之后由 release 归还）；false 时 buffer 仍归调用方。
+    bool disarm() { return armed_.exchange(nullptr, std::memory_order_acq_rel) == nullptr; }
+
+    // DataWriter 取 payload：优先拿走 armed buffer，否则按需取一个。
+    std::uint8_t* take_armed_or_acquire(std::uint32_t size, std::uint32_t& capacity) {
+        std::uint8_t* buf = armed_.exchange(nullptr, std::memory_order_acq_rel);
+        if (buf) {
+            capacity = armed_capacity_;
+            if (capacity >= size) return buf;
+            // loan 按 max_payload 分配，正常不会发生；退回缓存，本次按需另取。
+            release(buf, capacity);
+        }
+        return acquire(size, capacity);
+    }
+
+    // 空闲缓存的 buffer 数与总字节数（测试/观测用）。
+    std::size_t free_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return free_.size();
+    }
+    std::size_t free_bytes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return free_bytes_;
+    }
+
+private:
+    struct FreeBuffer {
+        std::uint8_t* buf;
+        std::uint32_t capacity;
+    };
+
+    const std::uint32_t buffer_bytes_;
+    const std::size_t max_free_bytes_;
+    std::atomic<std::uint8_t*> armed_{nullptr};
+    // 与 armed_ 一起发布（arm 先写容量再 release-store 指针）。
+    std::uint32_t armed_capacity_{0};
+    mutable std::mutex mutex_;
+    std::vector<FreeBuffer> free_;
+    std::size_t free_bytes_{0};
+};
+
+} // namespace wxz::core::internal
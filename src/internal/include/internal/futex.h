@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace wxz::core::internal {
+
+// Linux futex 的薄封装（eventcount 风格的 park/wake）。
+// - process_shared=true：字位于 MAP_SHARED 内存（跨进程），不能使用 *_PRIVATE 变体。
+// - process_shared=false：进程内使用 *_PRIVATE，内核无需按物理页查找等待队列。
+// timeout 为相对时间；nullptr 表示无限等待。返回值同 syscall（被唤醒/值不匹配/超时均需调用方重新检查条件）。
+inline long futex_wait(std::atomic<std::uint32_t>* word,
+                       std::uint32_t expected,
+                       const struct timespec* timeout,
+                       bool process_shared) {
+    const int op = process_shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE;
+    return ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(word), op, expected, timeout, nullptr, 0);
+}
+
+inline long futex_wake(std::atomic<std::uint32_t>* word, int count, bool process_shared) {
+    const int op = process_shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE;
+    return ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(word), op, count, nullptr, nullptr, 0);
+}
+
+inline long futex_wake_all(std::atomic<std::uint32_t>* word, bool process_shared) {
+    return futex_wake(word, INT_MAX, process_shared);
+}
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+} // namespace wxz::core::internal
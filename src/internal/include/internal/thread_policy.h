@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace wxz::core::internal {
+
+enum class SchedPolicy {
+    other,
+    fifo,
+    rr,
+};
+
+// 单个线程池（模块）的线程放置/调度策略，来自配置 threading.<pool>。
+struct ThreadPolicy {
+    std::vector<int> cpus;                 // 空表示不绑定（numa_node>=0 时使用该节点的 CPU）
+    int numa_node{-1};                     // <0 表示不做内存绑定
+    SchedPolicy sched{SchedPolicy::other};
+    int priority{0};                       // fifo/rr：1..99；other：nice 值（0 表示不调整）
+    std::string name;                      // 线程名前缀（空表示使用 pool 名）
+};
+
+// Linux cpulist 格式解析："0-3,8,10-11"；非法片段（含超出 [0, CPU_SETSIZE) 的编号）忽略。
+std::vector<int> parse_cpu_list(const std::string& s);
+
+// 读取配置 threading.<pool>；未配置时返回默认策略（不绑定、SCHED_OTHER，只设置线程名）。
+ThreadPolicy thread_policy_for(const std::string& pool);
+
+// 在库创建的线程入口处调用（作用于当前线程）：
+// - 线程名 "<name>/<index>"（截断到 15 字节）、CPU 集、NUMA 内存绑定（set_mempolicy）、调度策略。
+// - 任一步失败只告警并计入 wxz.thread.policy.error{pool,what}，线程照常运行。
+// - 实际生效的放置通过 gauge wxz.thread.placement{pool,thread,tid,cpus,sched,priority,numa_node} 上报。
+void apply_thread_policy(const std::string& pool, const ThreadPolicy& policy, std::size_t index);
+
+inline void apply_thread_policy(const std::string& pool, std::size_t index) {
+    apply_thread_policy(pool, thread_policy_for(pool), index);
+}
+
+} // namespace wxz::core::internal
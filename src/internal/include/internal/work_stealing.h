@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "sharded_counter.h"
+
+namespace wxz::core::internal {
+
+inline std::size_t round_up_pow2(std::size_t v) {
+    std::size_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+// 定长 Chase-Lev 工作窃取队列（元素为指针，不转移所有权）。
+// - push()/pop() 只能由 owner 线程调用：在 bottom 端 LIFO 存取（刚投递的任务数据仍在缓存里）；
+//   push() 满时返回 false（调用方改投全局队列，不扩容，因此无需回收旧缓冲）。
+// - steal() 可由任意线程调用，从 top 端按 FIFO 取，CAS top 成功者取得元素；
+//   owner 也可以用它取最早的任务（调度器借此限制连续 LIFO，见 WorkStealingScheduler）。
+// - 只剩最后一个元素时 pop() 与 steal() 通过 CAS top 竞争，恰好一方取得。
+template <class T>
+class ChaseLevDeque {
+public:
+    explicit ChaseLevDeque(std::size_t capacity) : slots_(round_up_pow2(capacity)), mask_(slots_.size() - 1) {
+        for (auto& s : slots_) s.store(nullptr, std::memory_order_relaxed);
+    }
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    bool push(T* item) {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= static_cast<std::int64_t>(slots_.size())) return false;
+        slots_[static_cast<std::size_t>(b) & mask_].store(item, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    T* pop() {
+        const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        // 先公布 bottom 的回退再读 top：与 steal() 中“读 top -> 读 bottom”配对，
+        // 双方不会同时认为自己拿到了同一个元素。
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed); // 空
+            return nullptr;
+        }
+        T* item = slots_[static_cast<std::size_t>(b) & mask_].load(std::memory_order_relaxed);
+        if (t == b) {
+            // 最后一个元素：与窃取者竞争 top。
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    T* steal() {
+        for (;;) {
+            std::int64_t t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t b = bottom_.load(std::memory_order_acquire);
+            if (t >= b) return nullptr;
+            // 槽位可能在读取后被 owner 复用；那时 top 必然已前进，下面的 CAS 会失败并重试。
+            T* item = slots_[static_cast<std::size_t>(t) & mask_].load(std::memory_order_relaxed);
+            if (top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return item;
+            }
+        }
+    }
+
+    bool empty_approx() const {
+        return bottom_.load(std::memory_order_acquire) <= top_.load(std::memory_order_acquire);
+    }
+
+    std::size_t size_approx() const {
+        const std::int64_t n = bottom_.load(std::memory_order_relaxed) - top_.load(std::memory_order_relaxed);
+        return n > 0 ? static_cast<std::size_t>(n) : 0;
+    }
+
+private:
+    std::vector<std::atomic<T*>> slots_;
+    std::size_t mask_{0};
+    alignas(kCacheLineSize) std::atomic<std::int64_t> top_{0};
+    alignas(kCacheLineSize) std::atomic<std::int64_t> bottom_{0};
+};
+
+// 有界 MPMC 队列（Dmitry Vyukov 变体，元素为指针），用作执行器的全局注入队列。
+template <class T>
+class MpmcPtrQueue {
+public:
+    explicit MpmcPtrQueue(std::size_t capacity) : cells_(round_up_pow2(capacity < 2 ? 2 : capacity)), mask_(cells_.size() - 1) {
+        for (std::size_t i = 0; i < cells_.size(); ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    MpmcPtrQueue(const MpmcPtrQueue&) = delete;
+    MpmcPtrQueue& operator=(const MpmcPtrQueue&) = delete;
+
+    bool push(T* item) {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const std::size_t seq = cell.seq.load(std::memory_order_acquire);
+            const auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (dif == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.item = item;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false; // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    T* pop() {
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const std::size_t seq = cell.seq.load(std::memory_order_acquire);
+            const auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* item = cell.item;
+                    cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return item;
+                }
+            } else if (dif < 0) {
+                return nullptr; // empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool empty_approx() const {
+        return enqueue_pos_.load(std::memory_order_acquire) == dequeue_pos_.load(std::memory_order_acquire);
+    }
+
+    std::size_t size_approx() const {
+        const std::size_t e = enqueue_pos_.load(std::memory_order_relaxed);
+        const std::size_t d = dequeue_pos_.load(std::memory_order_relaxed);
+        return e > d ? e - d : 0;
+    }
+
+private:
+    struct alignas(kCacheLineSize) Cell {
+        std::atomic<std::size_t> seq;
+        T* item{nullptr};
+    };
+
+    std::vector<Cell> cells_;
+    std::size_t mask_{0};
+    alignas(kCacheLineSize) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(kCacheLineSize) std::atomic<std::size_t> dequeue_pos_{0};
+};
+
+} // namespace wxz::core::internal
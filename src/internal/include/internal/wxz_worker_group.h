@@ -6,14 +6,18 @@
 #include <mutex>
 #include <condition_variable>
 #include <memory>
+#include <string>
+#include <utility>
 
 namespace wxz {
 
 // 一个小型的工作线程组，用于管理 N 个工作线程。
 // 每个工作线程运行传入的可调用对象：`void(std::atomic<bool>& stop, int worker_id)`
+// 线程按配置 threading.<name> 设置放置/调度策略（见 internal/thread_policy.h）。
 class WorkerGroup {
 public:
     WorkerGroup() = default;
+    explicit WorkerGroup(std::string name) : name_(std::move(name)) {}
     ~WorkerGroup();
 
     // 启动 N 个工作线程并运行 'fn'。如果已经在运行则返回 false。
@@ -29,6 +33,7 @@ public:
     size_t size() const { return threads_.size(); }
 
 private:
+    std::string name_{"worker_group"};
     std::vector<std::thread> threads_;
     std::atomic<bool> running_{false};
     std::mutex mtx_;
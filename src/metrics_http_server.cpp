@@ -1,17 +1,99 @@
 #include "metrics_http_server.h"
 
+#include "internal/thread_policy.h"
+
+#include <algorithm>
+#include <cctype>
 #include <cerrno>
 #include <cstring>
 #include <string_view>
+#include <vector>
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
-#include <sys/select.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#if defined(WXZ_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
 namespace wxz::core {
 
+namespace {
+
+// 请求头（不含 body）的上限；超过时返回 431 并关闭连接。
+constexpr std::size_t kMaxRequestHeader = 16 * 1024;
+// 请求 body 的上限（抓取请求本不带 body）；Content-Length 超过时返回 413 并关闭连接，不读入 body。
+constexpr std::size_t kMaxRequestBody = 4 * 1024;
+// 每个连接缓冲的未处理输入上限：达到时停止读取（等待渲染期间暂停关注可读事件），由 TCP 流控反压对端。
+// 刚好容纳一个头部与 body 都达到上限的请求，因此未处理完的缓冲总能在上限内被解析或拒绝。
+constexpr std::size_t kMaxBufferedInput = kMaxRequestHeader + 4 + kMaxRequestBody;
+constexpr int kMaxEvents = 64;
+
+std::string gzip_compress(const std::string& in) {
+#if defined(WXZ_HAVE_ZLIB)
+    z_stream zs{};
+    // windowBits 15+16：输出 gzip 封装（而非裸 zlib 流）。
+    if (deflateInit2(&zs, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return {};
+    std::string out;
+    out.resize(deflateBound(&zs, static_cast<uLong>(in.size())));
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = reinterpret_cast<Bytef*>(out.data());
+    zs.avail_out = static_cast<uInt>(out.size());
+    const int rc = deflate(&zs, Z_FINISH);
+    const auto produced = zs.total_out;
+    deflateEnd(&zs);
+    if (rc != Z_STREAM_END) return {};
+    out.resize(produced);
+    return out;
+#else
+    (void)in;
+    return {};
+#endif
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+    }
+    return true;
+}
+
+bool icontains(std::string_view hay, std::string_view needle) {
+    if (needle.empty() || hay.size() < needle.size()) return needle.empty();
+    for (std::size_t i = 0; i + needle.size() <= hay.size(); ++i) {
+        if (iequals(hay.substr(i, needle.size()), needle)) return true;
+    }
+    return false;
+}
+
+std::string_view trim(std::string_view v) {
+    while (!v.empty() && (v.front() == ' ' || v.front() == '\t')) v.remove_prefix(1);
+    while (!v.empty() && (v.back() == ' ' || v.back() == '\t')) v.remove_suffix(1);
+    return v;
+}
+
+// 十进制 Content-Length；非法或超过 limit 时返回 false。
+bool parse_content_length(std::string_view v, std::size_t limit, std::size_t& out) {
+    if (v.empty()) return false;
+    std::size_t n = 0;
+    for (const char ch : v) {
+        if (ch < '0' || ch > '9') return false;
+        n = n * 10 + static_cast<std::size_t>(ch - '0');
+        if (n > limit) return false;
+    }
+    out = n;
+    return true;
+}
+
+} // namespace
+
 MetricsHttpServer::MetricsHttpServer(Options opts, RenderFn render)
     : opts_(std::move(opts)), render_(std::move(render)) {}
 
@@ -23,11 +105,17 @@ bool MetricsHttpServer::start() {
     bool expected = false;
     if (!running_.compare_exchange_strong(expected, true)) return true;
 
-    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
-    if (listen_fd_ < 0) {
+    auto fail = [this]() {
+        if (listen_fd_ >= 0) ::close(listen_fd_);
+        if (epoll_fd_ >= 0) ::close(epoll_fd_);
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        listen_fd_ = epoll_fd_ = wake_fd_ = -1;
         running_.store(false);
         return false;
-    }
+    };
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) return fail();
 
     int yes = 1;
     (void)::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
@@ -38,122 +126,414 @@ bool MetricsHttpServer::start() {
     if (opts_.bind_addr.empty() || opts_.bind_addr == "0" || opts_.bind_addr == "0.0.0.0") {
         addr.sin_addr.s_addr = htonl(INADDR_ANY);
     } else {
-        if (::inet_pton(AF_INET, opts_.bind_addr.c_str(), &addr.sin_addr) != 1) {
-            ::close(listen_fd_);
-            listen_fd_ = -1;
-            running_.store(false);
-            return false;
-        }
+        if (::inet_pton(AF_INET, opts_.bind_addr.c_str(), &addr.sin_addr) != 1) return fail();
     }
 
-    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
-        ::close(listen_fd_);
-        listen_fd_ = -1;
-        running_.store(false);
-        return false;
-    }
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return fail();
+    if (::listen(listen_fd_, opts_.backlog) != 0) return fail();
 
-    if (::listen(listen_fd_, opts_.backlog) != 0) {
-        ::close(listen_fd_);
-        listen_fd_ = -1;
-        running_.store(false);
-        return false;
-    }
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) return fail();
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) return fail();
 
-    worker_ = std::thread([this]() { run_(); });
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_fd_;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev) != 0) return fail();
+    ev.data.fd = wake_fd_;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev) != 0) return fail();
+
+    worker_ = std::thread([this]() {
+        internal::apply_thread_policy("metrics_http", 0);
+        run_();
+    });
+    renderer_ = std::thread([this]() {
+        internal::apply_thread_policy("metrics_http", 1);
+        render_loop_();
+    });
     return true;
 }
 
 void MetricsHttpServer::stop() {
     if (!running_.exchange(false)) return;
 
-    if (listen_fd_ >= 0) {
-        ::shutdown(listen_fd_, SHUT_RDWR);
-        ::close(listen_fd_);
-        listen_fd_ = -1;
+    {
+        std::lock_guard<std::mutex> lock(snap_mu_);
     }
+    render_cv_.notify_all();
+    const std::uint64_t one = 1;
+    (void)!::write(wake_fd_, &one, sizeof(one));
 
     if (worker_.joinable()) worker_.join();
-}
+    if (renderer_.joinable()) renderer_.join();
 
-void MetricsHttpServer::write_all_(int fd, const char* data, std::size_t size) {
-    while (size > 0) {
-        const ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
-        if (n <= 0) return;
-        data += static_cast<std::size_t>(n);
-        size -= static_cast<std::size_t>(n);
-    }
+    for (auto& kv : conns_) ::close(kv.first);
+    conns_.clear();
+    render_pending_ = false;
+
+    ::close(listen_fd_);
+    ::close(epoll_fd_);
+    ::close(wake_fd_);
+    listen_fd_ = epoll_fd_ = wake_fd_ = -1;
+
+    std::lock_guard<std::mutex> lock(snap_mu_);
+    render_requested_ = false;
+    snapshot_.reset();
 }
 
 void MetricsHttpServer::run_() {
+    epoll_event events[kMaxEvents];
+    auto last_sweep = std::chrono::steady_clock::now();
+
     while (running_.load()) {
-        fd_set rfds;
-        FD_ZERO(&rfds);
-        FD_SET(listen_fd_, &rfds);
+        const int n = ::epoll_wait(epoll_fd_, events, kMaxEvents, 1000);
+        if (!running_.load()) break;
+
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            const std::uint32_t ev = events[i].events;
+            if (fd == listen_fd_) {
+                accept_();
+                continue;
+            }
+            if (fd == wake_fd_) {
+                std::uint64_t v = 0;
+                (void)!::read(wake_fd_, &v, sizeof(v));
+                on_snapshot_ready_();
+                continue;
+            }
 
-        timeval tv{};
-        tv.tv_sec = 0;
-        tv.tv_usec = 200 * 1000; // 200ms
+            auto it = conns_.find(fd);
+            if (it == conns_.end()) continue;
+            if (ev & EPOLLERR) {
+                close_conn_(fd);
+                continue;
+            }
+            if (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+                on_readable_(it->second);
+                it = conns_.find(fd);
+                if (it == conns_.end()) continue;
+            }
+            if (ev & EPOLLOUT) (void)flush_(it->second);
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_sweep >= std::chrono::seconds(1)) {
+            last_sweep = now;
+            sweep_idle_();
+        }
+    }
+}
 
-        const int rc = ::select(listen_fd_ + 1, &rfds, nullptr, nullptr, &tv);
+void MetricsHttpServer::render_loop_() {
+    std::unique_lock<std::mutex> lock(snap_mu_);
+    for (;;) {
+        render_cv_.wait(lock, [&] { return render_requested_ || !running_.load(); });
         if (!running_.load()) break;
-        if (rc <= 0) continue;
-        if (!FD_ISSET(listen_fd_, &rfds)) continue;
+        render_requested_ = false;
+        lock.unlock();
+
+        // 渲染与压缩都在锁外进行，事件循环同时继续服务其它连接。
+        auto snap = std::make_shared<Snapshot>();
+        try {
+            snap->body = render_ ? render_() : std::string{};
+        } catch (...) {
+            snap->body.clear();
+        }
+        if (opts_.gzip && snap->body.size() >= opts_.gzip_min_bytes) snap->gzip_body = gzip_compress(snap->body);
+        snap->built = std::chrono::steady_clock::now();
+
+        lock.lock();
+        snapshot_ = std::move(snap);
+        const std::uint64_t one = 1;
+        (void)!::write(wake_fd_, &one, sizeof(one));
+    }
+}
+
+std::shared_ptr<const MetricsHttpServer::Snapshot> MetricsHttpServer::fresh_snapshot_() const {
+    std::lock_guard<std::mutex> lock(snap_mu_);
+    if (!snapshot_ || std::chrono::steady_clock::now() - snapshot_->built >= opts_.cache_ttl) return nullptr;
+    return snapshot_;
+}
+
+void MetricsHttpServer::request_render_() {
+    if (render_pending_) return;
+    render_pending_ = true;
+    {
+        std::lock_guard<std::mutex> lock(snap_mu_);
+        render_requested_ = true;
+    }
+    render_cv_.notify_one();
+}
+
+void MetricsHttpServer::on_snapshot_ready_() {
+    if (!render_pending_) return;
+    render_pending_ = false;
+
+    std::shared_ptr<const Snapshot> snap;
+    {
+        std::lock_guard<std::mutex> lock(snap_mu_);
+        snap = snapshot_;
+    }
+    if (!snap) return;
 
-        sockaddr_in peer{};
-        socklen_t peer_len = sizeof(peer);
-        const int fd = ::accept(listen_fd_, reinterpret_cast<sockaddr*>(&peer), &peer_len);
-        if (fd < 0) continue;
+    // 刚渲染好的快照直接交给等待中的请求（即使 cache_ttl 为 0）。
+    std::vector<int> waiting;
+    for (const auto& kv : conns_) {
+        if (kv.second.waiting) waiting.push_back(kv.first);
+    }
+    for (const int fd : waiting) {
+        auto it = conns_.find(fd);
+        if (it == conns_.end()) continue;
+        Conn& c = it->second;
+        c.waiting = false;
+        respond_(c, *snap);
+        // 继续处理 pipelining 的后续请求（process_ 内部负责发送）。
+        process_(c);
+    }
+}
 
-        char buf[4096];
-        const ssize_t nread = ::recv(fd, buf, sizeof(buf) - 1, 0);
-        if (nread <= 0) {
+void MetricsHttpServer::accept_() {
+    for (;;) {
+        const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return; // EAGAIN 或暂时性错误：等下一次可读事件。
+        }
+        if (conns_.size() >= opts_.max_connections) {
             ::close(fd);
             continue;
         }
-        buf[nread] = '\0';
 
-        std::string_view req(buf, static_cast<std::size_t>(nread));
+        int yes = 1;
+        (void)::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = fd;
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            ::close(fd);
+            continue;
+        }
+        Conn& c = conns_[fd];
+        c.fd = fd;
+        c.last_active = std::chrono::steady_clock::now();
+    }
+}
+
+void MetricsHttpServer::close_conn_(int fd) {
+    (void)::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    conns_.erase(fd);
+}
+
+void MetricsHttpServer::on_readable_(Conn& c) {
+    char buf[4096];
+    bool eof = false;
+    for (;;) {
+        // 缓冲已满：先交给 process_ 消化（或拒绝），剩余数据留在 socket 里。
+        if (c.in.size() >= kMaxBufferedInput) break;
+        const ssize_t n = ::recv(c.fd, buf, std::min(sizeof(buf), kMaxBufferedInput - c.in.size()), 0);
+        if (n > 0) {
+            c.in.append(buf, static_cast<std::size_t>(n));
+            continue;
+        }
+        if (n == 0) {
+            eof = true;
+            break;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        close_conn_(c.fd);
+        return;
+    }
+    c.last_active = std::chrono::steady_clock::now();
+    // 已决定关闭的连接（如 431）不再累积输入。
+    if (c.close_after_write) c.in.clear();
+
+    if (eof) {
+        // 对端已半关闭：处理完已收到的请求后关闭。
+        c.keep_alive = false;
+        if (c.in.empty() && !c.waiting && c.out_off >= c.out.size()) {
+            close_conn_(c.fd);
+            return;
+        }
+        c.read_closed = true;
+        update_events_(c);
+    }
+    process_(c);
+}
+
+void MetricsHttpServer::process_(Conn& c) {
+    // 拒绝并在写完后关闭；之后的输入不再解析。
+    const auto reject = [&c](std::string_view status) {
+        c.out += "HTTP/1.1 ";
+        c.out += status;
+        c.out += "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        c.close_after_write = true;
+        c.in.clear();
+    };
+    while (!c.waiting && !c.close_after_write) {
+        const std::size_t end = c.in.find("\r\n\r\n");
+        if (end == std::string::npos || end > kMaxRequestHeader) {
+            if (c.in.size() > kMaxRequestHeader) {
+                reject("431 Request Header Fields Too Large");
+            } else if (!c.keep_alive && c.out_off >= c.out.size()) {
+                // 对端已关闭且没有完整请求。
+                c.close_after_write = true;
+            }
+            break;
+        }
+
+        const std::string_view req(c.in.data(), end);
         // 解析：METHOD SP PATH SP HTTP/...
-        const std::size_t sp1 = req.find(' ');
-        const std::size_t sp2 = (sp1 == std::string_view::npos) ? std::string_view::npos : req.find(' ', sp1 + 1);
-        const std::string_view method = (sp1 == std::string_view::npos) ? std::string_view{} : req.substr(0, sp1);
-        const std::string_view path = (sp2 == std::string_view::npos) ? std::string_view{} : req.substr(sp1 + 1, sp2 - (sp1 + 1));
+        const std::size_t line_end = req.find("\r\n");
+        const std::string_view line = req.substr(0, line_end);
+        const std::size_t sp1 = line.find(' ');
+        const std::size_t sp2 = (sp1 == std::string_view::npos) ? std::string_view::npos : line.find(' ', sp1 + 1);
+        const std::string_view method = (sp1 == std::string_view::npos) ? std::string_view{} : line.substr(0, sp1);
+        std::string_view path = (sp2 == std::string_view::npos) ? std::string_view{} : line.substr(sp1 + 1, sp2 - (sp1 + 1));
+        const std::string_view version = (sp2 == std::string_view::npos) ? std::string_view{} : line.substr(sp2 + 1);
+        path = path.substr(0, path.find('?'));
 
+        // HTTP/1.1 默认 keep-alive，HTTP/1.0 默认关闭。
+        bool keep_alive = (version == "HTTP/1.1");
+        bool want_gzip = false;
+        std::size_t body = 0;
+        bool body_ok = true;
+        std::string_view headers = (line_end == std::string_view::npos) ? std::string_view{} : req.substr(line_end + 2);
+        while (!headers.empty()) {
+            const std::size_t eol = headers.find("\r\n");
+            const std::string_view h = headers.substr(0, eol);
+            headers = (eol == std::string_view::npos) ? std::string_view{} : headers.substr(eol + 2);
+            const std::size_t colon = h.find(':');
+            if (colon == std::string_view::npos) continue;
+            const std::string_view name = trim(h.substr(0, colon));
+            const std::string_view value = trim(h.substr(colon + 1));
+            if (iequals(name, "Connection")) {
+                if (icontains(value, "close")) keep_alive = false;
+                if (icontains(value, "keep-alive")) keep_alive = true;
+            } else if (iequals(name, "Accept-Encoding")) {
+                want_gzip = icontains(value, "gzip");
+            } else if (iequals(name, "Content-Length")) {
+                body_ok = body_ok && parse_content_length(value, kMaxRequestBody, body);
+            } else if (iequals(name, "Transfer-Encoding")) {
+                // 不支持分块 body：长度未知，无法在上限内判定请求边界。
+                body_ok = false;
+            }
+        }
+        if (!body_ok) {
+            reject("413 Payload Too Large");
+            break;
+        }
+        // body 收齐后整体丢弃（抓取端点不使用 body）；未收齐时等待更多输入。
+        if (c.in.size() < end + 4 + body) break;
         const bool ok = (method == "GET" && path == opts_.path);
+        c.in.erase(0, end + 4 + body);
+        c.keep_alive = c.keep_alive && keep_alive;
+        c.want_gzip = want_gzip;
 
         if (!ok) {
-            static constexpr const char kHdr[] =
-                "HTTP/1.1 404 Not Found\r\n"
-                "Content-Type: text/plain; charset=utf-8\r\n"
-                "Content-Length: 9\r\n"
-                "Connection: close\r\n"
-                "\r\n"
-                "not_found";
-            write_all_(fd, kHdr, sizeof(kHdr) - 1);
-            ::close(fd);
+            c.out += "HTTP/1.1 404 Not Found\r\n"
+                     "Content-Type: text/plain; charset=utf-8\r\n"
+                     "Content-Length: 9\r\n";
+            c.out += c.keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+            c.out += "\r\nnot_found";
+            if (!c.keep_alive) c.close_after_write = true;
             continue;
         }
 
-        std::string body;
-        try {
-            body = render_ ? render_() : std::string{};
-        } catch (...) {
-            body.clear();
+        if (const auto snap = fresh_snapshot_()) {
+            respond_(c, *snap);
+        } else {
+            c.waiting = true;
+            request_render_();
+        }
+    }
+
+    // 等待渲染期间缓冲满时暂停读取（否则水平触发的可读事件会空转）；请求处理完后恢复。
+    const bool pause = c.waiting && c.in.size() >= kMaxBufferedInput;
+    if (pause != c.read_paused) {
+        c.read_paused = pause;
+        update_events_(c);
+    }
+    (void)flush_(c);
+}
+
+void MetricsHttpServer::respond_(Conn& c, const Snapshot& snap) {
+    const bool gz = c.want_gzip && !snap.gzip_body.empty();
+    const std::string& body = gz ? snap.gzip_body : snap.body;
+
+    c.out += "HTTP/1.1 200 OK\r\n"
+             "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+    if (gz) c.out += "Content-Encoding: gzip\r\n";
+    if (opts_.gzip) c.out += "Vary: Accept-Encoding\r\n";
+    c.out += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    c.out += c.keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    c.out += "\r\n";
+    c.out += body;
+    if (!c.keep_alive) c.close_after_write = true;
+}
+
+bool MetricsHttpServer::flush_(Conn& c) {
+    while (c.out_off < c.out.size()) {
+        const ssize_t n = ::send(c.fd, c.out.data() + c.out_off, c.out.size() - c.out_off, MSG_NOSIGNAL);
+        if (n > 0) {
+            c.out_off += static_cast<std::size_t>(n);
+            c.last_active = std::chrono::steady_clock::now();
+            c.last_write = c.last_active;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // 慢客户端：等待可写事件，不阻塞事件循环。
+            if (!c.want_write) {
+                c.want_write = true;
+                // 从这一刻起计写停滞（此前可能很久没有输出，last_write 是旧值）。
+                c.last_write = std::chrono::steady_clock::now();
+                update_events_(c);
+            }
+            return true;
         }
+        close_conn_(c.fd);
+        return false;
+    }
 
-        const std::string hdr =
-            "HTTP/1.1 200 OK\r\n"
-            "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
-            "Content-Length: " + std::to_string(body.size()) + "\r\n"
-            "Connection: close\r\n"
-            "\r\n";
+    c.out.clear();
+    c.out_off = 0;
+    if (c.close_after_write && !c.waiting) {
+        close_conn_(c.fd);
+        return false;
+    }
+    if (c.want_write) {
+        c.want_write = false;
+        update_events_(c);
+    }
+    return true;
+}
 
-        write_all_(fd, hdr.data(), hdr.size());
-        if (!body.empty()) write_all_(fd, body.data(), body.size());
+void MetricsHttpServer::update_events_(Conn& c) {
+    epoll_event ev{};
+    ev.events = (c.read_closed || c.read_paused ? 0u : static_cast<std::uint32_t>(EPOLLIN | EPOLLRDHUP)) | (c.want_write ? EPOLLOUT : 0u);
+    ev.data.fd = c.fd;
+    (void)::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, c.fd, &ev);
+}
 
-        ::close(fd);
+void MetricsHttpServer::sweep_idle_() {
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<int> idle;
+    for (const auto& kv : conns_) {
+        const Conn& c = kv.second;
+        const bool pending_out = c.out_off < c.out.size();
+        if (pending_out) {
+            // 对端不读（接收窗口已满）时 last_active 仍可能被新到的请求刷新，写停滞单独按 last_write 判定。
+            if (c.want_write && now - c.last_write >= opts_.write_timeout) idle.push_back(kv.first);
+        } else if (!c.waiting && now - c.last_active >= opts_.idle_timeout) {
+            idle.push_back(kv.first);
+        }
     }
+    for (const int fd : idle) close_conn_(fd);
 }
 
 } // namespace wxz::core
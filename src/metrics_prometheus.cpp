@@ -2,15 +2,47 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
+#include <limits>
 #include <sstream>
+#include <tuple>
+#include <utility>
 
 namespace wxz::core {
 
 namespace {
-std::string escape_label_value(std::string_view v) {
-    std::string out;
-    out.reserve(v.size());
+
+constexpr double kSketchMinValue = 1e-3;
+constexpr double kSketchMaxValue = 1e9;
+
+void atomic_add(std::atomic<double>& a, double v) noexcept {
+    double cur = a.load(std::memory_order_relaxed);
+    while (!a.compare_exchange_weak(cur, cur + v, std::memory_order_relaxed)) {
+    }
+}
+
+// 驻留键缓存：每线程一张直接映射表，键为 (类型, 原始 name, 原始 labels) 的长度前缀编码。
+// 条目记录 sink id，sink 析构后其条目不会再命中（id 不复用）。
+struct InternEntry {
+    std::uint64_t sink_id{0};
+    std::size_t hash{0};
+    std::string raw;
+    void* cell{nullptr};
+};
+
+constexpr std::size_t kInternSlots = 256;
+
+void append_piece(std::string& out, std::string_view v) {
+    const auto n = static_cast<std::uint32_t>(v.size());
+    out.append(reinterpret_cast<const char*>(&n), sizeof(n));
+    out.append(v.data(), v.size());
+}
+
+std::atomic<std::uint64_t> g_next_sink_id{1};
+
+void append_escaped(std::string& out, std::string_view v) {
     for (char c : v) {
         switch (c) {
             case '\\':
@@ -27,32 +59,31 @@ std::string escape_label_value(std::string_view v) {
                 break;
         }
     }
-    return out;
 }
 
-std::string labels_to_string(std::initializer_list<LabelView> labels) {
-    if (labels.size() == 0) return {};
-
-    std::ostringstream out;
-    out << '{';
-    bool first = true;
+// 就地构造 label 串（复用 out 的容量，热路径上不分配）。
+void labels_into(std::string& out, std::initializer_list<LabelView> labels) {
+    out.clear();
     for (const auto& kv : labels) {
         if (kv.key.empty()) continue;
-        if (!first) out << ',';
-        first = false;
-        out << kv.key << "=\"" << escape_label_value(kv.value) << "\"";
+        out.push_back(out.empty() ? '{' : ',');
+        out.append(kv.key.data(), kv.key.size());
+        out += "=\"";
+        append_escaped(out, kv.value);
+        out.push_back('"');
     }
-    out << '}';
-    const auto s = out.str();
     // 如果所有 label 的 key 都为空，则输出空字符串。
-    return (s == "{}") ? std::string{} : s;
+    if (!out.empty()) out.push_back('}');
 }
 
-} // namespace
-
-std::string PrometheusMetricsSink::sanitize_metric_name_(std::string_view in) {
+std::string labels_to_string(std::initializer_list<LabelView> labels) {
     std::string out;
-    out.reserve(in.size());
+    labels_into(out, labels);
+    return out;
+}
+
+void sanitize_into(std::string& out, std::string_view in) {
+    out.clear();
     for (char c : in) {
         if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == ':') {
             out.push_back(c);
@@ -63,66 +94,312 @@ std::string PrometheusMetricsSink::sanitize_metric_name_(std::string_view in) {
     if (out.empty()) out = "wxz_metric";
     // Prometheus 的名称不应以数字开头。
     if (out[0] >= '0' && out[0] <= '9') out.insert(out.begin(), '_');
+}
+
+// 最短可往返的浮点文本（le/quantile 标签值须与桶上界精确一致）。
+std::string format_double(double v) {
+    if (std::isinf(v)) return v > 0 ? "+Inf" : "-Inf";
+    if (std::isnan(v)) return "NaN";
+    char buf[32];
+    for (int prec = 6; prec <= 17; ++prec) {
+        std::snprintf(buf, sizeof(buf), "%.*g", prec, v);
+        if (std::strtod(buf, nullptr) == v) break;
+    }
+    return buf;
+}
+
+// 在已渲染的 label 串（"{...}" 或空）后追加一个 label。
+void write_labels_with(std::ostringstream& out, const std::string& labels, const char* key, const std::string& value) {
+    if (labels.empty()) {
+        out << '{';
+    } else {
+        out.write(labels.data(), static_cast<std::streamsize>(labels.size() - 1));
+        out << ',';
+    }
+    out << key << "=\"" << value << "\"}";
+}
+
+} // namespace
+
+// DDSketch（固定值域、固定槽数）：值 v 落入下标 ceil(log_gamma(v)) 的槽，gamma=(1+a)/(1-a)，
+// 槽的代表值 2*gamma^i/(gamma+1) 与槽内任意值的相对误差不超过 a。槽数组在构造时一次分配。
+class PrometheusMetricsSink::Sketch {
+public:
+    explicit Sketch(double relative_accuracy)
+        : gamma_((1.0 + relative_accuracy) / (1.0 - relative_accuracy)), inv_log_gamma_(1.0 / std::log(gamma_)) {
+        min_index_ = index_of(kSketchMinValue);
+        max_index_ = index_of(kSketchMaxValue);
+        bins_.assign(static_cast<std::size_t>(max_index_ - min_index_ + 1), 0);
+    }
+
+    void add(double v) noexcept {
+        ++count_;
+        // 负数/NaN/过小值归入最低端。
+        if (!(v > kSketchMinValue)) {
+            ++low_;
+            return;
+        }
+        const int i = v >= kSketchMaxValue ? max_index_ : std::clamp(index_of(v), min_index_, max_index_);
+        ++bins_[static_cast<std::size_t>(i - min_index_)];
+    }
+
+    std::uint64_t count() const noexcept { return count_; }
+
+    double quantile(double q) const noexcept {
+        if (count_ == 0) return std::numeric_limits<double>::quiet_NaN();
+        const double rank = q * static_cast<double>(count_ - 1);
+        std::uint64_t cum = low_;
+        if (static_cast<double>(cum) > rank) return kSketchMinValue;
+        for (std::size_t k = 0; k < bins_.size(); ++k) {
+            cum += bins_[k];
+            if (static_cast<double>(cum) > rank) return value_of(min_index_ + static_cast<int>(k));
+        }
+        return value_of(max_index_);
+    }
+
+private:
+    int index_of(double v) const noexcept { return static_cast<int>(std::ceil(std::log(v) * inv_log_gamma_)); }
+    double value_of(int i) const noexcept { return 2.0 * std::pow(gamma_, i) / (gamma_ + 1.0); }
+
+    double gamma_;
+    double inv_log_gamma_;
+    int min_index_{0};
+    int max_index_{0};
+    std::uint64_t count_{0};
+    std::uint64_t low_{0};
+    std::vector<std::uint64_t> bins_;
+};
+
+struct PrometheusMetricsSink::HistogramData {
+    // 每个分片的桶计数占若干整缓存行，分片之间不共享缓存行。
+    static constexpr std::size_t kPerLine = kCacheLineSize / sizeof(std::atomic<std::uint64_t>);
+    struct alignas(kCacheLineSize) Line {
+        std::atomic<std::uint64_t> v[kPerLine];
+    };
+
+    explicit HistogramData(std::shared_ptr<const HistogramLayout> l)
+        : layout(std::move(l)),
+          nbuckets(layout->bounds.size() + 1),
+          lines_per_shard((nbuckets + kPerLine - 1) / kPerLine),
+          lines(std::make_unique<Line[]>(lines_per_shard * kThreadShards)),
+          sketch(layout->quantiles.empty() ? nullptr : std::make_unique<Sketch>(layout->relative_accuracy)) {}
+
+    std::atomic<std::uint64_t>& bucket(std::size_t shard, std::size_t i) noexcept {
+        return lines[shard * lines_per_shard + i / kPerLine].v[i % kPerLine];
+    }
+    std::uint64_t bucket_total(std::size_t i) const noexcept {
+        std::uint64_t n = 0;
+        for (std::size_t sh = 0; sh < kThreadShards; ++sh) {
+            n += lines[sh * lines_per_shard + i / kPerLine].v[i % kPerLine].load(std::memory_order_relaxed);
+        }
+        return n;
+    }
+    double sum_total() const noexcept {
+        double s = 0.0;
+        for (const auto& sh : sums) s += sh.value.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    const std::shared_ptr<const HistogramLayout> layout;
+    const std::size_t nbuckets;
+    const std::size_t lines_per_shard;
+    // bucket(shard, i) 为落在 (bounds[i-1], bounds[i]] 的次数，i==bounds.size() 为 +Inf 桶；渲染时累加。
+    std::unique_ptr<Line[]> lines;
+    std::array<DoubleShard, kThreadShards> sums{};
+    // sketch 本身不是线程安全的，按序列加锁。
+    std::mutex sketch_mu;
+    const std::unique_ptr<Sketch> sketch;
+};
+
+std::vector<double> PrometheusMetricsSink::exponential_buckets(double start, double factor, std::size_t count) {
+    std::vector<double> out;
+    if (!(start > 0.0) || !(factor > 1.0)) return out;
+    out.reserve(count);
+    double v = start;
+    for (std::size_t i = 0; i < count; ++i, v *= factor) out.push_back(v);
     return out;
 }
 
-std::string PrometheusMetricsSink::escape_label_value_(std::string_view v) {
+namespace {
+
+std::vector<double> normalize_bounds(std::vector<double> b) {
+    b.erase(std::remove_if(b.begin(), b.end(), [](double v) { return !std::isfinite(v); }), b.end());
+    std::sort(b.begin(), b.end());
+    b.erase(std::unique(b.begin(), b.end()), b.end());
+    if (b.size() > PrometheusMetricsSink::kMaxBuckets) b.resize(PrometheusMetricsSink::kMaxBuckets);
+    return b;
+}
+
+} // namespace
+
+PrometheusMetricsSink::PrometheusMetricsSink(Options opts) : id_(g_next_sink_id.fetch_add(1, std::memory_order_relaxed)) {
+    auto layout = std::make_shared<HistogramLayout>();
+    layout->bounds = normalize_bounds(std::move(opts.default_buckets));
+    default_layout_ = std::move(layout);
+}
+
+PrometheusMetricsSink::~PrometheusMetricsSink() = default;
+
+std::string PrometheusMetricsSink::sanitize_metric_name_(std::string_view in) {
     std::string out;
-    out.reserve(v.size());
-    for (char c : v) {
-        switch (c) {
-            case '\\':
-                out += "\\\\";
-                break;
-            case '\n':
-                out += "\\n";
-                break;
-            case '"':
-                out += "\\\"";
-                break;
-            default:
-                out.push_back(c);
-                break;
+    out.reserve(in.size());
+    sanitize_into(out, in);
+    return out;
+}
+
+std::shared_ptr<const PrometheusMetricsSink::HistogramLayout> PrometheusMetricsSink::layout_for_(const std::string& family) const {
+    const auto it = layouts_.find(family);
+    return it != layouts_.end() ? it->second : default_layout_;
+}
+
+PrometheusMetricsSink::HistogramData* PrometheusMetricsSink::new_histogram_data_(std::shared_ptr<const HistogramLayout> layout) {
+    histogram_data_.push_back(std::make_unique<HistogramData>(std::move(layout)));
+    return histogram_data_.back().get();
+}
+
+void PrometheusMetricsSink::reset_histograms_(const std::string& family) {
+    const auto layout = layout_for_(family);
+    for (auto& kv : histograms_) {
+        if (kv.first.name == family) kv.second.data.store(new_histogram_data_(layout), std::memory_order_release);
+    }
+}
+
+void* PrometheusMetricsSink::register_cell_(Type t, const Key& key) {
+    if (types_.find(key.name) == types_.end()) types_.emplace(key.name, t);
+    switch (t) {
+        case Type::Counter: {
+            auto it = counters_.find(key);
+            if (it == counters_.end()) {
+                it = counters_.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first;
+            }
+            return &it->second;
+        }
+        case Type::Gauge: {
+            auto it = gauges_.find(key);
+            if (it == gauges_.end()) {
+                it = gauges_.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first;
+            }
+            return &it->second;
+        }
+        case Type::Histogram: {
+            auto it = histograms_.find(key);
+            if (it == histograms_.end()) {
+                it = histograms_.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first;
+                it->second.data.store(new_histogram_data_(layout_for_(key.name)), std::memory_order_release);
+            }
+            return &it->second;
         }
     }
-    return out;
+    return nullptr;
+}
+
+void* PrometheusMetricsSink::cached_cell_(Type t, std::string_view name, std::initializer_list<LabelView> labels) {
+    thread_local std::array<InternEntry, kInternSlots> cache;
+    thread_local std::string raw;
+    raw.clear();
+    raw.push_back(static_cast<char>(t));
+    append_piece(raw, name);
+    for (const auto& kv : labels) {
+        append_piece(raw, kv.key);
+        append_piece(raw, kv.value);
+    }
+    const std::size_t h = std::hash<std::string_view>{}(raw);
+    auto& e = cache[h & (kInternSlots - 1)];
+    if (e.sink_id == id_ && e.hash == h && e.raw == raw) return e.cell;
+
+    thread_local Key key;
+    sanitize_into(key.name, name);
+    labels_into(key.labels, labels);
+    void* cell = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cell = register_cell_(t, key);
+    }
+    e.sink_id = id_;
+    e.hash = h;
+    e.raw = raw;
+    e.cell = cell;
+    return cell;
+}
+
+void PrometheusMetricsSink::observe_histogram_(HistogramCell& cell, double value) noexcept {
+    HistogramData* d = cell.data.load(std::memory_order_acquire);
+    // le 语义：落入第一个 >= value 的桶；NaN 与超出上界的值落入 +Inf 桶。
+    const auto& b = d->layout->bounds;
+    const auto idx = static_cast<std::size_t>(std::lower_bound(b.begin(), b.end(), value) - b.begin());
+    const std::size_t shard = thread_shard_index();
+    d->bucket(shard, idx).fetch_add(1, std::memory_order_relaxed);
+    atomic_add(d->sums[shard].value, value);
+    if (d->sketch) {
+        std::lock_guard<std::mutex> lock(d->sketch_mu);
+        d->sketch->add(value);
+    }
+}
+
+PrometheusMetricsSink::CounterHandle PrometheusMetricsSink::counter(std::string_view name, std::initializer_list<LabelView> labels) {
+    const Key key{sanitize_metric_name_(name), labels_to_string(labels)};
+    std::lock_guard<std::mutex> lock(mutex_);
+    return CounterHandle(static_cast<CounterCell*>(register_cell_(Type::Counter, key)));
+}
+
+PrometheusMetricsSink::GaugeHandle PrometheusMetricsSink::gauge(std::string_view name, std::initializer_list<LabelView> labels) {
+    const Key key{sanitize_metric_name_(name), labels_to_string(labels)};
+    std::lock_guard<std::mutex> lock(mutex_);
+    return GaugeHandle(static_cast<GaugeCell*>(register_cell_(Type::Gauge, key)));
+}
+
+PrometheusMetricsSink::HistogramHandle PrometheusMetricsSink::histogram(std::string_view name, std::initializer_list<LabelView> labels) {
+    const Key key{sanitize_metric_name_(name), labels_to_string(labels)};
+    std::lock_guard<std::mutex> lock(mutex_);
+    return HistogramHandle(static_cast<HistogramCell*>(register_cell_(Type::Histogram, key)));
 }
 
-std::string PrometheusMetricsSink::render_labels_(std::initializer_list<LabelView> labels) {
-    return labels_to_string(labels);
+void PrometheusMetricsSink::set_histogram_buckets(std::string_view name, std::vector<double> upper_bounds) {
+    const auto n = sanitize_metric_name_(name);
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto cur = layout_for_(n);
+    if (upper_bounds.empty() && cur->quantiles.empty()) {
+        layouts_.erase(n);
+    } else {
+        auto layout = std::make_shared<HistogramLayout>(*cur);
+        layout->bounds = upper_bounds.empty() ? default_layout_->bounds : normalize_bounds(std::move(upper_bounds));
+        layouts_[n] = std::move(layout);
+    }
+    reset_histograms_(n);
+}
+
+void PrometheusMetricsSink::set_histogram_quantiles(std::string_view name, std::vector<double> quantiles, double relative_accuracy) {
+    quantiles.erase(std::remove_if(quantiles.begin(), quantiles.end(), [](double q) { return !(q > 0.0 && q < 1.0); }),
+                    quantiles.end());
+    std::sort(quantiles.begin(), quantiles.end());
+    quantiles.erase(std::unique(quantiles.begin(), quantiles.end()), quantiles.end());
+
+    const auto n = sanitize_metric_name_(name);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto layout = std::make_shared<HistogramLayout>(*layout_for_(n));
+    layout->quantiles = std::move(quantiles);
+    layout->relative_accuracy = layout->quantiles.empty() ? 0.0 : std::clamp(relative_accuracy, 1e-4, 0.1);
+    layouts_[n] = std::move(layout);
+    reset_histograms_(n);
 }
 
 void PrometheusMetricsSink::counter_add(std::string_view name, double value, std::initializer_list<LabelView> labels) noexcept {
     try {
-        const auto n = sanitize_metric_name_(name);
-        const auto l = labels_to_string(labels);
-        std::lock_guard<std::mutex> lock(mutex_);
-        types_.emplace(n, Type::Counter);
-        counters_[Key{n, l}] += value;
+        static_cast<CounterCell*>(cached_cell_(Type::Counter, name, labels))->add(value);
     } catch (...) {
     }
 }
 
 void PrometheusMetricsSink::gauge_set(std::string_view name, double value, std::initializer_list<LabelView> labels) noexcept {
     try {
-        const auto n = sanitize_metric_name_(name);
-        const auto l = labels_to_string(labels);
-        std::lock_guard<std::mutex> lock(mutex_);
-        types_.emplace(n, Type::Gauge);
-        gauges_[Key{n, l}] = value;
+        static_cast<GaugeCell*>(cached_cell_(Type::Gauge, name, labels))->value.store(value, std::memory_order_relaxed);
     } catch (...) {
     }
 }
 
 void PrometheusMetricsSink::histogram_observe(std::string_view name, double value, std::initializer_list<LabelView> labels) noexcept {
     try {
-        const auto n = sanitize_metric_name_(name);
-        const auto l = labels_to_string(labels);
-        std::lock_guard<std::mutex> lock(mutex_);
-        types_.emplace(n, Type::Histogram);
-        auto& st = histograms_[Key{n, l}];
-        st.count += 1;
-        st.sum += value;
+        observe_histogram_(*static_cast<HistogramCell*>(cached_cell_(Type::Histogram, name, labels)), value);
     } catch (...) {
     }
 }
@@ -158,28 +435,72 @@ std::string PrometheusMetricsSink::render() const {
         if (t == Type::Counter) {
             for (const auto& kv : counters_) {
                 if (kv.first.name != fam) continue;
+                double v = 0.0;
+                for (const auto& sh : kv.second.shards) v += sh.value.load(std::memory_order_relaxed);
                 out << kv.first.name;
                 if (!kv.first.labels.empty()) out << kv.first.labels;
-                out << ' ' << kv.second << "\n";
+                out << ' ' << v << "\n";
             }
         } else if (t == Type::Gauge) {
             for (const auto& kv : gauges_) {
                 if (kv.first.name != fam) continue;
                 out << kv.first.name;
                 if (!kv.first.labels.empty()) out << kv.first.labels;
-                out << ' ' << kv.second << "\n";
+                out << ' ' << kv.second.value.load(std::memory_order_relaxed) << "\n";
             }
         } else if (t == Type::Histogram) {
+            bool has_summary = false;
             for (const auto& kv : histograms_) {
                 if (kv.first.name != fam) continue;
-                // 暴露最小的 Prometheus histogram 字段。
-                out << kv.first.name << "_count";
-                if (!kv.first.labels.empty()) out << kv.first.labels;
-                out << ' ' << kv.second.count << "\n";
+                const HistogramData& st = *kv.second.data.load(std::memory_order_acquire);
+                has_summary = has_summary || st.sketch;
+                // _count 取各桶之和，保证与 +Inf 桶一致（分片汇总不是原子快照）。
+                std::uint64_t cum = 0;
+                for (std::size_t i = 0; i < st.nbuckets; ++i) {
+                    cum += st.bucket_total(i);
+                    const std::string le = i < st.layout->bounds.size() ? format_double(st.layout->bounds[i]) : "+Inf";
+                    out << kv.first.name << "_bucket";
+                    write_labels_with(out, kv.first.labels, "le", le);
+                    out << ' ' << cum << "\n";
+                }
 
                 out << kv.first.name << "_sum";
                 if (!kv.first.labels.empty()) out << kv.first.labels;
-                out << ' ' << kv.second.sum << "\n";
+                out << ' ' << st.sum_total() << "\n";
+
+                out << kv.first.name << "_count";
+                if (!kv.first.labels.empty()) out << kv.first.labels;
+                out << ' ' << cum << "\n";
+            }
+
+            // 分位数单独成一个 summary family（Prometheus 不允许在 histogram family 内混入 quantile 序列）。
+            if (has_summary) {
+                const std::string sfam = fam + "_summary";
+                out << "\n# TYPE " << sfam << " summary\n";
+                for (const auto& kv : histograms_) {
+                    if (kv.first.name != fam) continue;
+                    HistogramData& st = *kv.second.data.load(std::memory_order_acquire);
+                    if (!st.sketch) continue;
+                    std::lock_guard<std::mutex> sketch_lock(st.sketch_mu);
+                    for (const double q : st.layout->quantiles) {
+                        out << sfam;
+                        write_labels_with(out, kv.first.labels, "quantile", format_double(q));
+                        const double v = st.sketch->quantile(q);
+                        out << ' ';
+                        if (std::isnan(v)) {
+                            out << "NaN";
+                        } else {
+                            out << v;
+                        }
+                        out << "\n";
+                    }
+                    out << sfam << "_sum";
+                    if (!kv.first.labels.empty()) out << kv.first.labels;
+                    out << ' ' << st.sum_total() << "\n";
+                    out << sfam << "_count";
+                    if (!kv.first.labels.empty()) out << kv.first.labels;
+                    out << ' ' << st.sketch->count() << "\n";
+                }
             }
         }
 
@@ -1,5 +1,6 @@
 #include "internal/param_server.h"
 #include "internal/param_store.h"
+#include "internal/thread_policy.h"
 #include "logger.h"
 
 #include <chrono>
@@ -222,7 +223,10 @@ void ParamServer::maybeStartFetchThread() {
     if (fetch_thread_.joinable()) {
         fetch_thread_.join();
     }
-    fetch_thread_ = std::thread(&ParamServer::fetchLoop, this);
+    fetch_thread_ = std::thread([this] {
+        wxz::core::internal::apply_thread_policy("param_server", 1);
+        fetchLoop();
+    });
 }
 
 void ParamServer::setExportTopics(std::string request_topic, std::string reply_topic) {
@@ -237,7 +241,10 @@ void ParamServer::start() {
     ensureChannelsStarted();
     ensureExportChannelsStarted();
 
-    worker_ = std::thread(&ParamServer::loop, this);
+    worker_ = std::thread([this] {
+        wxz::core::internal::apply_thread_policy("param_server", 0);
+        loop();
+    });
     maybeStartFetchThread();
 }
 
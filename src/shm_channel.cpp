@@ -1,23 +1,63 @@
 #include "shm_channel.h"
 
+#include "internal/futex.h"
+#include "internal/thread_policy.h"
+#include "logger.h"
 #include "observability.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <chrono>
+#include <csignal>
 #include <cstring>
 #include <ctime>
 #include <fcntl.h>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/types.h>
 #include <unistd.h>
 
 namespace wxz::core {
 
 namespace {
-constexpr std::uint32_t kMagic = 0x53484d43; // SHMC
+// 布局变更（字节环 + 读者表 + futex 字；header/读者表按缓存行分隔）后更换 magic：
+// 旧版本二进制附加时直接报 magic mismatch，而不是误读布局。
+// SHM6：header 增加多写端认领游标 reserve。
+constexpr std::uint32_t kMagic = 0x53484d36; // SHM6
+constexpr std::uint32_t kFlagMultiProducer = 1u << 0;
+constexpr std::uint32_t kFlagSemaphoreNotify = 1u << 1;
+constexpr std::uint32_t kReaderFree = 0;
+constexpr std::uint32_t kReaderActive = 1;
+// 记录对齐：记录头与 payload 起始都落在 cache line 边界上。
+constexpr std::size_t kRecordAlign = 64;
+constexpr std::size_t kRecordHeaderBytes = 16; // sizeof(RecordHeader)，构造函数中 static_assert
+constexpr std::uint32_t kPadLen = 0xFFFFFFFFu;
 inline std::size_t align_up(std::size_t v, std::size_t a) { return (v + a - 1) & ~(a - 1); }
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shm ring requires lock-free 64-bit atomics");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "shm ring requires lock-free 32-bit atomics");
+
+bool pid_dead(std::int32_t pid) { return pid > 0 && ::kill(pid, 0) != 0 && errno == ESRCH; }
+
+inline std::size_t record_bytes(std::size_t payload) { return align_up(kRecordHeaderBytes + payload, kRecordAlign); }
+
+// 记录不超过环大小的一半时，任意位置预留所需的 padding + 记录都不超过环大小，空环时总能写入。
+std::size_t default_max_message(std::size_t ring) {
+    return (ring / 2) / kRecordAlign * kRecordAlign - kRecordHeaderBytes;
+}
+
+// 跨进程 futex（MAP_SHARED 内存）：不能使用 *_PRIVATE 变体。
+long futex_wait(std::atomic<std::uint32_t>* word, std::uint32_t expected, const struct timespec* timeout) {
+    return internal::futex_wait(word, expected, timeout, /*process_shared=*/true);
+}
+
+long futex_wake_all(std::atomic<std::uint32_t>* word) { return internal::futex_wake_all(word, /*process_shared=*/true); }
+
+using internal::cpu_relax;
 } // namespace
 
 std::string ShmChannel::normalize_name(const std::string& n) {
@@ -32,14 +72,47 @@ std::string ShmChannel::sem_name_from(const std::string& n) {
 }
 
 ShmChannel::ShmChannel(std::string name, std::size_t capacity, std::size_t slot_size, bool create)
-    : name_(normalize_name(name)), sem_name_(sem_name_from(name)), region_bytes_(0), owner_(create) {
-    if (slot_size < sizeof(std::uint32_t)) {
-        throw std::invalid_argument("slot_size too small");
-    }
-    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
-        throw std::invalid_argument("capacity must be power of two and > 0");
+    : ShmChannel(std::move(name), capacity, slot_size, create, Options{}) {}
+
+ShmChannel::ShmChannel(std::string name, std::size_t capacity, std::size_t slot_size, bool create, const Options& opts)
+    : name_(normalize_name(name)),
+      sem_name_(sem_name_from(name)),
+      region_bytes_(0),
+      owner_(create),
+      // 单核上自旋只会抢占写端的 CPU。
+      spin_max_(std::thread::hardware_concurrency() > 1 ? opts.spin_iterations : 0),
+      spin_limit_(spin_max_),
+      max_batch_(std::max<std::size_t>(opts.max_batch, 1)) {
+    static_assert(sizeof(RecordHeader) == kRecordHeaderBytes, "record header layout");
+    batch_.reserve(max_batch_);
+    positions_.reserve(max_batch_);
+    std::size_t ring = 0;
+    std::size_t max_message = 0;
+    std::size_t readers_off = align_up(sizeof(Header), kCacheLineSize);
+    std::size_t ring_off = 0;
+    if (create) {
+        if (opts.max_readers == 0) {
+            throw std::invalid_argument("max_readers must be > 0");
+        }
+        if (opts.ring_bytes != 0) {
+            ring = align_up(opts.ring_bytes, kRecordAlign);
+        } else {
+            if (capacity == 0 || slot_size < sizeof(std::uint32_t)) {
+                throw std::invalid_argument("capacity/slot_size too small");
+            }
+            // 与旧 slot 布局一致：slot_size 含 4 字节长度，capacity 条满载消息占用相同的字节数。
+            ring = capacity * record_bytes(slot_size - sizeof(std::uint32_t));
+        }
+        if (ring < 2 * kRecordAlign) {
+            throw std::invalid_argument("shm ring too small");
+        }
+        max_message = opts.max_message != 0 ? opts.max_message : default_max_message(ring);
+        if (record_bytes(max_message) > ring / 2 || record_bytes(max_message) >= kPadLen) {
+            throw std::invalid_argument("max_message too large for shm ring");
+        }
+        ring_off = align_up(readers_off + opts.max_readers * sizeof(ReaderEntry), 64);
+        region_bytes_ = ring_off + ring;
     }
-    region_bytes_ = align_up(sizeof(Header) + capacity * slot_size, 64);
 
     int flags = create ? (O_CREAT | O_RDWR) : O_RDWR;
     shm_fd_ = ::shm_open(name_.c_str(), flags, 0666);
@@ -47,10 +120,19 @@ ShmChannel::ShmChannel(std::string name, std::size_t capacity, std::size_t slot_
         throw std::runtime_error("shm_open failed");
     }
     if (create) {
-        if (ftruncate(shm_fd_, static_cast<off_t>(region_bytes_)) != 0) {
+        // 先截断到 0：字节环必须全零，避免上一次运行残留的记录头被误认为已提交。
+        if (ftruncate(shm_fd_, 0) != 0 || ftruncate(shm_fd_, static_cast<off_t>(region_bytes_)) != 0) {
             ::close(shm_fd_);
             throw std::runtime_error("ftruncate failed");
         }
+    } else {
+        // 附加方以实际对象大小映射，布局参数以 header 为准（capacity/slot_size 参数仅用于创建）。
+        struct stat st {};
+        if (::fstat(shm_fd_, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(Header)) {
+            ::close(shm_fd_);
+            throw std::runtime_error("shm region not initialized");
+        }
+        region_bytes_ = static_cast<std::size_t>(st.st_size);
     }
 
     void* addr = mmap(nullptr, region_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0);
@@ -61,6 +143,22 @@ ShmChannel::ShmChannel(std::string name, std::size_t capacity, std::size_t slot_
     base_ = static_cast<std::uint8_t*>(addr);
     hdr_ = reinterpret_cast<Header*>(base_);
 
+    if (!create) {
+        bool ok = hdr_->magic == kMagic && hdr_->max_readers != 0 && hdr_->ring_bytes >= 2 * kRecordAlign &&
+                  hdr_->ring_bytes % kRecordAlign == 0 && record_bytes(hdr_->max_message) <= hdr_->ring_bytes / 2;
+        if (ok) {
+            ring_off = align_up(readers_off + hdr_->max_readers * sizeof(ReaderEntry), 64);
+            ok = region_bytes_ >= ring_off + hdr_->ring_bytes;
+        }
+        if (!ok) {
+            munmap(base_, region_bytes_);
+            ::close(shm_fd_);
+            throw std::runtime_error("shm magic mismatch");
+        }
+    }
+    readers_base_ = base_ + readers_off;
+    ring_base_ = base_ + ring_off;
+
     sem_t* s = nullptr;
     if (create) {
         ::sem_unlink(sem_name_.c_str());
@@ -76,18 +174,29 @@ ShmChannel::ShmChannel(std::string name, std::size_t capacity, std::size_t slot_
     sem_ = s;
 
     if (create) {
+        hdr_->mode = static_cast<std::uint32_t>(opts.mode);
+        hdr_->flags = (opts.multi_producer ? kFlagMultiProducer : 0) |
+                      (opts.notify == Notify::semaphore ? kFlagSemaphoreNotify : 0);
+        hdr_->max_readers = static_cast<std::uint32_t>(opts.max_readers);
+        hdr_->ring_bytes = ring;
+        hdr_->max_message = max_message;
         hdr_->head.store(0, std::memory_order_relaxed);
+        hdr_->reserve.store(0, std::memory_order_relaxed);
         hdr_->tail.store(0, std::memory_order_relaxed);
-        hdr_->capacity = static_cast<std::uint32_t>(capacity);
-        hdr_->slot_size = static_cast<std::uint32_t>(slot_size);
-        hdr_->magic = kMagic;
-    } else {
-        if (hdr_->magic != kMagic) {
-            munmap(base_, region_bytes_);
-            ::close(shm_fd_);
-            ::sem_close(sem_);
-            throw std::runtime_error("shm magic mismatch");
+        hdr_->reclaim.store(0, std::memory_order_relaxed);
+        hdr_->notify_seq.store(0, std::memory_order_relaxed);
+        hdr_->waiters.store(0, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < opts.max_readers; ++i) {
+            auto* e = reader_entry(i);
+            e->state.store(kReaderFree, std::memory_order_relaxed);
+            e->pid.store(0, std::memory_order_relaxed);
+            e->cursor.store(0, std::memory_order_relaxed);
+            e->lapped.store(0, std::memory_order_relaxed);
+            ::sem_init(&e->sem, /*pshared=*/1, 0);
         }
+        // magic 最后写入：附加方看到 magic 时其余字段已初始化完毕。
+        std::atomic_thread_fence(std::memory_order_release);
+        hdr_->magic = kMagic;
     }
 }
 
@@ -102,123 +211,613 @@ ShmChannel::~ShmChannel() {
     }
 }
 
-ShmChannel::SlotView ShmChannel::slot(std::uint32_t idx) const {
-    std::size_t stride = hdr_->slot_size;
-    std::uint8_t* ptr = base_ + sizeof(Header) + static_cast<std::size_t>(idx) * stride;
-    return {ptr, stride};
+ShmChannel::Mode ShmChannel::mode() const { return hdr_ ? static_cast<Mode>(hdr_->mode) : Mode::queue; }
+
+ShmChannel::Notify ShmChannel::notify_mode() const {
+    if (!hdr_) return Notify::futex;
+    return (hdr_->flags & kFlagSemaphoreNotify) != 0 ? Notify::semaphore : Notify::futex;
+}
+
+std::size_t ShmChannel::max_message() const { return hdr_ ? static_cast<std::size_t>(hdr_->max_message) : 0; }
+
+ShmChannel::RecordHeader* ShmChannel::record(std::uint64_t pos) const {
+    return reinterpret_cast<RecordHeader*>(ring_base_ + static_cast<std::size_t>(pos % hdr_->ring_bytes));
 }
 
-bool ShmChannel::publish(const std::uint8_t* data, std::size_t size) {
-    if (!hdr_) return false;
-    std::uint32_t head = hdr_->head.load(std::memory_order_acquire);
-    std::uint32_t tail = hdr_->tail.load(std::memory_order_acquire);
-    std::uint32_t cap = hdr_->capacity;
-    if (static_cast<std::uint32_t>(head - tail) >= cap) {
-        publish_fail_.fetch_add(1, std::memory_order_relaxed);
+ShmChannel::ReaderEntry* ShmChannel::reader_entry(std::size_t i) const {
+    return reinterpret_cast<ReaderEntry*>(readers_base_ + i * sizeof(ReaderEntry));
+}
+
+void ShmChannel::count_publish(bool ok, std::size_t size) {
+    if (!ok) {
+        ++publish_fail_;
         if (wxz::core::has_metrics_sink()) {
             wxz::core::metrics().counter_add("wxz.shm.publish.fail", 1, {});
         }
-        return false; // full
-    }
-    std::uint32_t idx = head & (cap - 1);
-    auto sv = slot(idx);
-    std::uint32_t max_payload = hdr_->slot_size - static_cast<std::uint32_t>(sizeof(std::uint32_t));
-    std::uint32_t copy = static_cast<std::uint32_t>(std::min<std::size_t>(size, max_payload));
-    std::memcpy(sv.ptr + sizeof(std::uint32_t), data, copy);
-    std::memcpy(sv.ptr, &copy, sizeof(std::uint32_t));
-    hdr_->head.store(head + 1, std::memory_order_release);
-    ::sem_post(sem_);
-    publish_success_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ++publish_success_;
     if (wxz::core::has_metrics_sink()) {
         wxz::core::metrics().counter_add("wxz.shm.publish.success", 1, {});
-        wxz::core::metrics().histogram_observe("wxz.shm.publish.bytes", static_cast<double>(copy), {});
+        wxz::core::metrics().histogram_observe("wxz.shm.publish.bytes", static_cast<double>(size), {});
+    }
+}
+
+bool ShmChannel::reject_oversize(std::size_t size) {
+    if (size <= hdr_->max_message) return false;
+    const auto n = publish_oversize_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (wxz::core::has_metrics_sink()) {
+        wxz::core::metrics().counter_add("wxz.shm.publish.oversize", 1, {});
+    }
+    if (n == 1 || (n % 1024) == 0) {
+        wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                             "shm message exceeds max_message, rejected",
+                                             {{"name", name_},
+                                              {"size", std::to_string(size)},
+                                              {"max_message", std::to_string(hdr_->max_message)},
+                                              {"oversize_total", std::to_string(n)}});
+    }
+    count_publish(false, size);
+    return true;
+}
+
+bool ShmChannel::publish(const std::uint8_t* data, std::size_t size) {
+    if (!hdr_) return false;
+    if (reject_oversize(size)) return false;
+    std::uint64_t pos = 0;
+    if (!reserve_record(size, pos)) {
+        count_publish(false, size); // full
+        return false;
+    }
+    std::memcpy(reinterpret_cast<std::uint8_t*>(record(pos)) + sizeof(RecordHeader), data, size);
+    const bool ok = commit_record(pos, static_cast<std::uint32_t>(size));
+    count_publish(ok, size);
+    return ok;
+}
+
+ShmChannel::Reservation ShmChannel::reserve(std::size_t size) {
+    Reservation r;
+    if (!hdr_) return r;
+    if (reject_oversize(size)) return r;
+    std::uint64_t pos = 0;
+    if (!reserve_record(size, pos)) {
+        count_publish(false, size);
+        return r;
+    }
+    r.channel_ = this;
+    r.pos_ = pos;
+    r.data_ = reinterpret_cast<std::uint8_t*>(record(pos)) + sizeof(RecordHeader);
+    r.capacity_ = size;
+    return r;
+}
+
+bool ShmChannel::publish(Reservation&& r) {
+    Reservation res = std::move(r);
+    if (!res.valid() || res.channel_ != this) return false;
+    if (res.size_ > res.capacity_) {
+        count_publish(false, res.size_);
+        return false; // res 析构时以 padding 提交
+    }
+    const bool ok = commit_record(res.pos_, static_cast<std::uint32_t>(res.size_));
+    count_publish(ok, res.size_);
+    res.channel_ = nullptr;
+    return ok;
+}
+
+void ShmChannel::Reservation::release() {
+    if (!channel_) return;
+    // 放弃的预留仍需提交（作为 padding），否则读端会一直停在这里。
+    channel_->commit_record(pos_, kPadLen);
+    channel_ = nullptr;
+}
+
+void ShmChannel::invalidate_records(std::uint64_t pos, std::uint64_t pad) {
+    if (pad != 0) record(pos)->seq.store(2 * pos, std::memory_order_relaxed);
+    record(pos + pad)->seq.store(2 * (pos + pad), std::memory_order_relaxed);
+}
+
+bool ShmChannel::reserve_record(std::size_t size, std::uint64_t& pos) {
+    const bool mp = (hdr_->flags & kFlagMultiProducer) != 0;
+    const bool queue = mode() == Mode::queue;
+    const std::uint64_t ring = hdr_->ring_bytes;
+    const std::uint64_t rec = record_bytes(size);
+    // 单写端直接推进 head；多写端在 reserve 上认领，head 由下面按认领顺序推进。
+    std::atomic<std::uint64_t>& cursor = mp ? hdr_->reserve : hdr_->head;
+    std::uint64_t p = cursor.load(std::memory_order_relaxed);
+    std::uint64_t pad = 0;
+    for (;;) {
+        // 记录不跨越环尾：放不下时用 padding 补齐到环首。
+        const std::uint64_t idx = p % ring;
+        pad = idx + rec > ring ? ring - idx : 0;
+        const std::uint64_t end = p + pad + rec;
+        if (queue && end - hdr_->reclaim.load(std::memory_order_acquire) > ring) {
+            // 读端已消费但还没人推进 reclaim 时（例如两个读端交错完成），由写端补一次。
+            reclaim_consumed();
+            if (end - hdr_->reclaim.load(std::memory_order_acquire) > ring) return false; // full
+        }
+        if (!mp) {
+            // 单写端：先把本条（及 padding）记录头的 seq 置为“未提交”，再推进 head。
+            // 否则读端看到新 head 时，该位置残留的上一圈 payload 字节可能恰好等于 2*pos+1 而被当成已提交。
+            // 只改写 seq 字：对 broadcast 下仍在读这一位置旧记录的读端，效果等同于该记录已被覆盖。
+            invalidate_records(p, pad);
+            hdr_->head.store(end, std::memory_order_release);
+            break;
+        }
+        if (!hdr_->reserve.compare_exchange_weak(p, end, std::memory_order_relaxed)) continue;
+        // 多写端：认领成功后该区域才归本写端所有，此时读端还看不到它（head 未越过 p）。
+        // 与单写端相同，先置为未提交再让 head 越过它；head 按认领顺序推进，
+        // 前一个写端发布 head 之前本写端只能等待（窗口内没有用户代码，只有两次 seq 写入）。
+        invalidate_records(p, pad);
+        for (unsigned spins = 0; hdr_->head.load(std::memory_order_acquire) != p; ++spins) {
+            if (spins < 64) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        hdr_->head.store(end, std::memory_order_release);
+        break;
+    }
+    // broadcast 读端在读取后重读 head 判定是否被覆盖：head 的推进必须先于下面对环内存的写入可见。
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (pad != 0) {
+        auto* r = record(p);
+        r->len = kPadLen;
+        r->bytes = static_cast<std::uint32_t>(pad);
+        r->seq.store(2 * p + 1, std::memory_order_release);
+    }
+    pos = p + pad;
+    record(pos)->bytes = static_cast<std::uint32_t>(rec);
+    return true;
+}
+
+bool ShmChannel::commit_record(std::uint64_t pos, std::uint32_t len) {
+    auto* r = record(pos);
+    if (mode() == Mode::queue) {
+        // queue 模式下预留的空间在消费前不会被复用，提交不会失败。
+        r->len = len;
+        r->seq.store(2 * pos + 1, std::memory_order_release);
+        notify();
+        return true;
+    }
+
+    // broadcast：写端不等待任何人，持有预留期间（例如多写端时被调度出去）其他写端可能已整圈越过 pos，
+    // 这一位置此时属于更新的记录。此时再写 len/seq 会把本条的长度写进那条活记录、甚至把它标成本条，放弃提交。
+    // 后写入者在认领后先把 seq 置为 2*新位置（见 reserve_record），因此 CAS 2*pos -> 2*pos+1 失败即说明被覆盖。
+    std::uint64_t expected = 2 * pos;
+    const auto lapped = [&]() {
+        return hdr_->head.load(std::memory_order_acquire) - pos > hdr_->ring_bytes ||
+               r->seq.load(std::memory_order_acquire) != expected;
+    };
+    if (lapped()) {
+        drop_lapped_commit(len);
+        return false;
+    }
+    r->len = len;
+    if (!r->seq.compare_exchange_strong(expected, 2 * pos + 1, std::memory_order_release, std::memory_order_relaxed)) {
+        drop_lapped_commit(len);
+        return false;
     }
+    if (len != kPadLen) {
+        // tail 记录最新一条已提交消息，供被覆盖的读端跳读；多写端时只前进不后退。
+        if ((hdr_->flags & kFlagMultiProducer) == 0) {
+            hdr_->tail.store(pos, std::memory_order_release);
+        } else {
+            std::uint64_t cur = hdr_->tail.load(std::memory_order_relaxed);
+            while (cur < pos && !hdr_->tail.compare_exchange_weak(cur, pos, std::memory_order_release)) {
+            }
+        }
+    }
+    notify();
     return true;
 }
 
+void ShmChannel::drop_lapped_commit(std::uint32_t len) {
+    if (len == kPadLen) return; // 放弃的预留本来就不交付
+    if (wxz::core::has_metrics_sink()) {
+        wxz::core::metrics().counter_add("wxz.shm.publish.lapped", 1, {});
+    }
+}
+
+void ShmChannel::reclaim_consumed() {
+    std::uint64_t r = hdr_->reclaim.load(std::memory_order_seq_cst);
+    for (;;) {
+        if (r >= hdr_->tail.load(std::memory_order_seq_cst)) return;
+        auto* rec = record(r);
+        if (rec->seq.load(std::memory_order_seq_cst) != 2 * r + 2) return;
+        // 若 reclaim 已被他人推进，bytes 可能已被下一圈覆盖；此时 CAS 必然失败，不会用到错误的值。
+        const std::uint64_t next = r + rec->bytes;
+        if (hdr_->reclaim.compare_exchange_weak(r, next, std::memory_order_seq_cst)) r = next;
+    }
+}
+
+void ShmChannel::notify() {
+    if (notify_mode() == Notify::semaphore) {
+        if (mode() == Mode::queue) {
+            ::sem_post(sem_);
+            return;
+        }
+        for (std::size_t i = 0; i < hdr_->max_readers; ++i) {
+            auto* e = reader_entry(i);
+            if (e->state.load(std::memory_order_acquire) == kReaderActive) {
+                ::sem_post(&e->sem);
+            }
+        }
+        return;
+    }
+
+    // 与 wait_signal() 的 “waiters++ -> 读 notify_seq -> 检查数据” 配对（均为 seq_cst）：
+    // 要么这里看到 waiters>0 并唤醒，要么读端在 park 前已能看到本次提交的数据。
+    hdr_->notify_seq.fetch_add(1, std::memory_order_seq_cst);
+    if (hdr_->waiters.load(std::memory_order_seq_cst) != 0) {
+        (void)futex_wake_all(&hdr_->notify_seq);
+        if (wxz::core::has_metrics_sink()) {
+            wxz::core::metrics().counter_add("wxz.shm.notify.wake", 1, {});
+        }
+    }
+}
+
+std::size_t ShmChannel::reader_count() const {
+    if (!hdr_) return 0;
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < hdr_->max_readers; ++i) {
+        if (reader_entry(i)->state.load(std::memory_order_acquire) == kReaderActive) ++n;
+    }
+    return n;
+}
+
+std::uint64_t ShmChannel::slowest_reader_lag() const {
+    if (!hdr_) return 0;
+    const std::uint64_t head = hdr_->head.load(std::memory_order_acquire);
+    std::uint64_t lag = 0;
+    for (std::size_t i = 0; i < hdr_->max_readers; ++i) {
+        auto* e = reader_entry(i);
+        if (e->state.load(std::memory_order_acquire) != kReaderActive) continue;
+        const std::uint64_t c = e->cursor.load(std::memory_order_relaxed);
+        if (head > c) lag = std::max(lag, head - c);
+    }
+    return lag;
+}
+
+void ShmChannel::register_reader() {
+    const auto self = static_cast<std::int32_t>(::getpid());
+    for (std::size_t i = 0; i < hdr_->max_readers; ++i) {
+        auto* e = reader_entry(i);
+        bool claimed = false;
+        std::uint32_t expected = kReaderFree;
+        if (e->state.compare_exchange_strong(expected, kReaderActive, std::memory_order_acq_rel)) {
+            claimed = true;
+        } else {
+            // 回收已退出进程遗留的条目（崩溃时来不及注销）。
+            std::int32_t pid = e->pid.load(std::memory_order_relaxed);
+            if (pid != self && pid_dead(pid)) {
+                claimed = e->pid.compare_exchange_strong(pid, self, std::memory_order_acq_rel);
+            }
+        }
+        if (!claimed) continue;
+
+        e->pid.store(self, std::memory_order_relaxed);
+        e->lapped.store(0, std::memory_order_relaxed);
+        // 丢弃上一任持有者残留的信号量计数。
+        while (::sem_trywait(&e->sem) == 0) {
+        }
+        // 新读端只接收订阅之后的消息。
+        cursor_ = hdr_->head.load(std::memory_order_acquire);
+        e->cursor.store(cursor_, std::memory_order_relaxed);
+        reader_ = e;
+        return;
+    }
+    throw std::runtime_error("shm reader table full");
+}
+
+void ShmChannel::unregister_reader() {
+    if (!reader_) return;
+    reader_->pid.store(0, std::memory_order_relaxed);
+    reader_->state.store(kReaderFree, std::memory_order_release);
+    reader_ = nullptr;
+}
+
 void ShmChannel::subscribe(Handler handler) {
     auto sub = subscribe_scoped(std::move(handler), nullptr);
     sub.detach();
 }
 
 Subscription ShmChannel::subscribe_scoped(Handler handler, void* owner) {
+    HandlerEntry e;
+    e.owner = owner;
+    e.handler = std::move(handler);
+    return add_handler(std::move(e));
+}
+
+void ShmChannel::subscribe_batch(BatchHandler handler) {
+    auto sub = subscribe_batch_scoped(std::move(handler), nullptr);
+    sub.detach();
+}
+
+Subscription ShmChannel::subscribe_batch_scoped(BatchHandler handler, void* owner) {
+    HandlerEntry e;
+    e.owner = owner;
+    e.batch_handler = std::move(handler);
+    return add_handler(std::move(e));
+}
+
+Subscription ShmChannel::add_handler(HandlerEntry entry) {
     std::uint64_t id = 0;
     {
         std::lock_guard<std::mutex> lock(handler_mutex_);
         id = next_handler_id_++;
-        handlers_.push_back(HandlerEntry{.id = id, .owner = owner, .handler = std::move(handler)});
+        entry.id = id;
+        auto next = std::make_shared<std::vector<HandlerEntry>>(*handlers_);
+        next->push_back(std::move(entry));
+        handlers_ = std::move(next);
     }
 
     bool expected = false;
     if (running_.compare_exchange_strong(expected, true)) {
-        worker_ = std::thread([this]() { dispatch_loop(); });
+        if (mode() == Mode::broadcast) {
+            try {
+                register_reader();
+            } catch (...) {
+                running_.store(false);
+                remove_handlers([&](const HandlerEntry& e) { return e.id == id; });
+                throw;
+            }
+        }
+        worker_ = std::thread([this]() {
+            internal::apply_thread_policy("shm_dispatch", 0);
+            dispatch_loop();
+        });
     }
 
-    return Subscription([this, id]() {
-        std::lock_guard<std::mutex> lock(handler_mutex_);
-        handlers_.erase(std::remove_if(handlers_.begin(), handlers_.end(), [&](const HandlerEntry& e) {
-                           return e.id == id;
-                       }),
-                       handlers_.end());
-    });
+    return Subscription([this, id]() { remove_handlers([&](const HandlerEntry& e) { return e.id == id; }); });
+}
+
+void ShmChannel::remove_handlers(const std::function<bool(const HandlerEntry&)>& pred) {
+    std::lock_guard<std::mutex> lock(handler_mutex_);
+    auto next = std::make_shared<std::vector<HandlerEntry>>();
+    next->reserve(handlers_->size());
+    for (const auto& e : *handlers_) {
+        if (!pred(e)) next->push_back(e);
+    }
+    handlers_ = std::move(next);
 }
 
 void ShmChannel::unsubscribe_owner(void* owner) {
     if (!owner) return;
-    std::lock_guard<std::mutex> lock(handler_mutex_);
-    handlers_.erase(std::remove_if(handlers_.begin(), handlers_.end(), [&](const HandlerEntry& e) {
-                       return e.owner == owner;
-                   }),
-                   handlers_.end());
+    remove_handlers([&](const HandlerEntry& e) { return e.owner == owner; });
 }
 
 void ShmChannel::stop() {
     const bool was_running = running_.exchange(false);
     if (was_running) {
-        if (sem_) {
-            ::sem_post(sem_); // wake
+        // wake
+        if (notify_mode() == Notify::futex) {
+            (void)futex_wake_all(&hdr_->notify_seq);
+        } else if (reader_) {
+            ::sem_post(&reader_->sem);
+        } else if (sem_) {
+            ::sem_post(sem_);
         }
         if (worker_.joinable()) worker_.join();
+        unregister_reader();
     }
     {
         std::lock_guard<std::mutex> lock(handler_mutex_);
-        handlers_.clear();
+        handlers_ = std::make_shared<std::vector<HandlerEntry>>();
     }
 }
 
-void ShmChannel::dispatch_loop() {
-    while (running_.load(std::memory_order_relaxed)) {
-        // 等待消息
+bool ShmChannel::has_pending() const {
+    const std::uint64_t head = hdr_->head.load(std::memory_order_acquire);
+    if (mode() == Mode::broadcast) {
+        if (cursor_ >= head) return false;
+        // 已被覆盖（由 dispatch 负责跳读）也视为有事可做。
+        if (head - cursor_ > hdr_->ring_bytes) return true;
+        return record(cursor_)->seq.load(std::memory_order_acquire) == 2 * cursor_ + 1;
+    }
+    const std::uint64_t pos = hdr_->tail.load(std::memory_order_relaxed);
+    if (pos >= head) return false;
+    return record(pos)->seq.load(std::memory_order_acquire) == 2 * pos + 1;
+}
+
+bool ShmChannel::wait_signal() {
+    if (notify_mode() == Notify::semaphore) {
         struct timespec ts;
         clock_gettime(CLOCK_REALTIME, &ts);
         ts.tv_nsec += 50 * 1000 * 1000; // 50ms
         if (ts.tv_nsec >= 1000000000L) { ts.tv_sec += 1; ts.tv_nsec -= 1000000000L; }
-        int r = ::sem_timedwait(sem_, &ts);
-        if (r != 0) {
+        sem_t* s = reader_ ? &reader_->sem : sem_;
+        return ::sem_timedwait(s, &ts) == 0;
+    }
+
+    // 先自旋：突发流量下避免 park/wake 两次系统调用。
+    for (std::uint32_t i = 0; i < spin_limit_; ++i) {
+        if (has_pending()) {
+            spin_limit_ = spin_max_;
+            return true;
+        }
+        cpu_relax();
+    }
+    if (has_pending()) return true;
+    spin_limit_ = std::max(spin_limit_ / 2, spin_max_ / 8);
+
+    // park：waiters 让写端知道需要 FUTEX_WAKE；读端进程崩溃残留的计数只会让写端多发 wake，不影响正确性。
+    hdr_->waiters.fetch_add(1, std::memory_order_seq_cst);
+    const std::uint32_t seq = hdr_->notify_seq.load(std::memory_order_seq_cst);
+    bool ready = has_pending();
+    if (!ready && running_.load(std::memory_order_relaxed)) {
+        // 相对超时：兜底周期性检查 running_，无需每轮构造 CLOCK_REALTIME deadline。
+        struct timespec ts {0, 50 * 1000 * 1000}; // 50ms
+        (void)futex_wait(&hdr_->notify_seq, seq, &ts);
+        ready = has_pending();
+    }
+    hdr_->waiters.fetch_sub(1, std::memory_order_seq_cst);
+    return ready;
+}
+
+void ShmChannel::deliver_batch() {
+    if (batch_.empty()) return;
+    // 每批只取一次 handler 快照（copy-on-write 表，引用计数 +1），不再逐条拷贝 std::function。
+    std::shared_ptr<const std::vector<HandlerEntry>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(handler_mutex_);
+        snapshot = handlers_;
+    }
+    for (const auto& e : *snapshot) {
+        if (e.handler) {
+            for (const auto& m : batch_) e.handler(m.data, m.size);
+        }
+        if (e.batch_handler) {
+            e.batch_handler(batch_.data(), batch_.size());
+        }
+    }
+    messages_delivered_.add(batch_.size());
+    if (wxz::core::has_metrics_sink()) {
+        wxz::core::metrics().histogram_observe("wxz.shm.recv.batch", static_cast<double>(batch_.size()), {});
+    }
+}
+
+void ShmChannel::dispatch_queue() {
+    std::uint64_t pos = hdr_->tail.load(std::memory_order_acquire);
+    std::uint64_t end = pos;
+    for (;;) {
+        // 收集从 pos 起连续已提交的记录（含 padding），一次认领整段。
+        const std::uint64_t head = hdr_->head.load(std::memory_order_acquire);
+        positions_.clear();
+        end = pos;
+        while (positions_.size() < max_batch_ && end < head) {
+            auto* r = record(end);
+            if (r->seq.load(std::memory_order_acquire) != 2 * end + 1) break;
+            positions_.push_back(end);
+            end += r->bytes;
+        }
+        if (positions_.empty()) {
+            const std::uint64_t cur = hdr_->tail.load(std::memory_order_acquire);
+            if (cur == pos) return; // 无消息
+            pos = cur;              // tail 已被其他读端推进
             continue;
         }
-        std::uint32_t tail = hdr_->tail.load(std::memory_order_acquire);
-        std::uint32_t head = hdr_->head.load(std::memory_order_acquire);
-        std::uint32_t cap = hdr_->capacity;
-        if (tail == head) {
-            continue; // 无消息
-        }
-        std::uint32_t idx = tail & (cap - 1);
-        auto sv = slot(idx);
-        std::uint32_t sz = 0;
-        std::memcpy(&sz, sv.ptr, sizeof(std::uint32_t));
-        const std::uint8_t* payload = sv.ptr + sizeof(std::uint32_t);
-        std::vector<Handler> copy_handlers;
-        {
-            std::lock_guard<std::mutex> lock(handler_mutex_);
-            copy_handlers.reserve(handlers_.size());
-            for (const auto& e : handlers_) copy_handlers.push_back(e.handler);
-        }
-        for (auto& h : copy_handlers) {
-            if (h) h(payload, sz);
-        }
-        messages_delivered_.fetch_add(1, std::memory_order_relaxed);
-        hdr_->tail.store(tail + 1, std::memory_order_release);
+        // 多个附加进程共享 tail：CAS 认领，保证每条消息只被一个读端消费。
+        // CAS 成功说明这段记录未被他人认领，也就不可能被写端复用，上面读到的 bytes 有效。
+        if (hdr_->tail.compare_exchange_weak(pos, end, std::memory_order_acq_rel)) break;
+    }
+
+    // handler 直接读环内存；回调结束后才标记为已消费，并推进 reclaim 把空间交还给写端。
+    batch_.clear();
+    for (const auto p : positions_) {
+        auto* r = record(p);
+        if (r->len == kPadLen) continue;
+        batch_.push_back(Message{reinterpret_cast<const std::uint8_t*>(r) + sizeof(RecordHeader), r->len});
+    }
+    deliver_batch();
+    for (const auto p : positions_) {
+        record(p)->seq.store(2 * p + 2, std::memory_order_seq_cst);
+    }
+    reclaim_consumed();
+}
+
+void ShmChannel::dispatch_broadcast() {
+    const std::uint64_t ring = hdr_->ring_bytes;
+    auto lap = [&](std::uint64_t skipped) {
+        messages_lapped_.fetch_add(skipped, std::memory_order_relaxed);
+        reader_->lapped.fetch_add(skipped, std::memory_order_relaxed);
+        if (wxz::core::has_metrics_sink()) {
+            wxz::core::metrics().counter_add("wxz.shm.recv.lapped", static_cast<double>(skipped), {});
+        }
+        const auto n = messages_lapped_.load(std::memory_order_relaxed);
+        if (n == skipped || (n / 1024) != ((n - skipped) / 1024)) {
+            wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                                 "shm broadcast reader lapped by writer",
+                                                 {{"name", name_}, {"lapped_total", std::to_string(n)}});
+        }
+    };
+    // 被覆盖后跳到最新一条已提交消息；若它也已被覆盖（或尚无提交），直接跳到 head 等待新消息。
+    auto resync = [&](std::uint64_t head) {
+        const std::uint64_t latest = hdr_->tail.load(std::memory_order_acquire);
+        cursor_ = (latest > cursor_ && head - latest <= ring) ? latest : head;
+        lap(1);
+    };
+
+    batch_.clear();
+    positions_.clear();
+    const std::uint64_t head = hdr_->head.load(std::memory_order_acquire);
+    if (head - cursor_ > ring) {
+        resync(head);
+        reader_->cursor.store(cursor_, std::memory_order_relaxed);
+        return;
+    }
+
+    bool torn_header = false;
+    std::size_t copy_bytes = 0;
+    std::uint64_t c = cursor_;
+    while (batch_.size() < max_batch_ && c < head) {
+        auto* r = record(c);
+        if (r->seq.load(std::memory_order_acquire) != 2 * c + 1) break; // 尚未提交（或已被覆盖，由下面的 head 校验兜底）
+        const std::uint32_t bytes = r->bytes;
+        const std::uint32_t len = r->len;
+        // 记录头可能与并发覆盖交错：先做结构校验，保证游标始终落在对齐位置、读取不越界。
+        if (bytes < kRecordAlign || bytes % kRecordAlign != 0 || c % ring + bytes > ring) {
+            torn_header = true;
+            break;
+        }
+        if (len != kPadLen) {
+            const std::size_t size = std::min<std::size_t>(len, bytes - sizeof(RecordHeader));
+            batch_.push_back(Message{nullptr, size});
+            positions_.push_back(c);
+            copy_bytes += size;
+        }
+        c += bytes;
+    }
+
+    if (!batch_.empty()) {
+        // 写端从不等待读端，记录随时可能被覆盖：先拷贝到本地缓冲，再做 seqlock 式二次校验，只交付完好的副本。
+        // 写端先推进 head（并把 seq 置为未提交）再写环内存；拷贝之后 head 未越过 pos + ring 且 seq 未变即说明副本完好。
+        if (copy_buf_.size() < copy_bytes) copy_buf_.resize(copy_bytes);
+        std::size_t off = 0;
+        for (std::size_t i = 0; i < batch_.size(); ++i) {
+            std::memcpy(copy_buf_.data() + off,
+                        reinterpret_cast<const std::uint8_t*>(record(positions_[i])) + sizeof(RecordHeader),
+                        batch_[i].size);
+            off += batch_[i].size;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t head_after = hdr_->head.load(std::memory_order_relaxed);
+        std::size_t kept = 0;
+        off = 0;
+        for (std::size_t i = 0; i < batch_.size(); ++i) {
+            const std::uint64_t p = positions_[i];
+            const std::size_t size = batch_[i].size;
+            if (head_after - p <= ring && record(p)->seq.load(std::memory_order_relaxed) == 2 * p + 1) {
+                batch_[kept++] = Message{copy_buf_.data() + off, size};
+            }
+            off += size;
+        }
+        const std::size_t torn = batch_.size() - kept;
+        batch_.resize(kept);
+        if (torn != 0) lap(torn);
+        deliver_batch();
+    } else if (torn_header && c == cursor_) {
+        resync(hdr_->head.load(std::memory_order_acquire));
+        reader_->cursor.store(cursor_, std::memory_order_relaxed);
+        return;
+    }
+    cursor_ = c;
+    reader_->cursor.store(cursor_, std::memory_order_relaxed);
+}
+
+void ShmChannel::dispatch_loop() {
+    while (running_.load(std::memory_order_relaxed)) {
+        // 等待消息
+        if (!wait_signal()) {
+            continue;
+        }
+        if (!running_.load(std::memory_order_relaxed)) break;
+        if (mode() == Mode::broadcast) {
+            dispatch_broadcast();
+        } else {
+            dispatch_queue();
+        }
     }
 }
 
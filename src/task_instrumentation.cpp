@@ -0,0 +1,64 @@
+#include "task_instrumentation.h"
+
+#include "observability.h"
+
+#include <string>
+#include <utility>
+
+namespace wxz::core {
+
+namespace {
+
+struct ScopeNames {
+    const char* label;
+    const char* queue_wait;
+    const char* run;
+    const char* long_task;
+};
+
+const ScopeNames& scope_names(TaskScope scope) {
+    static const ScopeNames kExecutor{"executor", "wxz.executor.queue_wait_us", "wxz.executor.run_us", "wxz.executor.long_task"};
+    static const ScopeNames kStrand{"strand", "wxz.strand.queue_wait_us", "wxz.strand.run_us", "wxz.strand.long_task"};
+    return scope == TaskScope::strand ? kStrand : kExecutor;
+}
+
+} // namespace
+
+MoveOnlyFunction instrument_task(MoveOnlyFunction&& task,
+                                 TaskScope scope,
+                                 const std::string& name,
+                                 const char* tag,
+                                 std::chrono::microseconds long_task,
+                                 const char* lane) {
+    if (!wxz::core::has_metrics_sink() && !wxz::core::has_trace_hook()) return std::move(task);
+    const auto enqueued = std::chrono::steady_clock::now();
+    const std::string* n = &name;
+    return MoveOnlyFunction([inner = std::move(task), enqueued, scope, n, tag, long_task, lane]() mutable {
+        using Micros = std::chrono::duration<double, std::micro>;
+        const auto start = std::chrono::steady_clock::now();
+        inner();
+        const auto end = std::chrono::steady_clock::now();
+
+        const ScopeNames& names = scope_names(scope);
+        const double wait_us = Micros(start - enqueued).count();
+        const double run_us = Micros(end - start).count();
+        const std::string_view t = (tag && *tag) ? std::string_view(tag) : std::string_view("-");
+        if (wxz::core::has_metrics_sink()) {
+            auto& m = wxz::core::metrics();
+            m.histogram_observe(names.queue_wait, wait_us, {{names.label, *n}});
+            m.histogram_observe(names.run, run_us, {{names.label, *n}});
+            if (lane) m.histogram_observe("wxz.executor.lane.queue_wait_us", wait_us, {{"lane", lane}});
+        }
+        if (long_task.count() > 0 && end - start > long_task) {
+            if (wxz::core::has_metrics_sink()) {
+                wxz::core::metrics().counter_add(names.long_task, 1, {{names.label, *n}, {"tag", t}});
+            }
+            if (wxz::core::has_trace_hook()) {
+                const std::string run_s = std::to_string(static_cast<long long>(run_us));
+                wxz::core::trace().event(names.long_task, {{names.label, *n}, {"tag", t}, {"run_us", run_s}});
+            }
+        }
+    });
+}
+
+} // namespace wxz::core
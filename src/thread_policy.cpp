@@ -0,0 +1,190 @@
+#include "internal/thread_policy.h"
+
+#include "internal/config.h"
+#include "logger.h"
+#include "observability.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace wxz::core::internal {
+
+namespace {
+
+// <linux/mempolicy.h> 的 MPOL_BIND；直接走 syscall，不引入 libnuma 依赖。
+constexpr int kMpolBind = 2;
+
+void report_error(const std::string& pool, const char* what, int err) {
+    wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                         "thread policy: pool=" + pool + " " + what + " failed: " + std::strerror(err));
+    if (wxz::core::has_metrics_sink()) {
+        wxz::core::metrics().counter_add("wxz.thread.policy.error", 1, {{"pool", pool}, {"what", what}});
+    }
+}
+
+std::vector<int> numa_node_cpus(int node) {
+    std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string line;
+    if (!in || !std::getline(in, line)) return {};
+    return parse_cpu_list(line);
+}
+
+std::string format_cpu_list(const cpu_set_t& set) {
+    std::string out;
+    for (int c = 0; c < CPU_SETSIZE; ++c) {
+        if (!CPU_ISSET(c, &set)) continue;
+        int hi = c;
+        while (hi + 1 < CPU_SETSIZE && CPU_ISSET(hi + 1, &set)) ++hi;
+        if (!out.empty()) out.push_back(',');
+        out += std::to_string(c);
+        if (hi > c) out += "-" + std::to_string(hi);
+        c = hi;
+    }
+    return out;
+}
+
+const char* sched_name(int policy) {
+    switch (policy) {
+    case SCHED_FIFO:
+        return "fifo";
+    case SCHED_RR:
+        return "rr";
+    default:
+        return "other";
+    }
+}
+
+void report_placement(const std::string& pool, const std::string& thread_name, int numa_node) {
+    if (!wxz::core::has_metrics_sink()) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::string cpus;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) cpus = format_cpu_list(set);
+    int policy = SCHED_OTHER;
+    struct sched_param sp {};
+    (void)pthread_getschedparam(pthread_self(), &policy, &sp);
+    const auto tid = static_cast<id_t>(::syscall(SYS_gettid));
+    const int prio = (policy == SCHED_FIFO || policy == SCHED_RR) ? sp.sched_priority : getpriority(PRIO_PROCESS, tid);
+    const std::string prio_s = std::to_string(prio);
+    // 线程名截断到 15 字节后可能重名（同一 pool 多次创建线程组、或长 pool 名只差在尾部），
+    // tid 保证每个线程一条时间序列，不会互相覆盖。
+    const std::string tid_s = std::to_string(tid);
+    const std::string numa_s = std::to_string(numa_node);
+    wxz::core::metrics().gauge_set("wxz.thread.placement",
+                                   1,
+                                   {
+                                       {"pool", pool},
+                                       {"thread", thread_name},
+                                       {"tid", tid_s},
+                                       {"cpus", cpus},
+                                       {"sched", sched_name(policy)},
+                                       {"priority", prio_s},
+                                       {"numa_node", numa_s},
+                                   });
+}
+
+} // namespace
+
+std::vector<int> parse_cpu_list(const std::string& s) {
+    std::vector<int> out;
+    std::stringstream ss(s);
+    std::string part;
+    while (std::getline(ss, part, ',')) {
+        part.erase(std::remove_if(part.begin(), part.end(), [](unsigned char c) { return std::isspace(c); }), part.end());
+        if (part.empty()) continue;
+        try {
+            const auto dash = part.find('-');
+            // 超出 cpu_set_t 的编号无法绑定；拒绝整个片段，也避免 "0-2000000000" 这类输入展开出巨大的列表。
+            const auto valid = [](int c) { return c >= 0 && c < CPU_SETSIZE; };
+            if (dash == std::string::npos) {
+                const int c = std::stoi(part);
+                if (valid(c)) out.push_back(c);
+            } else {
+                const int lo = std::stoi(part.substr(0, dash));
+                const int hi = std::stoi(part.substr(dash + 1));
+                if (!valid(lo) || !valid(hi)) continue;
+                for (int c = lo; c <= hi; ++c) out.push_back(c);
+            }
+        } catch (...) {}
+    }
+    return out;
+}
+
+ThreadPolicy thread_policy_for(const std::string& pool) {
+    ThreadPolicy p;
+    const ThreadPolicyConfig* c = Config::getInstance().getThreadPolicy(pool);
+    if (!c) return p;
+    p.cpus = c->cpus;
+    p.numa_node = c->numa_node;
+    p.priority = c->priority;
+    p.name = c->name;
+    if (c->sched == "fifo") {
+        p.sched = SchedPolicy::fifo;
+    } else if (c->sched == "rr") {
+        p.sched = SchedPolicy::rr;
+    } else if (!c->sched.empty() && c->sched != "other") {
+        wxz::core::Logger::getInstance().log(wxz::core::LogLevel::Warn,
+                                             "thread policy: pool=" + pool + " unknown sched '" + c->sched + "', using other");
+    }
+    return p;
+}
+
+void apply_thread_policy(const std::string& pool, const ThreadPolicy& policy, std::size_t index) {
+    // 内核线程名上限 16 字节（含结尾 0）：截断前缀，保留 "/<index>"。
+    const std::string suffix = "/" + std::to_string(index);
+    std::string name = policy.name.empty() ? pool : policy.name;
+    if (name.size() + suffix.size() > 15) name.resize(suffix.size() < 15 ? 15 - suffix.size() : 0);
+    name += suffix;
+    (void)pthread_setname_np(pthread_self(), name.c_str());
+
+    std::vector<int> cpus = policy.cpus;
+    if (cpus.empty() && policy.numa_node >= 0) cpus = numa_node_cpus(policy.numa_node);
+    if (!cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int c : cpus) {
+            if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+        }
+        const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (rc != 0) report_error(pool, "affinity", rc);
+    }
+
+    if (policy.numa_node >= 0) {
+        const int bits = static_cast<int>(sizeof(unsigned long) * 8);
+        if (policy.numa_node >= bits) {
+            report_error(pool, "numa", EINVAL);
+        } else {
+            const unsigned long mask = 1UL << policy.numa_node;
+            if (::syscall(SYS_set_mempolicy, kMpolBind, &mask, static_cast<unsigned long>(bits)) != 0) {
+                report_error(pool, "numa", errno);
+            }
+        }
+    }
+
+    if (policy.sched == SchedPolicy::fifo || policy.sched == SchedPolicy::rr) {
+        const int native = policy.sched == SchedPolicy::fifo ? SCHED_FIFO : SCHED_RR;
+        struct sched_param sp {};
+        sp.sched_priority = std::clamp(policy.priority, sched_get_priority_min(native), sched_get_priority_max(native));
+        const int rc = pthread_setschedparam(pthread_self(), native, &sp);
+        if (rc != 0) report_error(pool, "sched", rc);
+    } else if (policy.priority != 0) {
+        // Linux 上 nice 值按线程（tid）生效。
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), policy.priority) != 0) {
+            report_error(pool, "nice", errno);
+        }
+    }
+
+    report_placement(pool, name, policy.numa_node);
+}
+
+} // namespace wxz::core::internal
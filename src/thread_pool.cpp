@@ -1,4 +1,5 @@
 #include "internal/thread_pool.h"
+#include "internal/thread_policy.h"
 
 #include <algorithm>
 #include <utility>
@@ -40,7 +41,10 @@ bool ThreadPool::start() {
     workers_.clear();
     workers_.reserve(threads);
     for (size_t i = 0; i < threads; ++i) {
-        workers_.emplace_back([this, i]() { workerLoop(static_cast<int>(i)); });
+        workers_.emplace_back([this, i]() {
+            wxz::core::internal::apply_thread_policy(module_key_, i);
+            workerLoop(static_cast<int>(i));
+        });
     }
 
     running_.store(true);
@@ -1,4 +1,5 @@
 #include "internal/wxz_worker_group.h"
+#include "internal/thread_policy.h"
 
 namespace wxz {
 
@@ -16,7 +17,8 @@ bool WorkerGroup::start(size_t n, std::function<void(std::atomic<bool>&, int)> f
 
     for (size_t i = 0; i < n; ++i) {
         // 捕获停止标志和函数的副本并在独立线程中执行
-        threads_.emplace_back([stop_flag = stop_flag_, fn, i]() {
+        threads_.emplace_back([stop_flag = stop_flag_, fn, i, name = name_]() {
+            wxz::core::internal::apply_thread_policy(name, i);
             try {
                 fn(*stop_flag, static_cast<int>(i));
             } catch (...) {
@@ -0,0 +1,109 @@
+// BufferPool 空闲链表（带版本号的 Treiber 栈）并发压测：
+// 多线程反复 acquire/release，校验任一时刻每个 buffer 只有一个持有者，且结束后所有 buffer 都回到空闲链表。
+
+#include "inproc_channel.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using wxz::core::BufferHandle;
+using wxz::core::BufferPool;
+
+namespace {
+
+constexpr std::size_t kCapacity = 16; // 小于线程数 × 每线程持有数：制造空池与频繁复用
+constexpr std::size_t kBufferBytes = 64;
+constexpr std::size_t kThreads = 8;
+constexpr std::size_t kIterations = 200000;
+
+void stress_exclusive_ownership() {
+    BufferPool pool(kCapacity, kBufferBytes);
+    std::unordered_map<const std::uint8_t*, std::size_t> index_of;
+    for (std::size_t i = 0; i < kCapacity; ++i) index_of.emplace(pool.data(i), i);
+    // 0 表示空闲；否则为持有者线程编号 + 1。
+    std::unique_ptr<std::atomic<std::uint32_t>[]> owner(new std::atomic<std::uint32_t>[kCapacity]);
+    for (std::size_t i = 0; i < kCapacity; ++i) owner[i].store(0);
+
+    std::atomic<bool> go{false};
+    std::atomic<std::uint64_t> acquired{0};
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            const auto self = static_cast<std::uint32_t>(t + 1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            std::vector<BufferHandle> held;
+            for (std::size_t i = 0; i < kIterations; ++i) {
+                BufferHandle h = pool.acquire();
+                if (h.valid()) {
+                    auto it = index_of.find(h.data());
+                    WXZ_CHECK(it != index_of.end());
+                    std::uint32_t expected = 0;
+                    // 拿到已被他人持有的 buffer 即为 ABA 复现。
+                    WXZ_CHECK(owner[it->second].compare_exchange_strong(expected, self));
+                    std::memset(h.data(), static_cast<int>(self), kBufferBytes);
+                    held.push_back(std::move(h));
+                    acquired.fetch_add(1, std::memory_order_relaxed);
+                }
+                // 每个线程最多同时持有 2 个，按不同顺序归还，让链表头在各线程间反复易手。
+                if (held.size() > 2 || (!held.empty() && (i % 3) == 0)) {
+                    const std::size_t k = (i / 3) % held.size();
+                    const std::uint8_t* data = held[k].data();
+                    for (std::size_t b = 0; b < kBufferBytes; ++b) WXZ_CHECK(data[b] == self);
+                    const std::size_t idx = index_of.at(data);
+                    std::uint32_t expected = self;
+                    WXZ_CHECK(owner[idx].compare_exchange_strong(expected, 0));
+                    held.erase(held.begin() + static_cast<std::ptrdiff_t>(k)); // 析构即 release
+                }
+            }
+            for (auto& h : held) {
+                std::uint32_t expected = self;
+                WXZ_CHECK(owner[index_of.at(h.data())].compare_exchange_strong(expected, 0));
+            }
+        });
+    }
+    go.store(true, std::memory_order_release);
+    for (auto& th : threads) th.join();
+    WXZ_CHECK(acquired.load() > kIterations); // 确实发生了大量并发获取
+
+    // 全部归还后：恰好能取出 capacity 个互不相同的 buffer，之后池为空。
+    std::vector<BufferHandle> all;
+    for (std::size_t i = 0; i < kCapacity; ++i) {
+        all.push_back(pool.acquire());
+        WXZ_CHECK(all.back().valid());
+    }
+    WXZ_CHECK(!pool.acquire().valid());
+    for (std::size_t i = 0; i < kCapacity; ++i) {
+        for (std::size_t j = i + 1; j < kCapacity; ++j) WXZ_CHECK(all[i].data() != all[j].data());
+    }
+}
+
+void retain_release_returns_once() {
+    BufferPool pool(2, kBufferBytes);
+    BufferHandle h = pool.acquire();
+    WXZ_CHECK(h.valid());
+    const std::uint8_t* data = h.data();
+    const std::size_t idx = pool.data(0) == data ? 0 : 1;
+    pool.retain(idx, 2); // 共 3 个引用
+    pool.release(idx);
+    pool.release(idx);
+    // 仍被 h 持有：池里只剩另一个 buffer。
+    BufferHandle other = pool.acquire();
+    WXZ_CHECK(other.valid() && other.data() != data);
+    WXZ_CHECK(!pool.acquire().valid());
+    h = BufferHandle(); // 最后一个引用归还
+    BufferHandle again = pool.acquire();
+    WXZ_CHECK(again.valid() && again.data() == data);
+}
+
+} // namespace
+
+int main() {
+    retain_release_returns_once();
+    stress_exclusive_ownership();
+    return 0;
+}
@@ -0,0 +1,67 @@
+// ChannelQoS::apply_realtime_preset：只覆盖实时相关字段，其余配置（key、过滤、接收线程等）保持不变。
+
+#include "inproc_channel.h"
+#include "test_util.h"
+
+using wxz::core::ChannelQoS;
+
+namespace {
+
+void overlay_keeps_other_fields() {
+    ChannelQoS q;
+    q.reliability = ChannelQoS::Reliability::best_effort;
+    q.history = 4;
+    q.durability = ChannelQoS::Durability::transient_local;
+    q.async_publish = true;
+    q.lifespan_ns = 5'000'000;
+    q.key_offset = 4;
+    q.key_size = 8;
+    q.max_instances = 32;
+    q.filter_expression = "key = %0";
+    q.filter_parameters = {"'robot_01'"};
+    q.recv_batch = 16;
+    q.recv_threads = 2;
+    q.recv_group = "ctrl";
+    q.recv_cpus = {2, 3};
+    q.data_sharing = true;
+    q.deadline_ns = 5'000'000;
+
+    q.apply_realtime_preset(q.history);
+
+    const ChannelQoS p = ChannelQoS::realtime_preset(4);
+    WXZ_CHECK(q.reliability == p.reliability);
+    WXZ_CHECK(q.history == 4);
+    WXZ_CHECK(q.durability == p.durability);
+    WXZ_CHECK(q.liveliness == p.liveliness);
+    WXZ_CHECK(q.async_publish == p.async_publish);
+    WXZ_CHECK(q.realtime_hint);
+    WXZ_CHECK(q.transport_priority == p.transport_priority);
+    // 已配置的 deadline 保留，未配置的 latency_budget 取预设值。
+    WXZ_CHECK(q.deadline_ns == 5'000'000);
+    WXZ_CHECK(q.latency_budget_ns == p.latency_budget_ns);
+
+    WXZ_CHECK(q.lifespan_ns == 5'000'000);
+    WXZ_CHECK(q.key_offset == 4 && q.key_size == 8 && q.max_instances == 32);
+    WXZ_CHECK(q.filter_expression == "key = %0");
+    WXZ_CHECK(q.filter_parameters.size() == 1 && q.filter_parameters[0] == "'robot_01'");
+    WXZ_CHECK(q.recv_batch == 16 && q.recv_threads == 2 && q.recv_group == "ctrl");
+    WXZ_CHECK(q.recv_cpus.size() == 2 && q.recv_cpus[0] == 2 && q.recv_cpus[1] == 3);
+    WXZ_CHECK(q.data_sharing);
+}
+
+void overlay_fills_unset_timing() {
+    ChannelQoS q;
+    q.apply_realtime_preset();
+    const ChannelQoS p = ChannelQoS::realtime_preset();
+    WXZ_CHECK(q.history == p.history);
+    WXZ_CHECK(q.deadline_ns == p.deadline_ns);
+    WXZ_CHECK(q.latency_budget_ns == p.latency_budget_ns);
+}
+
+} // namespace
+
+int main() {
+    overlay_keeps_other_fields();
+    overlay_fills_unset_timing();
+    return 0;
+}
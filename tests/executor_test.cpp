@@ -0,0 +1,270 @@
+// Executor 优先级 lane（两种 backend）：
+// - 严格优先级 realtime > normal > background，realtime lane 内按 deadline 最早优先（EDF，同 deadline 按入队顺序）；
+// - realtime/background 的独立上限：满时立即拒绝，不影响 normal；
+// - lane 排队等待直方图只由被采样的任务上报（sample_every=0 时不上报），三个 lane 都覆盖。
+// work_stealing backend：
+// - 工作线程内 post 的任务进入本地队列，本线程阻塞时由其它工作线程窃取执行；
+// - 自我重投的任务不会饿死同一本地队列里的其它任务，也不会饿死外部线程投递（注入队列）的任务；
+// - block_when_full：每空出一个名额就放行一个阻塞的 post。
+
+#include "executor.h"
+#include "observability.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using wxz::core::Executor;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 记录 histogram_observe 的调用次数（按 name + 全部标签值）。
+class RecordingSink final : public wxz::core::MetricsSink {
+public:
+    void counter_add(std::string_view, double, std::initializer_list<wxz::core::LabelView>) noexcept override {}
+    void gauge_set(std::string_view, double, std::initializer_list<wxz::core::LabelView>) noexcept override {}
+    void histogram_observe(std::string_view name,
+                           double,
+                           std::initializer_list<wxz::core::LabelView> labels) noexcept override {
+        std::string key(name);
+        for (const auto& l : labels) {
+            key += '|';
+            key += l.value;
+        }
+        std::lock_guard<std::mutex> lock(mu_);
+        ++observed_[key];
+    }
+
+    int count(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mu_);
+        const auto it = observed_.find(key);
+        return it == observed_.end() ? 0 : it->second;
+    }
+
+private:
+    std::mutex mu_;
+    std::map<std::string, int> observed_;
+};
+
+Executor::Options spin_options(Executor::Backend backend) {
+    Executor::Options o;
+    o.threads = 0; // 由测试线程 spin_once 驱动，执行顺序确定
+    o.backend = backend;
+    return o;
+}
+
+void drain(Executor& ex) {
+    while (ex.spin_once(std::chrono::milliseconds(0))) {
+    }
+}
+
+void strict_priority_and_edf(Executor::Backend backend) {
+    Executor ex(spin_options(backend));
+    WXZ_CHECK(ex.start());
+    std::vector<std::string> order;
+    const auto base = Clock::now() + std::chrono::seconds(10);
+
+    WXZ_CHECK(ex.post(Executor::Lane::background, [&] { order.push_back("bg1"); }));
+    WXZ_CHECK(ex.post([&] { order.push_back("n1"); }));
+    WXZ_CHECK(ex.post_before(base + std::chrono::milliseconds(30), [&] { order.push_back("rt30"); }));
+    WXZ_CHECK(ex.post_before(base + std::chrono::milliseconds(10), [&] { order.push_back("rt10a"); }));
+    WXZ_CHECK(ex.post_before(base + std::chrono::milliseconds(20), [&] { order.push_back("rt20"); }));
+    WXZ_CHECK(ex.post_before(base + std::chrono::milliseconds(10), [&] { order.push_back("rt10b"); }));
+    // 以入队时刻为 deadline：早于上面所有显式 deadline。
+    WXZ_CHECK(ex.post(Executor::Lane::realtime, [&] { order.push_back("rt_now"); }));
+    WXZ_CHECK(ex.post([&] { order.push_back("n2"); }));
+    WXZ_CHECK(ex.post(Executor::Lane::background, [&] { order.push_back("bg2"); }));
+    drain(ex);
+
+    const std::vector<std::string> expected{"rt_now", "rt10a", "rt10b", "rt20", "rt30", "n1", "n2", "bg1", "bg2"};
+    WXZ_CHECK(order == expected);
+    ex.stop();
+}
+
+void lane_limits(Executor::Backend backend) {
+    Executor::Options o = spin_options(backend);
+    o.realtime_max_queue = 2;
+    o.background_max_queue = 3;
+    o.max_queue = 4;
+    Executor ex(o);
+    WXZ_CHECK(ex.start());
+    int ran = 0;
+    for (int i = 0; i < 3; ++i) WXZ_CHECK(ex.post(Executor::Lane::background, [&] { ++ran; }));
+    WXZ_CHECK(!ex.post(Executor::Lane::background, [&] { ++ran; }));
+    for (int i = 0; i < 2; ++i) WXZ_CHECK(ex.post(Executor::Lane::realtime, [&] { ++ran; }));
+    WXZ_CHECK(!ex.post(Executor::Lane::realtime, [&] { ++ran; }));
+    // lane 满不影响 normal（其上限是 max_queue）。
+    for (int i = 0; i < 4; ++i) WXZ_CHECK(ex.try_post([&] { ++ran; }));
+    WXZ_CHECK(!ex.try_post([&] { ++ran; }));
+    drain(ex);
+    WXZ_CHECK(ran == 3 + 2 + 4);
+    // 排空后名额恢复。
+    WXZ_CHECK(ex.post(Executor::Lane::background, [&] { ++ran; }));
+    WXZ_CHECK(ex.post(Executor::Lane::realtime, [&] { ++ran; }));
+    drain(ex);
+    WXZ_CHECK(ran == 3 + 2 + 4 + 2);
+    ex.stop();
+}
+
+void lane_wait_histogram_is_sampled(Executor::Backend backend) {
+    RecordingSink sink;
+    wxz::core::set_metrics_sink(&sink);
+    const std::string key = "wxz.executor.lane.queue_wait_us|";
+
+    {
+        // 未开启采样：任何 lane 都不上报排队等待。
+        Executor ex(spin_options(backend));
+        WXZ_CHECK(ex.start());
+        for (int i = 0; i < 8; ++i) {
+            WXZ_CHECK(ex.post(Executor::Lane::realtime, [] {}));
+            WXZ_CHECK(ex.post([] {}));
+            WXZ_CHECK(ex.post(Executor::Lane::background, [] {}));
+        }
+        drain(ex);
+        ex.stop();
+        WXZ_CHECK(sink.count(key + "realtime") == 0);
+        WXZ_CHECK(sink.count(key + "normal") == 0);
+        WXZ_CHECK(sink.count(key + "background") == 0);
+    }
+    {
+        Executor::Options o = spin_options(backend);
+        o.sample_every = 1;
+        Executor ex(o);
+        WXZ_CHECK(ex.start());
+        for (int i = 0; i < 4; ++i) {
+            WXZ_CHECK(ex.post(Executor::Lane::realtime, [] {}));
+            WXZ_CHECK(ex.post([] {}));
+            WXZ_CHECK(ex.post(Executor::Lane::background, [] {}));
+        }
+        drain(ex);
+        ex.stop();
+        WXZ_CHECK(sink.count(key + "realtime") == 4);
+        WXZ_CHECK(sink.count(key + "normal") == 4);
+        WXZ_CHECK(sink.count(key + "background") == 4);
+    }
+    wxz::core::set_metrics_sink(nullptr);
+}
+
+bool wait_for(const std::function<bool()>& done, std::chrono::milliseconds limit = std::chrono::seconds(5)) {
+    const auto deadline = Clock::now() + limit;
+    while (!done()) {
+        if (Clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+Executor::Options stealing_options(std::size_t threads) {
+    Executor::Options o;
+    o.threads = threads;
+    o.backend = Executor::Backend::work_stealing;
+    return o;
+}
+
+void blocked_worker_tasks_are_stolen() {
+    Executor ex(stealing_options(2));
+    WXZ_CHECK(ex.start());
+    constexpr int kChildren = 32;
+    std::atomic<int> children{0};
+    std::atomic<bool> parent_saw_all{false};
+    WXZ_CHECK(ex.post([&] {
+        // 子任务进入本线程的本地队列；本线程一直占着不放，只有窃取才能执行它们。
+        for (int i = 0; i < kChildren; ++i) WXZ_CHECK(ex.post([&] { children.fetch_add(1); }));
+        parent_saw_all.store(wait_for([&] { return children.load() == kChildren; }));
+    }));
+    WXZ_CHECK(wait_for([&] { return parent_saw_all.load(); }));
+    ex.stop();
+}
+
+void self_repost_does_not_starve_others() {
+    Executor ex(stealing_options(1));
+    WXZ_CHECK(ex.start());
+    constexpr int kLocal = 16;
+    constexpr int kRepostLimit = 100000;
+    std::atomic<int> local{0};
+    std::atomic<bool> external{false};
+    std::atomic<int> reposts{0};
+    std::atomic<bool> finished{false};
+    std::function<void()> spinner = [&] {
+        // 类似 Strand 按配额让出：只要还有别的任务没跑就把自己再投一次。
+        if ((local.load() < kLocal || !external.load()) && reposts.fetch_add(1) < kRepostLimit) {
+            WXZ_CHECK(ex.post([&] { spinner(); }));
+            return;
+        }
+        finished.store(true);
+    };
+    WXZ_CHECK(ex.post([&] {
+        for (int i = 0; i < kLocal; ++i) WXZ_CHECK(ex.post([&] { local.fetch_add(1); }));
+        WXZ_CHECK(ex.post([&] { spinner(); }));
+        // 外部线程投递的任务进入注入队列。
+        std::thread([&] { WXZ_CHECK(ex.post([&] { external.store(true); })); }).join();
+    }));
+    WXZ_CHECK(wait_for([&] { return finished.load(); }));
+    WXZ_CHECK(local.load() == kLocal);
+    WXZ_CHECK(external.load());
+    WXZ_CHECK(reposts.load() < 1000);
+    ex.stop();
+}
+
+void blocked_poster_released_per_slot() {
+    Executor::Options o = stealing_options(1);
+    o.max_queue = 64;
+    o.block_when_full = true;
+    Executor ex(o);
+    WXZ_CHECK(ex.start());
+
+    std::atomic<bool> gate0{false};
+    std::atomic<bool> gate1{false};
+    std::atomic<bool> running0{false};
+    std::atomic<bool> running1{false};
+    WXZ_CHECK(ex.post([&] {
+        running0.store(true);
+        while (!gate0.load()) std::this_thread::yield();
+    }));
+    WXZ_CHECK(wait_for([&] { return running0.load(); }));
+    // 工作线程被 gate0 占住：填满 max_queue，第一个任务执行时再占住工作线程。
+    WXZ_CHECK(ex.post([&] {
+        running1.store(true);
+        while (!gate1.load()) std::this_thread::yield();
+    }));
+    for (std::size_t i = 1; i < o.max_queue; ++i) WXZ_CHECK(ex.try_post([] {}));
+    WXZ_CHECK(!ex.try_post([] {}));
+
+    std::atomic<bool> posted{false};
+    std::thread poster([&] {
+        WXZ_CHECK(ex.post([] {}));
+        posted.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    WXZ_CHECK(!posted.load()); // 队列满：阻塞
+
+    // 工作线程只取出一个任务（随即被 gate1 占住）：空出的这一个名额就应放行阻塞的 post。
+    gate0.store(true);
+    WXZ_CHECK(wait_for([&] { return running1.load(); }));
+    WXZ_CHECK(wait_for([&] { return posted.load(); }, std::chrono::seconds(2)));
+    gate1.store(true);
+    poster.join();
+    ex.stop();
+}
+
+} // namespace
+
+int main() {
+    blocked_worker_tasks_are_stolen();
+    self_repost_does_not_starve_others();
+    blocked_poster_released_per_slot();
+    for (const auto backend : {Executor::Backend::mutex_queue, Executor::Backend::work_stealing}) {
+        strict_priority_and_edf(backend);
+        lane_limits(backend);
+        lane_wait_histogram_is_sampled(backend);
+    }
+    return 0;
+}
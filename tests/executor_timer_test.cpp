@@ -0,0 +1,200 @@
+// Executor 延时/周期任务（internal::TimerQueue）：
+// - 触发顺序：deadline 早者优先，同一 deadline 按调度顺序；
+// - 取消：一次性任务触发前取消则不执行，取消返回后周期任务不再开始执行（包括已入队尚未执行的那一次）；
+// - 固定速率：回调耗时不累积漂移；执行器未运行期间到期的周期任务在 start() 后只触发一次并追赶到下一个周期点，不补发；
+// - 防重叠：上一次尚未执行完时跳过本次触发并计入 wxz.executor.timer.overrun。
+
+#include "executor.h"
+#include "observability.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using wxz::core::Executor;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 累计 wxz.executor.timer.overrun。
+class OverrunSink final : public wxz::core::MetricsSink {
+public:
+    void counter_add(std::string_view name, double v, std::initializer_list<wxz::core::LabelView>) noexcept override {
+        if (name == "wxz.executor.timer.overrun") overruns_.fetch_add(static_cast<int>(v));
+    }
+    void gauge_set(std::string_view, double, std::initializer_list<wxz::core::LabelView>) noexcept override {}
+    void histogram_observe(std::string_view, double, std::initializer_list<wxz::core::LabelView>) noexcept override {}
+
+    int overruns() const { return overruns_.load(); }
+
+private:
+    std::atomic<int> overruns_{0};
+};
+
+Executor::Options spin_options() {
+    Executor::Options o;
+    o.threads = 0; // 到期任务进入普通队列，由测试线程 spin_once 执行
+    return o;
+}
+
+// 在测试线程上驱动执行，直到条件满足或超时。
+bool spin_until(Executor& ex, const std::function<bool()>& done, std::chrono::milliseconds limit = std::chrono::seconds(5)) {
+    const auto deadline = Clock::now() + limit;
+    while (!done()) {
+        if (Clock::now() >= deadline) return false;
+        (void)ex.spin_once(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void spin_for(Executor& ex, std::chrono::milliseconds d) {
+    const auto until = Clock::now() + d;
+    while (Clock::now() < until) (void)ex.spin_once(std::chrono::milliseconds(1));
+}
+
+bool wait_for(const std::function<bool()>& done, std::chrono::milliseconds limit = std::chrono::seconds(5)) {
+    const auto deadline = Clock::now() + limit;
+    while (!done()) {
+        if (Clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void fires_in_deadline_order() {
+    Executor ex(spin_options());
+    WXZ_CHECK(ex.start());
+    std::vector<std::string> order;
+    const auto base = Clock::now() + std::chrono::milliseconds(30);
+    WXZ_CHECK(ex.post_at(base + std::chrono::milliseconds(20), [&] { order.push_back("t20"); }));
+    WXZ_CHECK(ex.post_at(base, [&] { order.push_back("t0a"); }));
+    WXZ_CHECK(ex.post_at(base + std::chrono::milliseconds(10), [&] { order.push_back("t10"); }));
+    WXZ_CHECK(ex.post_at(base, [&] { order.push_back("t0b"); }));
+    // 已过期的 deadline 立即触发。
+    WXZ_CHECK(ex.post_at(Clock::now() - std::chrono::seconds(1), [&] { order.push_back("past"); }));
+    WXZ_CHECK(spin_until(ex, [&] { return order.size() == 5; }));
+    WXZ_CHECK(Clock::now() >= base + std::chrono::milliseconds(20));
+    const std::vector<std::string> expected{"past", "t0a", "t0b", "t10", "t20"};
+    WXZ_CHECK(order == expected);
+    ex.stop();
+}
+
+void cancellation() {
+    Executor ex(spin_options());
+    WXZ_CHECK(ex.start());
+
+    WXZ_CHECK(!ex.post_every(std::chrono::milliseconds(0), [] {}));
+    WXZ_CHECK(!ex.cancel(Executor::TimerHandle{}));
+
+    int one_shot = 0;
+    const auto cancelled = ex.post_after(std::chrono::milliseconds(10), [&] { ++one_shot; });
+    const auto kept = ex.post_after(std::chrono::milliseconds(10), [&] { ++one_shot; });
+    WXZ_CHECK(ex.cancel(cancelled));
+    WXZ_CHECK(!ex.cancel(cancelled)); // 幂等
+    WXZ_CHECK(spin_until(ex, [&] { return one_shot == 1; }));
+    spin_for(ex, std::chrono::milliseconds(30));
+    WXZ_CHECK(one_shot == 1);
+    WXZ_CHECK(!ex.cancel(kept)); // 已触发
+
+    int ticks = 0;
+    const auto periodic = ex.post_every(std::chrono::milliseconds(2), [&] { ++ticks; });
+    WXZ_CHECK(spin_until(ex, [&] { return ticks >= 3; }));
+    // 不驱动执行器，让下一次触发进入队列后再取消：排队中的那一次也不应执行。
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    WXZ_CHECK(ex.cancel(periodic));
+    const int at_cancel = ticks;
+    spin_for(ex, std::chrono::milliseconds(30));
+    WXZ_CHECK(ticks == at_cancel);
+    WXZ_CHECK(!ex.cancel(periodic));
+    ex.stop();
+}
+
+void fixed_rate_does_not_drift() {
+    constexpr auto kPeriod = std::chrono::milliseconds(10);
+    constexpr int kFires = 21;
+    Executor ex;
+    WXZ_CHECK(ex.start());
+    std::mutex mu;
+    std::vector<Clock::time_point> fired;
+    const auto h = ex.post_every(kPeriod, [&] {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            fired.push_back(Clock::now());
+        }
+        // 回调耗时占周期的 40%：固定延迟（完成后再等一个周期）会累积到 1.4 倍周期。
+        std::this_thread::sleep_for(kPeriod * 4 / 10);
+    });
+    WXZ_CHECK(wait_for([&] {
+        std::lock_guard<std::mutex> lock(mu);
+        return fired.size() >= static_cast<std::size_t>(kFires);
+    }));
+    WXZ_CHECK(ex.cancel(h));
+    ex.stop();
+
+    const auto span = fired[kFires - 1] - fired[0];
+    const auto nominal = kPeriod * (kFires - 1);
+    WXZ_CHECK(span >= nominal - kPeriod);
+    WXZ_CHECK(span < nominal + nominal / 5);
+}
+
+void catches_up_without_replay() {
+    constexpr auto kPeriod = std::chrono::milliseconds(5);
+    Executor ex;
+    std::atomic<int> ticks{0};
+    std::atomic<int> once{0};
+    // start() 之前调度：执行器未运行期间不触发。
+    const auto h = ex.post_every(kPeriod, [&] { ticks.fetch_add(1); });
+    WXZ_CHECK(ex.post_after(kPeriod, [&] { once.fetch_add(1); }));
+    std::this_thread::sleep_for(kPeriod * 20);
+    WXZ_CHECK(ticks.load() == 0);
+    WXZ_CHECK(once.load() == 0);
+
+    const auto started = Clock::now();
+    WXZ_CHECK(ex.start());
+    WXZ_CHECK(wait_for([&] { return ticks.load() >= 1 && once.load() == 1; }));
+    // 错过的约 20 个周期只补一次：之后按周期触发。
+    std::this_thread::sleep_for(kPeriod * 4);
+    const auto elapsed = Clock::now() - started;
+    WXZ_CHECK(ticks.load() <= 2 + static_cast<int>(elapsed / kPeriod));
+    WXZ_CHECK(ticks.load() < 10);
+    WXZ_CHECK(ex.cancel(h));
+    ex.stop();
+}
+
+void overlapping_fire_is_skipped() {
+    OverrunSink sink;
+    wxz::core::set_metrics_sink(&sink);
+    Executor::Options o;
+    o.threads = 2; // 有空闲线程可执行重叠的触发：只能靠防重叠标记跳过
+    Executor ex(o);
+    WXZ_CHECK(ex.start());
+    std::atomic<int> inside{0};
+    std::atomic<int> runs{0};
+    const auto h = ex.post_every(std::chrono::milliseconds(2), [&] {
+        WXZ_CHECK(inside.fetch_add(1) == 0);
+        if (runs.fetch_add(1) == 0) std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        inside.fetch_sub(1);
+    });
+    WXZ_CHECK(wait_for([&] { return runs.load() >= 5; }));
+    WXZ_CHECK(ex.cancel(h));
+    ex.stop();
+    WXZ_CHECK(sink.overruns() >= 5);
+    wxz::core::set_metrics_sink(nullptr);
+}
+
+} // namespace
+
+int main() {
+    fires_in_deadline_order();
+    cancellation();
+    fixed_rate_does_not_drift();
+    catches_up_without_replay();
+    overlapping_fire_is_skipped();
+    return 0;
+}
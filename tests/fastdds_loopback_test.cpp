@@ -0,0 +1,332 @@
+// FastddsChannel 进程内回环冒烟测试（需要 FastDDS 运行环境；同一进程内的写端/读端 channel 经 DDS 通信）：
+// - loan：loan() 的 buffer 原样到达读端，publish_loaned 计数；未发布的 loan 归还；仅订阅的 channel 拿不到 loan；
+// - 批量 take（recv_batch）：按发布顺序完整交付；投递到 Executor 的 handler 共享接收侧 payload 池，预热后不再分配；
+// - 接收线程组：同名 recv_group 的 channel 由同一个库自建线程派发（不在 FastDDS 线程，也不在调用线程）；
+// - keyed 内容过滤：只交付 key 匹配的样本；set_filter_parameters 运行时替换参数；
+// - 流控写端：按 flow_bytes_per_period/flow_period_ms 限速发送，样本不丢。
+//
+// payload 布局：[0,4) kind（0 为探测样本）+ [4,12) key + [12,16) seq + 填充。
+
+#include "executor.h"
+#include "fastdds_channel.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using wxz::core::ChannelQoS;
+using wxz::core::Executor;
+using wxz::core::FastddsChannel;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kDomain = 77;
+constexpr std::size_t kMaxPayload = 4096;
+constexpr std::uint32_t kProbe = 0;
+constexpr std::uint32_t kData = 1;
+constexpr std::size_t kKeyOffset = 4;
+constexpr std::size_t kKeySize = 8;
+
+std::string topic_name(const char* tag) { return "wxz_loopback_" + std::string(tag) + "_" + std::to_string(::getpid()); }
+
+std::vector<std::uint8_t> make_sample(std::uint32_t kind, const std::string& key, std::uint32_t seq, std::size_t size = 16) {
+    std::vector<std::uint8_t> b(size, static_cast<std::uint8_t>(seq));
+    std::memcpy(b.data(), &kind, 4);
+    std::memset(b.data() + kKeyOffset, 0, kKeySize);
+    std::memcpy(b.data() + kKeyOffset, key.data(), std::min(key.size(), kKeySize));
+    std::memcpy(b.data() + 12, &seq, 4);
+    return b;
+}
+
+struct Sample {
+    std::string key;
+    std::uint32_t seq{0};
+    std::size_t size{0};
+    std::thread::id thread;
+};
+
+// 收集交付的数据样本；探测样本只计数。
+class Collector {
+public:
+    FastddsChannel::Handler handler() {
+        return [this](const std::uint8_t* d, std::size_t n) {
+            WXZ_CHECK(n >= 16);
+            std::uint32_t kind = 0;
+            std::memcpy(&kind, d, 4);
+            std::lock_guard<std::mutex> lock(mu_);
+            if (kind == kProbe) {
+                ++probes_;
+                return;
+            }
+            Sample s;
+            s.key.assign(reinterpret_cast<const char*>(d + kKeyOffset), kKeySize);
+            s.key.resize(std::strlen(s.key.c_str()));
+            std::memcpy(&s.seq, d + 12, 4);
+            s.size = n;
+            s.thread = std::this_thread::get_id();
+            // 填充字节完好。
+            for (std::size_t i = 16; i < n; ++i) WXZ_CHECK(d[i] == static_cast<std::uint8_t>(s.seq));
+            samples_.push_back(std::move(s));
+        };
+    }
+
+    std::size_t probes() {
+        std::lock_guard<std::mutex> lock(mu_);
+        return probes_;
+    }
+    std::size_t size() {
+        std::lock_guard<std::mutex> lock(mu_);
+        return samples_.size();
+    }
+    std::vector<Sample> samples() {
+        std::lock_guard<std::mutex> lock(mu_);
+        return samples_;
+    }
+    void clear() {
+        std::lock_guard<std::mutex> lock(mu_);
+        samples_.clear();
+        probes_ = 0;
+    }
+
+private:
+    std::mutex mu_;
+    std::size_t probes_{0};
+    std::vector<Sample> samples_;
+};
+
+bool wait_for(const std::function<bool()>& done, std::chrono::milliseconds limit = std::chrono::seconds(10)) {
+    const auto deadline = Clock::now() + limit;
+    while (!done()) {
+        if (Clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// 周期发布探测样本，直到每个读端都收到至少一条（发现与匹配完成）。
+bool connect(FastddsChannel& pub, const std::vector<Collector*>& readers, const std::string& key = "probe") {
+    const auto probe = make_sample(kProbe, key, 0);
+    const auto deadline = Clock::now() + std::chrono::seconds(10);
+    for (;;) {
+        bool all = true;
+        for (auto* r : readers) all = all && r->probes() > 0;
+        if (all) break;
+        if (Clock::now() >= deadline) return false;
+        (void)pub.publish(probe.data(), probe.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    // 让仍在途的探测样本到齐，再清空。
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    for (auto* r : readers) r->clear();
+    return true;
+}
+
+ChannelQoS reliable(std::size_t depth) {
+    ChannelQoS q;
+    q.reliability = ChannelQoS::Reliability::reliable;
+    q.history = depth;
+    return q;
+}
+
+void loan_roundtrip() {
+    const std::string topic = topic_name("loan");
+    const ChannelQoS q = reliable(64);
+    FastddsChannel pub(kDomain, topic, q, kMaxPayload, /*enable_pub=*/true, /*enable_sub=*/false);
+    FastddsChannel sub(kDomain, topic, q, kMaxPayload, /*enable_pub=*/false, /*enable_sub=*/true);
+    Collector got;
+    sub.subscribe(got.handler());
+    WXZ_CHECK(connect(pub, {&got}));
+
+    WXZ_CHECK(!sub.loan().valid());
+    // 未发布即析构的 loan 归还 writer payload 池：反复借出不会耗尽。
+    for (int i = 0; i < 1000; ++i) {
+        auto loan = pub.loan();
+        WXZ_CHECK(loan.valid());
+        WXZ_CHECK(loan.capacity() >= kMaxPayload);
+    }
+
+    constexpr std::uint32_t kMessages = 32;
+    for (std::uint32_t seq = 0; seq < kMessages; ++seq) {
+        auto loan = pub.loan();
+        WXZ_CHECK(loan.valid());
+        const std::size_t n = 16 + (seq * 97) % (kMaxPayload - 16);
+        const auto bytes = make_sample(kData, "loan", seq, n);
+        std::memcpy(loan.data(), bytes.data(), n);
+        loan.commit(n);
+        WXZ_CHECK(pub.publish(std::move(loan)));
+        WXZ_CHECK(!loan.valid()); // 已被消费
+    }
+    WXZ_CHECK(pub.publish_loaned() == kMessages);
+    WXZ_CHECK(wait_for([&] { return got.size() == kMessages; }));
+    const auto samples = got.samples();
+    for (std::uint32_t seq = 0; seq < kMessages; ++seq) {
+        WXZ_CHECK(samples[seq].seq == seq);
+        WXZ_CHECK(samples[seq].size == 16 + (seq * 97) % (kMaxPayload - 16));
+        WXZ_CHECK(samples[seq].key == "loan");
+    }
+}
+
+void batch_take_and_shared_payload() {
+    const std::string topic = topic_name("batch");
+    ChannelQoS sq = reliable(256);
+    sq.recv_batch = 8;
+    FastddsChannel pub(kDomain, topic, reliable(256), kMaxPayload, true, false);
+    FastddsChannel sub(kDomain, topic, sq, kMaxPayload, false, true);
+
+    Executor::Options eo;
+    eo.threads = 2;
+    Executor ex(eo);
+    WXZ_CHECK(ex.start());
+    Collector direct;
+    Collector on_ex_a;
+    Collector on_ex_b;
+    sub.subscribe(direct.handler());
+    sub.subscribe_on(ex, on_ex_a.handler());
+    sub.subscribe_on(ex, on_ex_b.handler());
+    WXZ_CHECK(connect(pub, {&direct, &on_ex_a, &on_ex_b}));
+
+    constexpr std::uint32_t kBurst = 100;
+    const auto burst = [&](std::uint32_t round) {
+        for (std::uint32_t i = 0; i < kBurst; ++i) {
+            const auto b = make_sample(kData, "batch", round * kBurst + i, 256);
+            WXZ_CHECK(pub.publish(b.data(), b.size()));
+        }
+        const std::size_t want = (round + 1) * kBurst;
+        WXZ_CHECK(wait_for([&] { return direct.size() == want && on_ex_a.size() == want && on_ex_b.size() == want; }));
+    };
+    burst(0);
+    const std::uint64_t warm = sub.recv_buffer_allocations();
+    burst(1);
+    burst(2);
+    // 同样的突发模式下接收侧 payload 池已经够用：不再新建或扩容 buffer。
+    WXZ_CHECK(sub.recv_buffer_allocations() == warm);
+
+    // 直接 handler 按发布顺序交付；投递到多线程 executor 的 handler 只校验完整性。
+    const auto samples = direct.samples();
+    for (std::uint32_t i = 0; i < samples.size(); ++i) WXZ_CHECK(samples[i].seq == i);
+    WXZ_CHECK(sub.recv_drop_dispatch_rejected() == 0);
+    sub.stop();
+    ex.stop();
+}
+
+void receive_group_threads() {
+    const std::string topic_a = topic_name("group_a");
+    const std::string topic_b = topic_name("group_b");
+    ChannelQoS sq = reliable(64);
+    sq.recv_group = "loopback_smoke";
+    sq.recv_threads = 1;
+    FastddsChannel pub_a(kDomain, topic_a, reliable(64), kMaxPayload, true, false);
+    FastddsChannel pub_b(kDomain, topic_b, reliable(64), kMaxPayload, true, false);
+    FastddsChannel sub_a(kDomain, topic_a, sq, kMaxPayload, false, true);
+    FastddsChannel sub_b(kDomain, topic_b, sq, kMaxPayload, false, true);
+    Collector got_a;
+    Collector got_b;
+    sub_a.subscribe(got_a.handler());
+    sub_b.subscribe(got_b.handler());
+    WXZ_CHECK(connect(pub_a, {&got_a}));
+    WXZ_CHECK(connect(pub_b, {&got_b}));
+
+    for (std::uint32_t seq = 0; seq < 20; ++seq) {
+        const auto a = make_sample(kData, "a", seq);
+        const auto b = make_sample(kData, "b", seq);
+        WXZ_CHECK(pub_a.publish(a.data(), a.size()));
+        WXZ_CHECK(pub_b.publish(b.data(), b.size()));
+    }
+    WXZ_CHECK(wait_for([&] { return got_a.size() == 20 && got_b.size() == 20; }));
+    const auto a = got_a.samples();
+    const auto b = got_b.samples();
+    const std::thread::id group_thread = a.front().thread;
+    WXZ_CHECK(group_thread != std::this_thread::get_id());
+    for (const auto& s : a) WXZ_CHECK(s.thread == group_thread);
+    for (const auto& s : b) WXZ_CHECK(s.thread == group_thread); // 同名组共享一个线程
+}
+
+void keyed_content_filter() {
+    const std::string topic = topic_name("keyed");
+    ChannelQoS q = reliable(16); // keyed：每个实例的深度
+    q.key_offset = kKeyOffset;
+    q.key_size = kKeySize;
+    ChannelQoS sq = q;
+    sq.filter_expression = "key IN (%0, %1)";
+    sq.filter_parameters = {"'robot_01'", "'robot_02'"};
+    FastddsChannel pub(kDomain, topic, q, kMaxPayload, true, false);
+    FastddsChannel sub(kDomain, topic, sq, kMaxPayload, false, true);
+    Collector got;
+    sub.subscribe(got.handler());
+    WXZ_CHECK(connect(pub, {&got}, "robot_01"));
+
+    const std::vector<std::string> keys{"robot_01", "robot_02", "robot_03", "robot_04"};
+    const auto publish_round = [&](std::uint32_t seq) {
+        for (const auto& k : keys) {
+            const auto b = make_sample(kData, k, seq);
+            WXZ_CHECK(pub.publish(b.data(), b.size()));
+        }
+    };
+    for (std::uint32_t seq = 0; seq < 10; ++seq) publish_round(seq);
+    WXZ_CHECK(wait_for([&] { return got.size() == 20; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (const auto& s : got.samples()) WXZ_CHECK(s.key == "robot_01" || s.key == "robot_02");
+    WXZ_CHECK(got.size() == 20);
+
+    // 运行时替换参数：写端经发现协议得知新参数之前可能仍按旧参数在写端丢弃，先用新 key 的探测样本确认生效。
+    WXZ_CHECK(sub.set_filter_parameters({"'robot_03'", "'robot_03'"}));
+    WXZ_CHECK(!sub.set_filter_parameters({"'robot_03'"})); // 参数个数不足：原参数保持不变
+    WXZ_CHECK(connect(pub, {&got}, "robot_03"));
+    for (std::uint32_t seq = 10; seq < 20; ++seq) publish_round(seq);
+    WXZ_CHECK(wait_for([&] { return got.size() == 10; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (const auto& s : got.samples()) WXZ_CHECK(s.key == "robot_03");
+    WXZ_CHECK(got.size() == 10);
+
+    // 未配置过滤的 channel 不能替换参数。
+    FastddsChannel plain(kDomain, topic, q, kMaxPayload, false, true);
+    WXZ_CHECK(!plain.set_filter_parameters({"'robot_01'"}));
+}
+
+void flow_controlled_writer() {
+    const std::string topic = topic_name("flow");
+    constexpr std::uint64_t kBytesPerPeriod = 4096;
+    constexpr std::uint64_t kPeriodMs = 50;
+    ChannelQoS pq = reliable(64);
+    pq.flow_bytes_per_period = kBytesPerPeriod;
+    pq.flow_period_ms = kPeriodMs;
+    pq.flow_controller = "loopback_smoke";
+    FastddsChannel pub(kDomain, topic, pq, kMaxPayload, true, false);
+    FastddsChannel sub(kDomain, topic, reliable(64), kMaxPayload, false, true);
+    Collector got;
+    sub.subscribe(got.handler());
+    WXZ_CHECK(connect(pub, {&got}));
+
+    // 32 KB 的样本：每周期最多 4 KB，至少需要 7 个完整周期。
+    constexpr std::uint32_t kMessages = 32;
+    const auto start = Clock::now();
+    for (std::uint32_t seq = 0; seq < kMessages; ++seq) {
+        const auto b = make_sample(kData, "flow", seq, 1024);
+        WXZ_CHECK(pub.publish(b.data(), b.size()));
+    }
+    WXZ_CHECK(wait_for([&] { return got.size() == kMessages; }));
+    const auto elapsed = Clock::now() - start;
+    WXZ_CHECK(elapsed >= std::chrono::milliseconds(kPeriodMs * 6));
+    const auto samples = got.samples();
+    for (std::uint32_t i = 0; i < kMessages; ++i) WXZ_CHECK(samples[i].seq == i);
+}
+
+} // namespace
+
+int main() {
+    loan_roundtrip();
+    batch_take_and_shared_payload();
+    receive_group_threads();
+    keyed_content_filter();
+    flow_controlled_writer();
+    return 0;
+}
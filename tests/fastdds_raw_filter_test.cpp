@@ -0,0 +1,114 @@
+// raw 字节 topic 内容过滤（WXZ_RAW_BYTES）的表达式编译/求值，以及 keyed raw 类型名的编解码。
+// 只覆盖不依赖 FastDDS 的部分；ContentFilteredTopic 上的端到端行为需要 FastDDS 环境。
+
+#include "internal/fastdds_raw_filter.h"
+#include "test_util.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace wxz::core::internal;
+
+namespace {
+
+// payload 布局：[0,4) 类型码（小端）+ [4,12) key + 其余字节。
+constexpr std::size_t kKeyOffset = 4;
+constexpr std::size_t kKeySize = 8;
+
+std::vector<std::uint8_t> make_sample(std::uint32_t type, const std::string& key, std::size_t size = 16) {
+    std::vector<std::uint8_t> b(size, 0);
+    std::memcpy(b.data(), &type, sizeof(type));
+    std::memcpy(b.data() + kKeyOffset, key.data(), std::min(key.size(), kKeySize));
+    return b;
+}
+
+bool matches(const std::string& expr, const std::vector<std::string>& params, const std::vector<std::uint8_t>& sample) {
+    const auto program = compile_raw_bytes_filter(expr, params, kKeyOffset, kKeySize);
+    return evaluate_raw_bytes_filter(*program, sample.data(), sample.size());
+}
+
+bool rejects(const std::string& expr, const std::vector<std::string>& params = {}, std::size_t key_size = kKeySize) {
+    try {
+        (void)compile_raw_bytes_filter(expr, params, kKeyOffset, key_size);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+void evaluates_expressions() {
+    const auto a = make_sample(1, "robot_01");
+    const auto b = make_sample(2, "robot_07");
+
+    // key 与参数：短值右侧补 0。
+    WXZ_CHECK(matches("key = %0", {"'robot_01'"}, a));
+    WXZ_CHECK(!matches("key = %0", {"'robot_01'"}, b));
+    WXZ_CHECK(matches("key = 'robot'", {}, make_sample(1, "robot")));
+    WXZ_CHECK(!matches("key = 'robot'", {}, a));
+    // 参数的原样文本、十六进制与 IN 列表。
+    WXZ_CHECK(matches("key IN (%0, %1, %2)", {"robot_03", "robot_07", "0x00"}, b));
+    WXZ_CHECK(!matches("key IN (%0, %1)", {"robot_03", "robot_05"}, b));
+    // bytes 区间、<>、NOT/AND/OR 与括号；关键字大小写不敏感。
+    WXZ_CHECK(matches("bytes[0:4] = 0x01000000", {}, a));
+    WXZ_CHECK(matches("bytes[0:4] <> 0x01000000", {}, b));
+    WXZ_CHECK(matches("bytes[0:4] = 0x02000000 and not key = 'robot_01'", {}, b));
+    WXZ_CHECK(!matches("bytes[0:4] = 0x02000000 AND NOT key = 'robot_07'", {}, b));
+    WXZ_CHECK(matches("key = 'x' OR (bytes[0:4] = 0x01000000 AND key = 'robot_01')", {}, a));
+    WXZ_CHECK(!matches("NOT (key = 'robot_01' OR key = 'robot_07')", {}, a));
+    // 字面量中的 '' 表示单引号。
+    WXZ_CHECK(matches("bytes[4:3] = 'a''b'", {}, make_sample(0, "a'b")));
+    // 值长于字段时不相等；payload 短于字段区间时不匹配（NOT 之后为真）。
+    WXZ_CHECK(!matches("bytes[0:1] = 0x0100", {}, a));
+    WXZ_CHECK(!matches("bytes[12:8] = 0x00", {}, a));
+    WXZ_CHECK(matches("NOT bytes[12:8] = 0x00", {}, a));
+    WXZ_CHECK(!matches("key = 'robot_01'", {}, make_sample(1, "robot_01", 8)));
+}
+
+void rejects_bad_expressions() {
+    WXZ_CHECK(rejects(""));
+    WXZ_CHECK(rejects("key"));
+    WXZ_CHECK(rejects("key = "));
+    WXZ_CHECK(rejects("key == 'a'"));
+    WXZ_CHECK(rejects("key = 'a' AND"));
+    WXZ_CHECK(rejects("(key = 'a'"));
+    WXZ_CHECK(rejects("key = 'a') "));
+    WXZ_CHECK(rejects("key = 'unterminated"));
+    WXZ_CHECK(rejects("key = 0x123"));              // 奇数个十六进制位
+    WXZ_CHECK(rejects("key = %1", {"only_one"}));   // 参数下标越界
+    WXZ_CHECK(rejects("key = %0", {"0xzz"}));       // 参数内的十六进制非法
+    WXZ_CHECK(rejects("bytes[0:0] = 0x00"));        // 空区间
+    WXZ_CHECK(rejects("bytes[0] = 0x00"));
+    WXZ_CHECK(rejects("field = 'a'"));
+    WXZ_CHECK(rejects("keyx = 'a'"));               // 关键字须整词匹配
+    WXZ_CHECK(rejects("key = 'a'", {}, 0));         // 无 key 的类型不能用 key
+    WXZ_CHECK(!rejects("bytes[0:4] = 0x01000000", {}, 0));
+}
+
+void type_name_round_trip() {
+    std::size_t off = 99;
+    std::size_t size = 99;
+    WXZ_CHECK(parse_raw_bytes_type_name(raw_bytes_type_name(0, 0), off, size));
+    WXZ_CHECK(off == 0 && size == 0);
+    WXZ_CHECK(parse_raw_bytes_type_name(raw_bytes_type_name(4, 8), off, size));
+    WXZ_CHECK(off == 4 && size == 8);
+    WXZ_CHECK(parse_raw_bytes_type_name(raw_bytes_type_name(123456789, 16), off, size));
+    WXZ_CHECK(off == 123456789 && size == 16);
+
+    // 非 raw 类型或格式不对：返回 false。
+    for (const char* bad : {"", "Foo", "WxzRawBytesX", "WxzRawBytesKeyed_", "WxzRawBytesKeyed_4", "WxzRawBytesKeyed_4_",
+                            "WxzRawBytesKeyed__8", "WxzRawBytesKeyed_4_0", "WxzRawBytesKeyed_a_8", "WxzRawBytesKeyed_4_8x",
+                            "WxzRawBytesKeyed_-4_8", "WxzRawBytesKeyed_4_8_1", "WxzRawBytesKeyed_1234567890_8"}) {
+        WXZ_CHECK(!parse_raw_bytes_type_name(bad, off, size));
+    }
+}
+
+} // namespace
+
+int main() {
+    evaluates_expressions();
+    rejects_bad_expressions();
+    type_name_round_trip();
+    return 0;
+}
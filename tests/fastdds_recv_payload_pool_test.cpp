@@ -0,0 +1,150 @@
+// FastddsChannel 接收侧共享 payload 池：
+// - 引用计数归零后 buffer 回到池中复用，预热后不再分配；
+// - 仍被引用的 payload 不会被当作下一条样本的写入目标；
+// - 池晚于最后一个借出的 payload 释放（channel 先于排队任务析构的场景）；
+// - 多线程释放时每个 payload 只归还一次。
+
+#include "internal/fastdds_recv_payload_pool.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using wxz::core::internal::FastddsRecvPayloadPool;
+using wxz::core::internal::RecvPayload;
+using wxz::core::internal::RecvPayloadRef;
+
+namespace {
+
+void reuse_after_release() {
+    auto pool = std::make_shared<FastddsRecvPayloadPool>("test");
+    auto ref = pool->acquire();
+    WXZ_CHECK(ref.unique());
+    WXZ_CHECK(pool->allocations() == 1);
+    std::memset(pool->prepare(ref, 256), 0xab, 256);
+    WXZ_CHECK(ref.size() == 256);
+    WXZ_CHECK(pool->allocations() == 2); // 新建 + 首次扩容
+
+    RecvPayload* first = ref.get();
+    ref.reset();
+    auto again = pool->acquire();
+    WXZ_CHECK(again.get() == first);
+    WXZ_CHECK(again.size() == 0);
+    (void)pool->prepare(again, 128); // 容量足够：不扩容
+    WXZ_CHECK(pool->allocations() == 2);
+}
+
+void shared_ref_is_not_reused() {
+    auto pool = std::make_shared<FastddsRecvPayloadPool>("test");
+    auto ref = pool->acquire();
+    (void)pool->prepare(ref, 16);
+    RecvPayloadRef queued = ref; // 模拟排队中的任务持有
+    WXZ_CHECK(!ref.unique());
+
+    auto other = pool->acquire();
+    WXZ_CHECK(other.get() != ref.get());
+    queued.reset();
+    WXZ_CHECK(ref.unique());
+}
+
+void pool_outlives_channel() {
+    auto pool = std::make_shared<FastddsRecvPayloadPool>("test");
+    std::weak_ptr<FastddsRecvPayloadPool> weak = pool;
+    auto ref = pool->acquire();
+    std::memcpy(pool->prepare(ref, 4), "abcd", 4);
+    pool.reset(); // channel 析构
+    WXZ_CHECK(!weak.expired());
+    WXZ_CHECK(std::memcmp(ref.data(), "abcd", 4) == 0);
+    ref.reset(); // 最后一个借出的 payload 归还后池随之释放
+    WXZ_CHECK(weak.expired());
+}
+
+// 一个接收线程反复取 payload 写入，复制引用交给多个消费线程并发释放。
+void concurrent_release() {
+    constexpr std::size_t kConsumers = 4;
+    constexpr std::size_t kMessages = 100000;
+    auto pool = std::make_shared<FastddsRecvPayloadPool>("test");
+
+    std::mutex mu;
+    std::condition_variable cv;
+    std::deque<RecvPayloadRef> queue;
+    bool done = false;
+    std::atomic<std::size_t> bad{0};
+
+    std::vector<std::thread> consumers;
+    for (std::size_t c = 0; c < kConsumers; ++c) {
+        consumers.emplace_back([&] {
+            for (;;) {
+                RecvPayloadRef ref;
+                {
+                    std::unique_lock<std::mutex> lock(mu);
+                    cv.wait(lock, [&] { return done || !queue.empty(); });
+                    if (queue.empty()) return;
+                    ref = std::move(queue.front());
+                    queue.pop_front();
+                }
+                // 写入后不再修改：内容必须保持一致。
+                std::uint64_t v = 0;
+                std::memcpy(&v, ref.data(), sizeof(v));
+                for (std::size_t i = sizeof(v); i < ref.size(); ++i) {
+                    if (ref.data()[i] != static_cast<std::uint8_t>(v)) bad.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    RecvPayloadRef current;
+    for (std::uint64_t i = 0; i < kMessages; ++i) {
+        if (!current.unique()) current = pool->acquire();
+        const std::size_t len = 64 + (i % 8) * 64;
+        auto* dst = pool->prepare(current, len);
+        std::memcpy(dst, &i, sizeof(i));
+        std::memset(dst + sizeof(i), static_cast<int>(static_cast<std::uint8_t>(i)), len - sizeof(i));
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            // 背压：防止排队的 payload 无限增长。
+            if (queue.size() >= 64) {
+                queue.pop_front();
+            }
+            queue.push_back(current);
+        }
+        cv.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        done = true;
+    }
+    cv.notify_all();
+    for (auto& t : consumers) t.join();
+    WXZ_CHECK(bad.load() == 0);
+
+    // 全部归还后，池中每个 payload 恰好空闲一份：逐个取出时互不相同，取完之前不再分配。
+    // 同时在用的 payload 最多为队列上限 64 + 消费者在手 4 + 接收线程 1。
+    current.reset();
+    const std::uint64_t allocs = pool->allocations();
+    std::vector<RecvPayloadRef> held;
+    std::set<const void*> seen;
+    for (;;) {
+        held.push_back(pool->acquire());
+        if (pool->allocations() != allocs) break;
+        WXZ_CHECK(seen.insert(held.back().get()).second);
+    }
+    WXZ_CHECK(!seen.empty() && seen.size() <= 69);
+}
+
+} // namespace
+
+int main() {
+    reuse_after_release();
+    shared_ref_is_not_reused();
+    pool_outlives_channel();
+    concurrent_release();
+    return 0;
+}
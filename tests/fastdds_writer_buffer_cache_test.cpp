@@ -0,0 +1,153 @@
+// FastddsChannel 写端 payload buffer 缓存（FastddsWriterPayloadPool 的实现）：
+// best-fit 复用、缓存上限、loan 的 arm/取走/撤回，以及多线程下 buffer 不被重复借出。
+
+#include "internal/fastdds_writer_buffer_cache.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+using wxz::core::internal::FastddsWriterBufferCache;
+
+namespace {
+
+constexpr std::uint32_t kKiB = 1024;
+constexpr std::uint32_t kMiB = 1024 * kKiB;
+
+void reuses_released_buffers() {
+    FastddsWriterBufferCache cache(64 * kKiB, 8 * kMiB);
+    std::uint32_t cap = 0;
+    auto* a = cache.acquire(100, cap);
+    WXZ_CHECK(cap == 64 * kKiB); // 至少 buffer_bytes
+    cache.release(a, cap);
+    WXZ_CHECK(cache.free_count() == 1);
+    std::uint32_t cap2 = 0;
+    WXZ_CHECK(cache.acquire(64 * kKiB, cap2) == a);
+    WXZ_CHECK(cap2 == cap);
+    WXZ_CHECK(cache.free_count() == 0);
+    cache.release(a, cap2);
+}
+
+void best_fit_by_capacity() {
+    FastddsWriterBufferCache cache(64 * kKiB, 8 * kMiB);
+    std::uint32_t cap_big = 0;
+    std::uint32_t cap_mid = 0;
+    auto* big = cache.acquire(1 * kMiB, cap_big);
+    auto* mid = cache.acquire(128 * kKiB, cap_mid);
+    WXZ_CHECK(cap_big == 1 * kMiB && cap_mid == 128 * kKiB);
+    cache.release(big, cap_big);
+    cache.release(mid, cap_mid);
+
+    // 100 KB 的帧取 128 KB 的 buffer；1 MB 的 buffer 超过需要的两倍，不拿来承载小帧。
+    std::uint32_t cap = 0;
+    WXZ_CHECK(cache.acquire(100 * kKiB, cap) == mid);
+    WXZ_CHECK(cap == cap_mid);
+    std::uint32_t cap_small = 0;
+    auto* small = cache.acquire(64 * kKiB, cap_small);
+    WXZ_CHECK(small != big);
+    WXZ_CHECK(cap_small == 64 * kKiB);
+    std::uint32_t cap_frame = 0;
+    WXZ_CHECK(cache.acquire(600 * kKiB, cap_frame) == big);
+    WXZ_CHECK(cap_frame == cap_big);
+
+    cache.release(mid, cap);
+    cache.release(small, cap_small);
+    cache.release(big, cap_frame);
+}
+
+void bounded_cache() {
+    // 字节上限：max(64 * buffer_bytes, 2 * frame_bytes) = 2 MB，第三个 1 MB buffer 直接释放。
+    {
+        FastddsWriterBufferCache cache(1 * kKiB, 1 * kMiB);
+        std::vector<std::uint8_t*> bufs;
+        std::uint32_t cap = 0;
+        for (int i = 0; i < 3; ++i) bufs.push_back(cache.acquire(1 * kMiB, cap));
+        for (auto* b : bufs) cache.release(b, cap);
+        WXZ_CHECK(cache.free_count() == 2);
+        WXZ_CHECK(cache.free_bytes() == 2 * kMiB);
+    }
+    // 个数上限：kMaxFree。
+    {
+        FastddsWriterBufferCache cache(1 * kKiB, 1 * kKiB);
+        std::vector<std::uint8_t*> bufs;
+        std::uint32_t cap = 0;
+        for (std::size_t i = 0; i < FastddsWriterBufferCache::kMaxFree + 8; ++i) bufs.push_back(cache.acquire(1, cap));
+        for (auto* b : bufs) cache.release(b, cap);
+        WXZ_CHECK(cache.free_count() == FastddsWriterBufferCache::kMaxFree);
+    }
+}
+
+void armed_loan_handover() {
+    FastddsWriterBufferCache cache(64 * kKiB, 1 * kMiB);
+    std::uint32_t loan_cap = 0;
+    auto* loan = cache.acquire(1 * kMiB, loan_cap);
+
+    // DataWriter 在 write() 内取走 armed buffer：disarm 返回 true，之后由 release 归还。
+    cache.arm(loan, loan_cap);
+    std::uint32_t cap = 0;
+    WXZ_CHECK(cache.take_armed_or_acquire(512 * kKiB, cap) == loan);
+    WXZ_CHECK(cap == loan_cap);
+    WXZ_CHECK(cache.disarm());
+
+    // write() 失败、没有取 payload：disarm 返回 false，buffer 仍归 loan；下一次取 payload 不会拿到它。
+    cache.arm(loan, loan_cap);
+    WXZ_CHECK(!cache.disarm());
+    std::uint32_t other_cap = 0;
+    auto* other = cache.take_armed_or_acquire(1 * kKiB, other_cap);
+    WXZ_CHECK(other != loan);
+    cache.release(other, other_cap);
+
+    // armed buffer 容量不足：退回缓存，本次另取。
+    cache.arm(loan, 1 * kKiB);
+    auto* bigger = cache.take_armed_or_acquire(2 * kMiB, cap);
+    WXZ_CHECK(bigger != loan);
+    WXZ_CHECK(cap == 2 * kMiB);
+    WXZ_CHECK(cache.disarm());
+    cache.release(bigger, cap);
+}
+
+// 多个发布线程与“DataWriter 归还”并发：任一时刻一个 buffer 只被一个线程持有。
+void concurrent_exclusive_ownership() {
+    constexpr std::size_t kThreads = 4;
+    constexpr std::size_t kIterations = 20000;
+    FastddsWriterBufferCache cache(4 * kKiB, 256 * kKiB);
+    std::atomic<std::size_t> bad{0};
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(static_cast<std::uint32_t>(t + 1));
+            std::uniform_int_distribution<std::uint32_t> size_dist(1, 256 * kKiB);
+            const auto tag = static_cast<std::uint8_t>(t + 1);
+            for (std::size_t i = 0; i < kIterations; ++i) {
+                std::uint32_t cap = 0;
+                const std::uint32_t size = size_dist(rng);
+                auto* buf = cache.acquire(size, cap);
+                if (cap < size) bad.fetch_add(1);
+                // 首尾各写一个标记，让出 CPU 后检查是否被别的线程改写。
+                buf[0] = tag;
+                buf[size - 1] = tag;
+                std::this_thread::yield();
+                if (buf[0] != tag || buf[size - 1] != tag) bad.fetch_add(1);
+                cache.release(buf, cap);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    WXZ_CHECK(bad.load() == 0);
+    WXZ_CHECK(cache.free_count() <= FastddsWriterBufferCache::kMaxFree);
+    WXZ_CHECK(cache.free_bytes() <= 512 * kKiB);
+}
+
+} // namespace
+
+int main() {
+    reuses_released_buffers();
+    best_fit_by_capacity();
+    bounded_cache();
+    armed_loan_handover();
+    concurrent_exclusive_ownership();
+    return 0;
+}
@@ -0,0 +1,446 @@
+// InprocChannel 的 QoS 与分发行为（默认分发线程与订阅队列两条路径）：
+// - keep_last：默认 history=1 只保留最新样本；积压超过 history 时丢弃最旧样本，缓冲池耗尽时发布端覆盖最旧样本而不失败；
+//   keep_all（history=0）不丢弃，写满时 publish 失败；
+// - lifespan：分发时丢弃发布时间早于 lifespan 的样本；
+// - time_based_filter：每个订阅独立的最小间隔（按发布时间戳判定）；
+// - deadline：收到第一条样本之前不计；发布端停发后由空闲检测按周期计 deadline_missed 并上报指标，同一周期只计一次；
+// - 订阅队列分发：慢订阅不阻塞其它订阅，同一订阅按发布顺序串行交付，buffer 在最后一个订阅处理完后才归还；
+//   首个订阅之前发布的消息转交给首个订阅队列；空闲 park 的默认分发线程不会漏掉唤醒。
+
+#include "executor.h"
+#include "inproc_channel.h"
+#include "observability.h"
+#include "strand.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using wxz::core::ChannelQoS;
+using wxz::core::Executor;
+using wxz::core::InprocChannel;
+using wxz::core::Strand;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kBufferBytes = 64;
+
+// 记录 counter_add 的累计值（按 name）。
+class RecordingSink final : public wxz::core::MetricsSink {
+public:
+    void counter_add(std::string_view name, double v, std::initializer_list<wxz::core::LabelView>) noexcept override {
+        std::lock_guard<std::mutex> lock(mu_);
+        totals_[std::string(name)] += v;
+    }
+    void gauge_set(std::string_view, double, std::initializer_list<wxz::core::LabelView>) noexcept override {}
+    void histogram_observe(std::string_view, double, std::initializer_list<wxz::core::LabelView>) noexcept override {}
+
+    double total(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mu_);
+        const auto it = totals_.find(name);
+        return it == totals_.end() ? 0 : it->second;
+    }
+
+private:
+    std::mutex mu_;
+    std::map<std::string, double> totals_;
+};
+
+bool wait_for(const std::function<bool()>& done, std::chrono::milliseconds limit = std::chrono::seconds(5)) {
+    const auto deadline = Clock::now() + limit;
+    while (!done()) {
+        if (Clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void drain(Executor& ex) {
+    while (ex.spin_once(std::chrono::milliseconds(0))) {
+    }
+}
+
+Executor::Options spin_options() {
+    Executor::Options o;
+    o.threads = 0; // 由测试线程 spin_once 排空订阅队列，交付时机确定
+    return o;
+}
+
+bool publish_u32(InprocChannel& ch, std::uint32_t v) {
+    return ch.publish(reinterpret_cast<const std::uint8_t*>(&v), sizeof(v));
+}
+
+std::uint32_t read_u32(const std::uint8_t* d, std::size_t n) {
+    WXZ_CHECK(n == sizeof(std::uint32_t));
+    std::uint32_t v = 0;
+    std::memcpy(&v, d, sizeof(v));
+    return v;
+}
+
+// 收集交付的样本；默认分发线程写、测试线程读，加锁。
+struct Received {
+    std::mutex mu;
+    std::vector<std::uint32_t> values;
+
+    InprocChannel::Handler handler() {
+        return [this](const std::uint8_t* d, std::size_t n) {
+            const std::uint32_t v = read_u32(d, n);
+            std::lock_guard<std::mutex> lock(mu);
+            values.push_back(v);
+        };
+    }
+    std::vector<std::uint32_t> snapshot() {
+        std::lock_guard<std::mutex> lock(mu);
+        return values;
+    }
+    std::size_t size() {
+        std::lock_guard<std::mutex> lock(mu);
+        return values.size();
+    }
+};
+
+// 默认分发线程在交付第一条样本时被占住，期间发布的样本全部积压在共享队列里。
+struct GatedHandler {
+    std::atomic<bool> entered{false};
+    std::atomic<bool> open{false};
+    Received received;
+
+    InprocChannel::Handler handler() {
+        return [this](const std::uint8_t* d, std::size_t n) {
+            if (!entered.exchange(true)) {
+                while (!open.load()) std::this_thread::yield();
+            }
+            received.handler()(d, n);
+        };
+    }
+};
+
+void keep_last_queued() {
+    Executor ex(spin_options());
+    WXZ_CHECK(ex.start());
+
+    {
+        // 默认 QoS：history=1。
+        InprocChannel ch(8, kBufferBytes);
+        Received got;
+        auto sub = ch.subscribe_scoped_on(ex, got.handler());
+        for (std::uint32_t i = 0; i < 5; ++i) WXZ_CHECK(publish_u32(ch, i));
+        drain(ex);
+        WXZ_CHECK(got.snapshot() == std::vector<std::uint32_t>{4});
+        WXZ_CHECK(ch.recv_drop_history() == 4);
+        WXZ_CHECK(ch.publish_fail() == 0);
+    }
+    {
+        ChannelQoS q;
+        q.history = 3;
+        InprocChannel ch(4, kBufferBytes, q);
+        Received got;
+        auto sub = ch.subscribe_scoped_on(ex, got.handler());
+        // 发布数远超缓冲池容量：订阅队列按深度覆盖，buffer 随之归还，发布端不失败。
+        for (std::uint32_t i = 0; i < 20; ++i) WXZ_CHECK(publish_u32(ch, i));
+        drain(ex);
+        WXZ_CHECK((got.snapshot() == std::vector<std::uint32_t>{17, 18, 19}));
+        WXZ_CHECK(ch.recv_drop_history() == 17);
+    }
+    {
+        ChannelQoS q;
+        q.history = 0; // keep_all
+        InprocChannel ch(4, kBufferBytes, q);
+        Received got;
+        auto sub = ch.subscribe_scoped_on(ex, got.handler());
+        for (std::uint32_t i = 0; i < 4; ++i) WXZ_CHECK(publish_u32(ch, i));
+        WXZ_CHECK(!publish_u32(ch, 4)); // 缓冲池写满：不丢弃，发布失败
+        drain(ex);
+        WXZ_CHECK((got.snapshot() == std::vector<std::uint32_t>{0, 1, 2, 3}));
+        WXZ_CHECK(ch.recv_drop_history() == 0);
+        WXZ_CHECK(publish_u32(ch, 5)); // 交付后 buffer 归还
+        drain(ex);
+        WXZ_CHECK(got.size() == 5);
+    }
+    ex.stop();
+}
+
+void keep_last_dispatch_thread() {
+    ChannelQoS q;
+    q.history = 2;
+    // 缓冲池只有 4 个 buffer：分发线程占着一个，其余积压在共享队列，继续发布时覆盖最旧样本。
+    InprocChannel ch(4, kBufferBytes, q);
+    GatedHandler h;
+    ch.subscribe(h.handler());
+    WXZ_CHECK(publish_u32(ch, 0));
+    WXZ_CHECK(wait_for([&] { return h.entered.load(); }));
+    for (std::uint32_t i = 1; i < 10; ++i) WXZ_CHECK(publish_u32(ch, i));
+    WXZ_CHECK(ch.publish_fail() == 0);
+    h.open.store(true);
+    WXZ_CHECK(wait_for([&] { return h.received.size() == 3; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    WXZ_CHECK((h.received.snapshot() == std::vector<std::uint32_t>{0, 8, 9}));
+    WXZ_CHECK(ch.recv_drop_history() == 7);
+    ch.stop();
+}
+
+void lifespan_expiry() {
+    constexpr auto kLifespan = std::chrono::milliseconds(30);
+    ChannelQoS q;
+    q.history = 0;
+    q.lifespan_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(kLifespan).count();
+
+    {
+        Executor ex(spin_options());
+        WXZ_CHECK(ex.start());
+        InprocChannel ch(16, kBufferBytes, q);
+        Received got;
+        auto sub = ch.subscribe_scoped_on(ex, got.handler());
+        for (std::uint32_t i = 0; i < 3; ++i) WXZ_CHECK(publish_u32(ch, i));
+        std::this_thread::sleep_for(kLifespan * 3);
+        WXZ_CHECK(publish_u32(ch, 3));
+        WXZ_CHECK(publish_u32(ch, 4));
+        drain(ex);
+        WXZ_CHECK((got.snapshot() == std::vector<std::uint32_t>{3, 4}));
+        WXZ_CHECK(ch.recv_drop_lifespan() == 3);
+        ex.stop();
+    }
+    {
+        InprocChannel ch(16, kBufferBytes, q);
+        GatedHandler h;
+        ch.subscribe(h.handler());
+        WXZ_CHECK(publish_u32(ch, 0));
+        WXZ_CHECK(wait_for([&] { return h.entered.load(); }));
+        for (std::uint32_t i = 1; i < 4; ++i) WXZ_CHECK(publish_u32(ch, i));
+        std::this_thread::sleep_for(kLifespan * 3);
+        WXZ_CHECK(publish_u32(ch, 4));
+        h.open.store(true);
+        WXZ_CHECK(wait_for([&] { return h.received.size() == 2; }));
+        WXZ_CHECK((h.received.snapshot() == std::vector<std::uint32_t>{0, 4}));
+        WXZ_CHECK(ch.recv_drop_lifespan() == 3);
+        ch.stop();
+    }
+}
+
+void time_based_filter_per_subscriber() {
+    constexpr auto kSeparation = std::chrono::milliseconds(30);
+    ChannelQoS q;
+    q.history = 0;
+    q.time_based_filter_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(kSeparation).count();
+    Executor ex(spin_options());
+    WXZ_CHECK(ex.start());
+    InprocChannel ch(16, kBufferBytes, q);
+
+    Received a;
+    Received b;
+    auto sub_a = ch.subscribe_scoped_on(ex, a.handler());
+    WXZ_CHECK(publish_u32(ch, 0));
+    drain(ex);
+    // b 尚未收到过样本：不受 a 的间隔影响。
+    auto sub_b = ch.subscribe_scoped_on(ex, b.handler());
+    WXZ_CHECK(publish_u32(ch, 1));
+    WXZ_CHECK(publish_u32(ch, 2));
+    drain(ex);
+    std::this_thread::sleep_for(kSeparation * 2);
+    WXZ_CHECK(publish_u32(ch, 3));
+    // 按发布时间判定：交付被推迟也不会让间隔内的样本通过。
+    WXZ_CHECK(publish_u32(ch, 4));
+    std::this_thread::sleep_for(kSeparation * 2);
+    drain(ex);
+
+    WXZ_CHECK((a.snapshot() == std::vector<std::uint32_t>{0, 3}));
+    WXZ_CHECK((b.snapshot() == std::vector<std::uint32_t>{1, 3}));
+    // a：1、2、4；b：2、4。
+    WXZ_CHECK(ch.recv_drop_filtered() == 5);
+    ex.stop();
+}
+
+// 停发后空闲检测计数：每个完整周期一次，不重复计数。
+void check_idle_deadline(InprocChannel& ch,
+                         RecordingSink& sink,
+                         const std::function<bool()>& delivered,
+                         std::chrono::milliseconds period) {
+    // 收到第一条样本之前不计 deadline。
+    std::this_thread::sleep_for(period * 3);
+    WXZ_CHECK(ch.deadline_missed() == 0);
+
+    WXZ_CHECK(publish_u32(ch, 0));
+    const auto published = Clock::now();
+    WXZ_CHECK(wait_for(delivered));
+    WXZ_CHECK(wait_for([&] { return ch.deadline_missed() >= 3; }));
+    const auto elapsed = Clock::now() - published;
+    const std::uint64_t missed = ch.deadline_missed();
+    WXZ_CHECK(missed <= static_cast<std::uint64_t>(elapsed / period) + 1);
+    WXZ_CHECK(sink.total("wxz.inproc.recv.deadline_missed") >= 3);
+
+    // 恢复发布后不再增长（间隔小于周期）。
+    for (int i = 0; i < 5; ++i) {
+        std::this_thread::sleep_for(period / 4);
+        WXZ_CHECK(publish_u32(ch, 1));
+    }
+    const std::uint64_t before = ch.deadline_missed();
+    std::this_thread::sleep_for(period / 4);
+    WXZ_CHECK(publish_u32(ch, 2));
+    WXZ_CHECK(ch.deadline_missed() <= before + 1);
+}
+
+void deadline_missed_when_publisher_stops() {
+    constexpr auto kPeriod = std::chrono::milliseconds(20);
+    RecordingSink sink;
+    wxz::core::set_metrics_sink(&sink);
+    ChannelQoS q;
+    q.history = 4;
+    q.deadline_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(kPeriod).count();
+
+    {
+        // 默认分发线程：park 时按 deadline 周期醒来检测。
+        InprocChannel ch(8, kBufferBytes, q);
+        Received got;
+        ch.subscribe(got.handler());
+        check_idle_deadline(ch, sink, [&] { return got.size() == 1; }, kPeriod);
+        ch.stop();
+    }
+    {
+        // 订阅队列：由排空所用 Executor 上的周期任务检测；取消订阅后不再计数。
+        Executor::Options o;
+        o.threads = 1;
+        Executor ex(o);
+        WXZ_CHECK(ex.start());
+        InprocChannel ch(8, kBufferBytes, q);
+        Received got;
+        auto sub = ch.subscribe_scoped_on(ex, got.handler());
+        check_idle_deadline(ch, sink, [&] { return got.size() == 1; }, kPeriod);
+        sub.reset();
+        const std::uint64_t after_cancel = ch.deadline_missed();
+        std::this_thread::sleep_for(kPeriod * 4);
+        WXZ_CHECK(ch.deadline_missed() == after_cancel);
+        ch.stop();
+        ex.stop();
+    }
+    wxz::core::set_metrics_sink(nullptr);
+}
+
+void slow_subscriber_does_not_block_others() {
+    ChannelQoS q;
+    q.history = 0;
+    InprocChannel::Options opts;
+    opts.dispatch_threads = 2;
+    constexpr std::uint32_t kMessages = 8;
+    InprocChannel ch(kMessages, kBufferBytes, q, opts);
+
+    GatedHandler slow;
+    Received fast;
+    auto sub_slow = ch.subscribe_scoped(slow.handler());
+    auto sub_fast = ch.subscribe_scoped(fast.handler());
+    for (std::uint32_t i = 0; i < kMessages; ++i) WXZ_CHECK(publish_u32(ch, i));
+    WXZ_CHECK(wait_for([&] { return fast.size() == kMessages; }));
+    WXZ_CHECK(slow.entered.load());
+    WXZ_CHECK(slow.received.size() == 0);
+    // 慢订阅仍持有全部 buffer 的引用：缓冲池已满。
+    WXZ_CHECK(!publish_u32(ch, kMessages));
+
+    slow.open.store(true);
+    WXZ_CHECK(wait_for([&] { return slow.received.size() == kMessages; }));
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < kMessages; ++i) expected.push_back(i);
+    WXZ_CHECK(slow.received.snapshot() == expected);
+    WXZ_CHECK(fast.snapshot() == expected);
+    WXZ_CHECK(ch.messages_delivered() == 2 * kMessages);
+    // 最后一个订阅处理完后 buffer 全部归还。
+    WXZ_CHECK(wait_for([&] { return publish_u32(ch, kMessages); }));
+    ch.stop();
+}
+
+void strand_subscriptions_are_serial() {
+    Executor::Options o;
+    o.threads = 4;
+    Executor ex(o);
+    WXZ_CHECK(ex.start());
+    Strand strand(ex);
+    ChannelQoS q;
+    q.history = 0;
+    constexpr std::uint32_t kMessages = 2048;
+    InprocChannel ch(kMessages, kBufferBytes, q);
+
+    // 两个订阅共用一个 strand：彼此之间也不并发。
+    std::atomic<int> inside{0};
+    std::vector<std::uint32_t> a;
+    std::vector<std::uint32_t> b;
+    std::atomic<std::uint32_t> total{0};
+    const auto make = [&](std::vector<std::uint32_t>& out) {
+        return [&](const std::uint8_t* d, std::size_t n) {
+            WXZ_CHECK(inside.fetch_add(1) == 0);
+            out.push_back(read_u32(d, n));
+            inside.fetch_sub(1);
+            total.fetch_add(1);
+        };
+    };
+    auto sub_a = ch.subscribe_scoped_on(strand, make(a));
+    auto sub_b = ch.subscribe_scoped_on(strand, make(b));
+    for (std::uint32_t i = 0; i < kMessages; ++i) WXZ_CHECK(publish_u32(ch, i));
+    WXZ_CHECK(wait_for([&] { return total.load() == 2 * kMessages; }));
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < kMessages; ++i) expected.push_back(i);
+    WXZ_CHECK(a == expected);
+    WXZ_CHECK(b == expected);
+    sub_a.reset();
+    sub_b.reset();
+    ch.stop();
+    ex.stop();
+}
+
+void backlog_handed_to_first_queue() {
+    ChannelQoS q;
+    q.history = 0;
+    Executor ex(spin_options());
+    WXZ_CHECK(ex.start());
+    InprocChannel ch(4, kBufferBytes, q);
+    for (std::uint32_t i = 0; i < 4; ++i) WXZ_CHECK(publish_u32(ch, i));
+    Received got;
+    auto sub = ch.subscribe_scoped_on(ex, got.handler());
+    drain(ex);
+    WXZ_CHECK((got.snapshot() == std::vector<std::uint32_t>{0, 1, 2, 3}));
+    // 缓存的 buffer 已随交付归还。
+    for (std::uint32_t i = 4; i < 8; ++i) WXZ_CHECK(publish_u32(ch, i));
+    drain(ex);
+    WXZ_CHECK(got.size() == 8);
+    ex.stop();
+}
+
+void parked_dispatcher_is_woken() {
+    InprocChannel::Options opts;
+    opts.spin_iterations = 0; // 每条消息都经过 park/wake
+    ChannelQoS q;
+    q.history = 0;
+    InprocChannel ch(16, kBufferBytes, q, opts);
+    Received got;
+    ch.subscribe(got.handler());
+    for (std::uint32_t i = 0; i < 200; ++i) {
+        // 偶尔留出足够时间让分发线程 park；其余时候与 park 过程竞争。
+        if (i % 20 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        WXZ_CHECK(publish_u32(ch, i));
+        WXZ_CHECK(wait_for([&] { return got.size() == i + 1; }, std::chrono::seconds(2)));
+    }
+    // 无 deadline 时分发线程无超时 park：stop() 必须能把它叫醒。
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ch.stop();
+}
+
+} // namespace
+
+int main() {
+    keep_last_queued();
+    keep_last_dispatch_thread();
+    lifespan_expiry();
+    time_based_filter_per_subscriber();
+    deadline_missed_when_publisher_stops();
+    slow_subscriber_does_not_block_others();
+    strand_subscriptions_are_serial();
+    backlog_handed_to_first_queue();
+    parked_dispatcher_is_woken();
+    return 0;
+}
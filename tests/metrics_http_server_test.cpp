@@ -0,0 +1,202 @@
+// MetricsHttpServer 连接回收：
+// - 发出请求后一直不读响应的抓取端在 write_timeout 后被关闭，不会永久占住 max_connections；
+// - 名额释放后新的抓取能正常完成。
+// 请求大小上限：
+// - 请求头超限返回 431、body 超限（或分块 body）返回 413，随后关闭连接；
+// - 上限内的 body 被跳过，pipelining 的后续请求照常处理；
+// - 等待渲染期间持续灌入的输入不会无限缓冲，渲染完成后先应答已解析的请求再拒绝。
+
+#include "metrics_http_server.h"
+#include "test_util.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <netinet/in.h>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+
+using wxz::core::MetricsHttpServer;
+
+namespace {
+
+constexpr const char kRequest[] = "GET /metrics HTTP/1.1\r\nHost: test\r\n\r\n";
+
+int connect_to(int port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    WXZ_CHECK(fd >= 0);
+    // 小接收缓冲：不读时服务端很快写满窗口。
+    int rcvbuf = 4096;
+    (void)::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    timeval tv{5, 0};
+    (void)::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<std::uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < 100; ++i) {
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    WXZ_CHECK(false);
+    return -1;
+}
+
+// 读到连接关闭为止；返回读到的字节数，超时（连接仍然打开）返回 -1。
+long read_until_closed(int fd) {
+    long total = 0;
+    char buf[65536];
+    for (;;) {
+        const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            total += n;
+            continue;
+        }
+        if (n == 0 || errno == ECONNRESET) return total;
+        if (errno == EINTR) continue;
+        return -1;
+    }
+}
+
+void stalled_scraper_is_closed() {
+    const int port = 20000 + static_cast<int>(::getpid() % 20000);
+    const std::string body(8 << 20, 'x'); // 远大于 socket 缓冲：不读的客户端必然让服务端停在 EAGAIN
+    MetricsHttpServer::Options opts;
+    opts.bind_addr = "127.0.0.1";
+    opts.port = port;
+    opts.max_connections = 2;
+    opts.write_timeout = std::chrono::milliseconds(300);
+    opts.gzip = false;
+    MetricsHttpServer server(opts, [&] { return body; });
+    WXZ_CHECK(server.start());
+
+    // 占满全部名额且都不读。
+    int stalled[2];
+    for (int& fd : stalled) {
+        fd = connect_to(port);
+        WXZ_CHECK(::send(fd, kRequest, sizeof(kRequest) - 1, MSG_NOSIGNAL) > 0);
+    }
+    // write_timeout + 一次清扫周期（1 s）之后，服务端应已关闭两条停滞连接。
+    std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+    for (const int fd : stalled) {
+        const long got = read_until_closed(fd);
+        WXZ_CHECK(got >= 0);                                // 连接已被服务端关闭
+        WXZ_CHECK(got < static_cast<long>(body.size()));    // 响应没有发完
+        ::close(fd);
+    }
+
+    // 名额已释放：正常抓取可以完整读到响应。
+    const int fd = connect_to(port);
+    WXZ_CHECK(::send(fd, kRequest, sizeof(kRequest) - 1, MSG_NOSIGNAL) > 0);
+    std::string resp;
+    char buf[65536];
+    while (resp.find("\r\n\r\n") == std::string::npos ||
+           resp.size() < resp.find("\r\n\r\n") + 4 + body.size()) {
+        const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        WXZ_CHECK(n > 0);
+        resp.append(buf, static_cast<std::size_t>(n));
+    }
+    WXZ_CHECK(resp.rfind("HTTP/1.1 200 OK", 0) == 0);
+    ::close(fd);
+    server.stop();
+}
+
+// 发送整段请求（对端提前关闭时忽略错误），然后读到连接关闭，返回收到的全部响应。
+std::string exchange(int port, const std::string& request) {
+    const int fd = connect_to(port);
+    std::thread writer([&] {
+        std::size_t off = 0;
+        while (off < request.size()) {
+            const ssize_t n = ::send(fd, request.data() + off, request.size() - off, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            off += static_cast<std::size_t>(n);
+        }
+    });
+    std::string resp;
+    char buf[65536];
+    for (;;) {
+        const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            resp.append(buf, static_cast<std::size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        WXZ_CHECK(n == 0 || errno == ECONNRESET); // 超时说明服务端没有关闭连接
+        break;
+    }
+    writer.join();
+    ::close(fd);
+    return resp;
+}
+
+std::size_t count(const std::string& text, std::string_view needle) {
+    std::size_t n = 0;
+    for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++n;
+    return n;
+}
+
+void oversized_requests_are_rejected() {
+    const int port = 20000 + static_cast<int>((::getpid() + 1) % 20000);
+    MetricsHttpServer::Options opts;
+    opts.bind_addr = "127.0.0.1";
+    opts.port = port;
+    opts.gzip = false;
+    MetricsHttpServer server(opts, [] { return std::string("m 1\n"); });
+    WXZ_CHECK(server.start());
+
+    // 头部没有结束且超过 16 KiB。
+    const std::string huge_header = "GET /metrics HTTP/1.1\r\nX-Fill: " + std::string(64 * 1024, 'a');
+    std::string resp = exchange(port, huge_header);
+    WXZ_CHECK(resp.rfind("HTTP/1.1 431 ", 0) == 0);
+
+    // 声明的 body 超过上限：不等 body 到达就拒绝。
+    resp = exchange(port, "GET /metrics HTTP/1.1\r\nContent-Length: 1000000\r\n\r\n");
+    WXZ_CHECK(resp.rfind("HTTP/1.1 413 ", 0) == 0);
+    resp = exchange(port, "GET /metrics HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n0\r\n\r\n");
+    WXZ_CHECK(resp.rfind("HTTP/1.1 413 ", 0) == 0);
+    resp = exchange(port, "GET /metrics HTTP/1.1\r\nContent-Length: -1\r\n\r\n");
+    WXZ_CHECK(resp.rfind("HTTP/1.1 413 ", 0) == 0);
+
+    // 上限内的 body 被跳过，不会被当成下一个请求解析。
+    resp = exchange(port,
+                    "GET /metrics HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"
+                    "GET /metrics HTTP/1.1\r\nConnection: close\r\n\r\n");
+    WXZ_CHECK(count(resp, "HTTP/1.1 200 OK") == 2);
+    WXZ_CHECK(count(resp, "HTTP/1.1 404") == 0);
+    server.stop();
+}
+
+void flood_while_rendering_is_bounded() {
+    const int port = 20000 + static_cast<int>((::getpid() + 2) % 20000);
+    MetricsHttpServer::Options opts;
+    opts.bind_addr = "127.0.0.1";
+    opts.port = port;
+    opts.gzip = false;
+    opts.cache_ttl = std::chrono::milliseconds(0);
+    MetricsHttpServer server(opts, [] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        return std::string("m 1\n");
+    });
+    WXZ_CHECK(server.start());
+
+    // 第一个请求等待渲染期间，后面紧跟 4 MiB 没有头部结束符的垃圾数据。
+    const std::string resp = exchange(port, std::string(kRequest) + std::string(4 << 20, 'z'));
+    const auto ok = resp.find("HTTP/1.1 200 OK");
+    const auto rejected = resp.find("HTTP/1.1 431 ");
+    WXZ_CHECK(ok == 0);
+    WXZ_CHECK(rejected != std::string::npos && rejected > ok);
+    server.stop();
+}
+
+} // namespace
+
+int main() {
+    stalled_scraper_is_closed();
+    oversized_requests_are_rejected();
+    flood_while_rendering_is_bounded();
+    return 0;
+}
@@ -0,0 +1,204 @@
+// ShmChannel 多写端压测：
+// - queue：4 个写端（一半走 reserve/publish）并发写入，校验每条消息恰好交付一次且内容完好；
+// - broadcast：同样的写入模式，校验交付的消息内容完好（被覆盖的只计 lapped，不交付残缺内容）；
+// - 残留字节：上一圈 payload 在下一圈记录头位置上恰好等于 2*pos+1 时，读端不能把尚未提交的记录当成已提交。
+
+#include "shm_channel.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using wxz::core::ShmChannel;
+
+namespace {
+
+constexpr std::size_t kRing = 16 * 1024;
+constexpr std::size_t kProducers = 4;
+constexpr std::uint32_t kPerProducer = 20000;
+constexpr std::size_t kMaxPayload = 600;
+
+std::string shm_name(const char* tag) { return "/wxz_test_shm_" + std::string(tag) + "_" + std::to_string(::getpid()); }
+
+// payload：[u32 producer][u32 seq][seq & 0xff 填充 ...]
+std::size_t payload_size(std::uint32_t seq) { return 8 + (seq * 37u) % (kMaxPayload - 8); }
+
+void fill(std::uint8_t* d, std::uint32_t producer, std::uint32_t seq, std::size_t n) {
+    std::memcpy(d, &producer, 4);
+    std::memcpy(d + 4, &seq, 4);
+    std::memset(d + 8, static_cast<int>(seq & 0xff), n - 8);
+}
+
+bool intact(const std::uint8_t* d, std::size_t n, std::uint32_t& producer, std::uint32_t& seq) {
+    if (n < 8) return false;
+    std::memcpy(&producer, d, 4);
+    std::memcpy(&seq, d + 4, 4);
+    if (producer >= kProducers || seq >= kPerProducer || n != payload_size(seq)) return false;
+    for (std::size_t i = 8; i < n; ++i) {
+        if (d[i] != static_cast<std::uint8_t>(seq)) return false;
+    }
+    return true;
+}
+
+void wait_until(const std::function<bool()>& done) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// 奇数号写端走 reserve/publish，偶数号走拷贝 publish。
+// queue：写满时重试，每条都必须发布成功；broadcast：预留从不失败，但持有预留期间被其他写端整圈覆盖时
+// 发布失败（计入 wxz.shm.publish.lapped），不重试。
+void produce(ShmChannel& w, std::uint32_t producer, bool queue) {
+    std::vector<std::uint8_t> buf(kMaxPayload);
+    for (std::uint32_t seq = 0; seq < kPerProducer; ++seq) {
+        const std::size_t n = payload_size(seq);
+        if (producer % 2 == 1) {
+            for (;;) {
+                auto r = w.reserve(n);
+                if (r.valid()) {
+                    fill(r.data(), producer, seq, n);
+                    r.commit(n);
+                    const bool ok = w.publish(std::move(r));
+                    WXZ_CHECK(ok || !queue);
+                    break;
+                }
+                WXZ_CHECK(queue);
+                std::this_thread::yield();
+            }
+        } else {
+            fill(buf.data(), producer, seq, n);
+            if (!queue) {
+                (void)w.publish(buf.data(), n);
+                continue;
+            }
+            while (!w.publish(buf.data(), n)) std::this_thread::yield();
+        }
+    }
+}
+
+void queue_multi_producer_exactly_once() {
+    ShmChannel::Options o;
+    o.mode = ShmChannel::Mode::queue;
+    o.multi_producer = true;
+    o.ring_bytes = kRing;
+    const std::string name = shm_name("queue_mp");
+    ShmChannel w(name, 0, 0, true, o);
+    ShmChannel r(name, 0, 0, false, o);
+
+    std::unique_ptr<std::atomic<std::uint8_t>[]> seen(new std::atomic<std::uint8_t>[kProducers * kPerProducer]);
+    for (std::size_t i = 0; i < kProducers * kPerProducer; ++i) seen[i].store(0);
+    std::atomic<std::uint64_t> got{0};
+    r.subscribe([&](const std::uint8_t* d, std::size_t n) {
+        std::uint32_t producer = 0;
+        std::uint32_t seq = 0;
+        WXZ_CHECK(intact(d, n, producer, seq));
+        WXZ_CHECK(seen[producer * kPerProducer + seq].fetch_add(1) == 0);
+        got.fetch_add(1);
+    });
+
+    std::vector<std::thread> threads;
+    for (std::uint32_t p = 0; p < kProducers; ++p) threads.emplace_back([&, p]() { produce(w, p, true); });
+    for (auto& t : threads) t.join();
+
+    const std::uint64_t total = kProducers * kPerProducer;
+    wait_until([&]() { return got.load() == total; });
+    WXZ_CHECK(got.load() == total);
+    WXZ_CHECK(w.publish_success() == total);
+    r.stop();
+}
+
+void broadcast_multi_producer_intact() {
+    ShmChannel::Options o;
+    o.mode = ShmChannel::Mode::broadcast;
+    o.multi_producer = true;
+    o.ring_bytes = kRing;
+    const std::string name = shm_name("bcast_mp");
+    ShmChannel w(name, 0, 0, true, o);
+    ShmChannel r(name, 0, 0, false, o);
+
+    std::atomic<std::uint64_t> got{0};
+    r.subscribe([&](const std::uint8_t* d, std::size_t n) {
+        std::uint32_t producer = 0;
+        std::uint32_t seq = 0;
+        WXZ_CHECK(intact(d, n, producer, seq));
+        got.fetch_add(1);
+    });
+
+    std::vector<std::thread> threads;
+    for (std::uint32_t p = 0; p < kProducers; ++p) threads.emplace_back([&, p]() { produce(w, p, false); });
+    for (auto& t : threads) t.join();
+
+    // 最后一条发布后写端不再前进，读端最终追上 head：交付数 + 被覆盖数覆盖全部成功发布的消息之外不会多交付。
+    wait_until([&]() { return r.slowest_reader_lag() == 0; });
+    WXZ_CHECK(got.load() > 0);
+    WXZ_CHECK(got.load() <= w.publish_success());
+    r.stop();
+}
+
+// 单写端（multi_producer 布局）按已知的记录大小序列推算每条记录的绝对位置，把 payload 中落在
+// 64 字节边界（即下一圈可能的记录头位置）上的 8 字节写成 2*(该位置 + ring)+1：下一圈在这里预留的记录
+// 在提交前，其 seq 字必须已被置为未提交，否则读端会按残留的 len/bytes 交付垃圾或越界跳读。
+void stale_payload_not_mistaken_for_commit() {
+    ShmChannel::Options o;
+    o.mode = ShmChannel::Mode::queue;
+    o.multi_producer = true;
+    o.ring_bytes = kRing;
+    const std::string name = shm_name("stale");
+    ShmChannel w(name, 0, 0, true, o);
+    ShmChannel r(name, 0, 0, false, o);
+
+    constexpr std::uint32_t kMessages = 50000;
+    constexpr std::size_t kHeader = 16;
+    constexpr std::size_t kAlign = 64;
+    const auto size_of = [](std::uint32_t seq) -> std::size_t { return 8 + (seq * 97u) % 900; };
+
+    std::atomic<std::uint32_t> next{0};
+    r.subscribe([&](const std::uint8_t* d, std::size_t n) {
+        std::uint32_t seq = 0;
+        WXZ_CHECK(n >= 8);
+        std::memcpy(&seq, d + 4, 4);
+        WXZ_CHECK(seq == next.load(std::memory_order_relaxed));
+        WXZ_CHECK(n == size_of(seq));
+        next.store(seq + 1, std::memory_order_relaxed);
+    });
+
+    std::vector<std::uint8_t> buf(1024);
+    std::uint64_t pos = 0;
+    for (std::uint32_t seq = 0; seq < kMessages; ++seq) {
+        const std::size_t n = size_of(seq);
+        const std::uint64_t rec = (kHeader + n + kAlign - 1) / kAlign * kAlign;
+        const std::uint64_t idx = pos % kRing;
+        const std::uint64_t pad = idx + rec > kRing ? kRing - idx : 0;
+        const std::uint64_t payload_at = pos + pad + kHeader;
+        std::memset(buf.data(), 0, n);
+        std::memcpy(buf.data() + 4, &seq, 4);
+        for (std::uint64_t a = (payload_at + kAlign - 1) / kAlign * kAlign; a + 8 <= payload_at + n; a += kAlign) {
+            const std::uint64_t poison = 2 * (a + kRing) + 1;
+            std::memcpy(buf.data() + (a - payload_at), &poison, 8);
+        }
+        while (!w.publish(buf.data(), n)) std::this_thread::yield();
+        pos += pad + rec;
+    }
+
+    wait_until([&]() { return next.load() == kMessages; });
+    WXZ_CHECK(next.load() == kMessages);
+    r.stop();
+}
+
+} // namespace
+
+int main() {
+    queue_multi_producer_exactly_once();
+    broadcast_multi_producer_intact();
+    stale_payload_not_mistaken_for_commit();
+    return 0;
+}
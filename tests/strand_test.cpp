@@ -0,0 +1,186 @@
+// Strand：
+// - 多个生产者并发 post 时，每个生产者的任务按投递顺序执行，且同一时刻至多一个任务在执行（不重入）；
+// - 任务内向同一 strand post 的任务不会就地执行，而是排在当前任务之后；
+// - 单次 drain 最多执行 quantum 个任务，之后重投到执行器尾部，让出给其它任务；
+// - 节点池：排队任务不超过 node_cache 时 post 不分配内存，池取空时退回堆分配。
+
+#include "executor.h"
+#include "strand.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+// 仅统计打开计数的线程上的分配。
+thread_local bool g_counting = false;
+thread_local std::size_t g_allocs = 0;
+} // namespace
+
+void* operator new(std::size_t n) {
+    if (g_counting) ++g_allocs;
+    if (void* p = std::malloc(n == 0 ? 1 : n)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using wxz::core::Executor;
+using wxz::core::Strand;
+
+namespace {
+
+void drain(Executor& ex) {
+    while (ex.spin_once(std::chrono::milliseconds(0))) {
+    }
+}
+
+void ordered_and_not_reentrant(Executor::Backend backend) {
+    Executor::Options o;
+    o.threads = 4;
+    o.backend = backend;
+    o.max_queue = 0;
+    Executor ex(o);
+    WXZ_CHECK(ex.start());
+    Strand::Options so;
+    so.quantum = 8;
+    so.node_cache = 16; // 小于在途任务数：池节点与堆节点混用
+    Strand strand(ex, so);
+
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+    std::vector<int> last(kProducers, -1);
+    std::atomic<int> inside{0};
+    std::atomic<int> done{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                WXZ_CHECK(strand.post([&, p, i] {
+                    WXZ_CHECK(inside.fetch_add(1) == 0);
+                    // strand 串行：不加锁读写 last 也没有数据竞争。
+                    WXZ_CHECK(last[p] == i - 1);
+                    last[p] = i;
+                    inside.fetch_sub(1);
+                    done.fetch_add(1);
+                }));
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (done.load() < kProducers * kPerProducer && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    WXZ_CHECK(done.load() == kProducers * kPerProducer);
+    ex.stop();
+}
+
+void nested_post_runs_after_current() {
+    Executor::Options o;
+    o.threads = 0;
+    Executor ex(o);
+    WXZ_CHECK(ex.start());
+    Strand strand(ex);
+    std::vector<std::string> order;
+    WXZ_CHECK(strand.post([&] {
+        order.push_back("outer_begin");
+        WXZ_CHECK(strand.post([&] { order.push_back("nested"); }));
+        order.push_back("outer_end");
+    }));
+    WXZ_CHECK(strand.post([&] { order.push_back("next"); }));
+    drain(ex);
+    const std::vector<std::string> expected{"outer_begin", "outer_end", "next", "nested"};
+    WXZ_CHECK(order == expected);
+    ex.stop();
+}
+
+void quantum_yields_to_executor(Executor::Backend backend) {
+    Executor::Options o;
+    o.threads = 0; // spin 线程从全局队列按 FIFO 取，顺序确定
+    o.backend = backend;
+    Executor ex(o);
+    WXZ_CHECK(ex.start());
+    Strand::Options so;
+    so.quantum = 4;
+    Strand strand(ex, so);
+    std::vector<std::string> order;
+    for (int i = 0; i < 10; ++i) {
+        WXZ_CHECK(strand.post([&, i] { order.push_back("s" + std::to_string(i)); }));
+    }
+    WXZ_CHECK(ex.post([&] { order.push_back("x"); }));
+    drain(ex);
+    const std::vector<std::string> expected{"s0", "s1", "s2", "s3", "x", "s4", "s5", "s6", "s7", "s8", "s9"};
+    WXZ_CHECK(order == expected);
+    ex.stop();
+}
+
+// 只统计 drain 已调度之后的 post（此时 post 只入队，不再向执行器投递 drain）。
+std::size_t allocs_for_posts(Strand& strand, int n, int& ran) {
+    g_allocs = 0;
+    g_counting = true;
+    for (int i = 0; i < n; ++i) WXZ_CHECK(strand.post([&ran] { ++ran; }));
+    g_counting = false;
+    return g_allocs;
+}
+
+void steady_state_post_does_not_allocate() {
+    Executor::Options o;
+    o.threads = 0;
+    Executor ex(o);
+    WXZ_CHECK(ex.start());
+    Strand::Options so;
+    so.node_cache = 32;
+    Strand strand(ex, so);
+    int ran = 0;
+    for (int round = 0; round < 3; ++round) {
+        WXZ_CHECK(strand.post([&ran] { ++ran; })); // 调度 drain
+        WXZ_CHECK(allocs_for_posts(strand, 31, ran) == 0);
+        // 超出节点池：退回堆分配，不丢任务。
+        WXZ_CHECK(allocs_for_posts(strand, 4, ran) == 4);
+        drain(ex);
+        WXZ_CHECK(ran == (round + 1) * 36);
+    }
+
+    so.node_cache = 0;
+    Strand uncached(ex, so);
+    WXZ_CHECK(uncached.post([&ran] { ++ran; }));
+    WXZ_CHECK(allocs_for_posts(uncached, 8, ran) == 8);
+    drain(ex);
+    ex.stop();
+}
+
+void stop_discards_pending() {
+    Executor::Options o;
+    o.threads = 0;
+    Executor ex(o);
+    WXZ_CHECK(ex.start());
+    Strand::Options so;
+    so.node_cache = 4;
+    Strand strand(ex, so);
+    int ran = 0;
+    for (int i = 0; i < 10; ++i) WXZ_CHECK(strand.post([&ran] { ++ran; }));
+    strand.stop();
+    WXZ_CHECK(!strand.post([&ran] { ++ran; }));
+    drain(ex);
+    WXZ_CHECK(ran == 0);
+    ex.stop();
+}
+
+} // namespace
+
+int main() {
+    for (const auto backend : {Executor::Backend::mutex_queue, Executor::Backend::work_stealing}) {
+        ordered_and_not_reentrant(backend);
+        quantum_yields_to_executor(backend);
+    }
+    nested_post_runs_after_current();
+    steady_state_post_does_not_allocate();
+    stop_discards_pending();
+    return 0;
+}
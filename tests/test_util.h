@@ -0,0 +1,15 @@
+#pragma once
+
+// 最小测试工具：不依赖第三方框架。检查失败时打印位置并以非零退出码立即结束（可在任意线程调用），由 ctest 判定。
+
+#include <cstdio>
+#include <cstdlib>
+
+#define WXZ_CHECK(cond)                                                                  \
+    do {                                                                                 \
+        if (!(cond)) {                                                                   \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::fflush(stderr);                                                         \
+            std::_Exit(1);                                                               \
+        }                                                                                \
+    } while (0)
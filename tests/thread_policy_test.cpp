@@ -0,0 +1,57 @@
+// 线程放置：cpulist 解析的边界，以及同名线程各自上报一条 wxz.thread.placement（tid 标签区分）。
+
+#include "internal/thread_policy.h"
+#include "metrics_prometheus.h"
+#include "test_util.h"
+
+#include <sched.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using wxz::core::internal::parse_cpu_list;
+
+namespace {
+
+void parse_cpu_list_bounds() {
+    WXZ_CHECK((parse_cpu_list("0-3,8, 10-11") == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    WXZ_CHECK(parse_cpu_list("").empty());
+    WXZ_CHECK((parse_cpu_list("x,2,-1,3-y") == std::vector<int>{2}));
+
+    const std::string last = std::to_string(CPU_SETSIZE - 1);
+    const std::string over = std::to_string(CPU_SETSIZE);
+    WXZ_CHECK((parse_cpu_list(last) == std::vector<int>{CPU_SETSIZE - 1}));
+    WXZ_CHECK((parse_cpu_list("1," + over) == std::vector<int>{1}));
+    // 上界越界的区间整段拒绝，不会展开出 CPU_SETSIZE 之外的编号（也不会为巨大区间分配内存）。
+    WXZ_CHECK((parse_cpu_list("0-" + over + ",4") == std::vector<int>{4}));
+    WXZ_CHECK(parse_cpu_list("0-2000000000").empty());
+    WXZ_CHECK(parse_cpu_list("99999999999").empty()); // stoi 溢出
+}
+
+std::size_t count(const std::string& text, const std::string& needle) {
+    std::size_t n = 0;
+    for (auto pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++n;
+    return n;
+}
+
+void placement_series_per_thread() {
+    wxz::core::PrometheusMetricsSink sink;
+    wxz::core::set_metrics_sink(&sink);
+    // 同一 pool、同一 index：线程名相同，只有 tid 不同。
+    for (int i = 0; i < 2; ++i) {
+        std::thread([]() { wxz::core::internal::apply_thread_policy("placement_test", wxz::core::internal::ThreadPolicy{}, 0); })
+            .join();
+    }
+    wxz::core::set_metrics_sink(nullptr);
+    const std::string text = sink.render();
+    WXZ_CHECK(count(text, "wxz_thread_placement{") == 2);
+    WXZ_CHECK(count(text, "tid=\"") == 2);
+}
+
+} // namespace
+
+int main() {
+    parse_cpu_list_bounds();
+    placement_series_per_thread();
+    return 0;
+}
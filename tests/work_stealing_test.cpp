@@ -0,0 +1,130 @@
+// 工作窃取队列：
+// - ChaseLevDeque：owner 在 bottom 端 LIFO 存取、窃取者从 top 端 FIFO 取；owner pop 与多个窃取者并发时
+//   每个元素恰好被取走一次（包括只剩最后一个元素时的竞争）。
+// - MpmcPtrQueue：多生产者多消费者并发时每个元素恰好出队一次，满/空时立即返回。
+
+#include "internal/work_stealing.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using wxz::core::internal::ChaseLevDeque;
+using wxz::core::internal::MpmcPtrQueue;
+
+namespace {
+
+void deque_ends() {
+    int v[4] = {0, 1, 2, 3};
+    ChaseLevDeque<int> d(4);
+    for (int& x : v) WXZ_CHECK(d.push(&x));
+    int extra = 4;
+    WXZ_CHECK(!d.push(&extra)); // 满
+    WXZ_CHECK(d.pop() == &v[3]);
+    WXZ_CHECK(d.steal() == &v[0]);
+    WXZ_CHECK(d.pop() == &v[2]);
+    WXZ_CHECK(d.pop() == &v[1]);
+    WXZ_CHECK(d.pop() == nullptr);
+    WXZ_CHECK(d.steal() == nullptr);
+    WXZ_CHECK(d.empty_approx());
+    // 取空后继续使用：下标已绕过容量。
+    for (int i = 0; i < 10; ++i) {
+        WXZ_CHECK(d.push(&v[i % 4]));
+        WXZ_CHECK(d.pop() == &v[i % 4]);
+    }
+}
+
+void deque_owner_pop_races_stealers() {
+    constexpr std::size_t kItems = 200000;
+    constexpr std::size_t kStealers = 3;
+    std::vector<int> items(kItems);
+    std::unique_ptr<std::atomic<std::uint8_t>[]> taken(new std::atomic<std::uint8_t>[kItems]);
+    for (std::size_t i = 0; i < kItems; ++i) taken[i].store(0);
+    const auto take = [&](int* p) { WXZ_CHECK(taken[static_cast<std::size_t>(p - items.data())].fetch_add(1) == 0); };
+
+    ChaseLevDeque<int> d(64);
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> total{0};
+    std::vector<std::thread> stealers;
+    for (std::size_t s = 0; s < kStealers; ++s) {
+        stealers.emplace_back([&] {
+            for (;;) {
+                if (int* p = d.steal()) {
+                    take(p);
+                    total.fetch_add(1);
+                } else if (done.load()) {
+                    return;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    // owner：交替 push 与 pop，队列经常只剩 0~1 个元素，反复触发最后一个元素的竞争。
+    std::size_t next = 0;
+    while (next < kItems) {
+        const std::size_t burst = 1 + next % 3;
+        for (std::size_t i = 0; i < burst && next < kItems; ++i) {
+            if (!d.push(&items[next])) break;
+            ++next;
+        }
+        if (int* p = d.pop()) {
+            take(p);
+            total.fetch_add(1);
+        }
+    }
+    while (int* p = d.pop()) {
+        take(p);
+        total.fetch_add(1);
+    }
+    done.store(true);
+    for (auto& t : stealers) t.join();
+    WXZ_CHECK(total.load() == kItems);
+}
+
+void mpmc_exactly_once() {
+    constexpr std::size_t kProducers = 3;
+    constexpr std::size_t kConsumers = 3;
+    constexpr std::size_t kPerProducer = 50000;
+    constexpr std::size_t kItems = kProducers * kPerProducer;
+    std::vector<int> items(kItems);
+    std::unique_ptr<std::atomic<std::uint8_t>[]> taken(new std::atomic<std::uint8_t>[kItems]);
+    for (std::size_t i = 0; i < kItems; ++i) taken[i].store(0);
+
+    MpmcPtrQueue<int> q(16);
+    std::atomic<std::size_t> total{0};
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&, p] {
+            for (std::size_t i = 0; i < kPerProducer; ++i) {
+                while (!q.push(&items[p * kPerProducer + i])) std::this_thread::yield();
+            }
+        });
+    }
+    for (std::size_t c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&] {
+            while (total.load() < kItems) {
+                if (int* x = q.pop()) {
+                    WXZ_CHECK(taken[static_cast<std::size_t>(x - items.data())].fetch_add(1) == 0);
+                    total.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    WXZ_CHECK(total.load() == kItems);
+    WXZ_CHECK(q.pop() == nullptr);
+}
+
+} // namespace
+
+int main() {
+    deque_ends();
+    deque_owner_pop_races_stealers();
+    mpmc_exactly_once();
+    return 0;
+}